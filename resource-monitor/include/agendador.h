@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+uint64_t instanteMonotonicoNs(); // CLOCK_MONOTONIC em ns (mesmo relógio do steady_clock no Linux)
+
+// Classe AgendadorAmostras: marca o ritmo do laço de amostragem com um timerfd em prazos absolutos.
+// Dormir 'intervalo' depois de coletar e imprimir faz o período real ser intervalo + coleta + saída;
+// aqui o timer dispara em inicio + k * período (CLOCK_MONOTONIC), então o atraso de uma volta não se acumula.
+// Prazos que passaram sem a amostra (ex.: laço bloqueado) são contados e pulados, sem rajadas para alcançar.
+class AgendadorAmostras {
+public:
+    // Histograma de jitter (atraso do despertar em relação ao prazo) em faixas de potência de 2 em µs:
+    // faixa 0 = < 1 µs, faixa i = [2^(i-1), 2^i) µs; a última acumula tudo acima de ~4 s
+    static constexpr size_t FAIXAS_JITTER = 24;
+
+    // Limites do período: abaixo de 1 ms o laço vira espera ocupada; acima de 1 dia não há uso prático
+    static constexpr uint64_t PERIODO_MINIMO_NS = 1000000ULL;
+    static constexpr uint64_t PERIODO_MAXIMO_NS = 86400ULL * 1000000000ULL;
+
+    // Intervalos fora dos limites (inclusive <= 0, NaN e infinito) são ajustados ao limite mais próximo, com aviso
+    explicit AgendadorAmostras(double intervaloSegundos);
+    ~AgendadorAmostras();
+
+    // O agendador é dono do timerfd, então não pode ser copiado
+    AgendadorAmostras(const AgendadorAmostras&) = delete;
+    AgendadorAmostras& operator=(const AgendadorAmostras&) = delete;
+
+    bool valido() const { return fd >= 0; }
+
+    // (Re)inicia a grade de prazos a partir de agora; o primeiro disparo é daqui a um período.
+    // Usado também depois de pausas pedidas pelo usuário, para não contá-las como prazos perdidos
+    void reiniciar();
+
+    // Bloqueia até o próximo prazo e devolve o instante real do despertar (ns, CLOCK_MONOTONIC)
+    uint64_t esperar();
+
+    // Próximo prazo, para quem precisa esperar outros eventos (poll) até ele
+    std::chrono::steady_clock::time_point proximoPrazo() const;
+
+    uint64_t periodoNs() const { return periodo; }
+    uint64_t prazosPerdidos() const { return perdidos; }
+    uint64_t despertares() const { return amostras; }
+    uint64_t jitterMaximoNs() const { return jitterMax; }
+    double jitterMedioUs() const { return amostras ? static_cast<double>(jitterSoma) / 1e3 / static_cast<double>(amostras) : 0.0; }
+    const std::array<uint64_t, FAIXAS_JITTER>& histogramaJitter() const { return histograma; }
+
+    void imprimirResumo() const; // tabela com prazos perdidos e o histograma de jitter
+
+private:
+    int fd = -1;
+    uint64_t periodo = 0;      // ns
+    uint64_t inicio = 0;       // instante de referência da grade (ns)
+    uint64_t expiracoes = 0;   // prazos vencidos desde reiniciar(): o último foi inicio + expiracoes * periodo
+    uint64_t perdidos = 0;
+    uint64_t amostras = 0;
+    uint64_t jitterSoma = 0;
+    uint64_t jitterMax = 0;
+    std::array<uint64_t, FAIXAS_JITTER> histograma{};
+};
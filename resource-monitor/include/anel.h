@@ -0,0 +1,159 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+
+// ---- Anel de amostras recentes em arquivo mapeado (mmap MAP_SHARED) ----
+// Layout do arquivo (docs/recentes.anel):
+//   CabecalhoAnel | SlotAnel x maxProcessos | RegistroAnel x (maxProcessos * registrosPorProcesso)
+// Cada PID monitorado ocupa um slot com as suas últimas 'registrosPorProcesso' amostras em anel.
+// As páginas são do page cache: se o monitor morrer (crash, OOM kill), o que já foi escrito continua no
+// arquivo sem nenhum fsync no caminho quente. Outros processos leem o mesmo mapeamento sem syscalls.
+
+// Cabeçalho do arquivo (fixo depois da criação)
+struct alignas(64) CabecalhoAnel {
+    uint32_t magica;               // "RMRG"
+    uint16_t versao;
+    uint16_t tamanhoRegistro;      // sizeof(RegistroAnel), conferido pelo leitor
+    uint32_t maxProcessos;
+    uint32_t registrosPorProcesso;
+    int64_t criadoMs;              // CLOCK_REALTIME da criação do arquivo
+};
+
+// Estado de um PID. 'sequencia' é um seqlock: ímpar enquanto o escritor mexe no slot ou nos registros dele;
+// o leitor copia o que precisa e só aceita a cópia se a sequência for a mesma (e par) antes e depois.
+struct alignas(64) SlotAnel {
+    std::atomic<uint32_t> sequencia;
+    int32_t pid;                   // 0 = slot nunca usado
+    uint64_t starttime;            // identidade do processo (PID reutilizado ganha outro slot)
+    std::atomic<uint64_t> escritos; // amostras já gravadas; a próxima vai para escritos % registrosPorProcesso
+    int64_t atualizadoMs;          // instante da última amostra (CLOCK_REALTIME)
+};
+
+// Uma amostra com tamanho fixo (campos de StatusProcesso e calculoMedicao com largura definida)
+struct RegistroAnel {
+    uint64_t numero;               // índice da amostra no slot; NUMERO_INVALIDO enquanto o registro é escrito
+    int64_t instanteMs;            // CLOCK_REALTIME
+    int32_t pid;
+    uint32_t threads;
+    uint32_t contextSwitchfree;
+    uint32_t contextSwitchforced;
+    uint32_t conexoesAtivas;
+    uint32_t reservado;
+    double utime, stime, tempoCPU, esperaCPU;
+    uint64_t vmSize, vmRss, vmSwap, minfault, mjrfault;
+    uint64_t bytesLidos, bytesEscritos, syscallLeitura, syscallEscrita, rchar, wchar;
+    uint64_t bytesRxfila, bytesTxfila;
+    double usoCPU, usoCPUGlobal, taxaLeituraDisco, taxaLeituraTotal, taxaEscritaDisco, taxaEscritaTotal;
+};
+
+// Conversões entre o registro fixo e as estruturas do monitor
+void paraRegistroAnel(const StatusProcesso &medicao, const calculoMedicao &calculado, RegistroAnel &registro);
+void deRegistroAnel(const RegistroAnel &registro, StatusProcesso &medicao, calculoMedicao &calculado);
+
+// Classe AnelAmostras: o escritor do anel. Um único monitor por arquivo (flock exclusivo); se outro já
+// estiver escrevendo, o anel fica desativado nesta instância. Um arquivo de uma execução anterior (mesma
+// geometria) é reaproveitado: as amostras antigas continuam lá até o slot ser reutilizado.
+class AnelAmostras {
+public:
+    AnelAmostras(std::string caminho, uint32_t maxProcessos, uint32_t registrosPorProcesso);
+    ~AnelAmostras();
+
+    // O anel é dono do mapeamento, então não pode ser copiado
+    AnelAmostras(const AnelAmostras&) = delete;
+    AnelAmostras& operator=(const AnelAmostras&) = delete;
+
+    bool valido() const { return mapa != nullptr; }
+    const std::string& arquivo() const { return caminho; }
+
+    // Reserva um slot para o processo: o mesmo PID+starttime de uma execução anterior continua o slot dele;
+    // senão um slot livre ou, sem livres, o atualizado há mais tempo. -1 se todos estão em uso
+    int reservar(int pid, uint64_t starttime);
+    void liberar(int slot); // o slot pode ser reutilizado; as amostras ficam no arquivo
+
+    // Grava uma amostra no slot (só a thread dona do slot chama). Sem syscalls além do clock_gettime (vDSO)
+    void gravar(int slot, const StatusProcesso &medicao, const calculoMedicao &calculado);
+
+    static AnelAmostras& padrao(); // docs/recentes.anel: 1024 processos x 256 amostras, aberto no primeiro uso
+
+private:
+    std::string caminho;
+    int fd = -1;
+    void *mapa = nullptr;
+    size_t tamanhoMapa = 0;
+    CabecalhoAnel *cabecalho = nullptr;
+    SlotAnel *slots = nullptr;
+    RegistroAnel *registros = nullptr;
+
+    std::mutex trava;            // protege 'emUso' e a troca de dono dos slots
+    std::vector<bool> emUso;     // slots reservados nesta execução
+};
+
+// Classe ReservaAnel: um slot reservado no anel, liberado no destrutor. Pode ser movida junto com o alvo
+// (ex.: na tabela do motor); sem anel (construtor padrão) gravar() não faz nada.
+class ReservaAnel {
+public:
+    ReservaAnel() = default;
+    ReservaAnel(AnelAmostras &anel, const ProcessoMonitorado &processo);
+    ~ReservaAnel();
+
+    ReservaAnel(ReservaAnel &&outra) noexcept;
+    ReservaAnel& operator=(ReservaAnel &&outra) noexcept;
+    ReservaAnel(const ReservaAnel&) = delete;
+    ReservaAnel& operator=(const ReservaAnel&) = delete;
+
+    bool valida() const { return slot >= 0; }
+    void gravar(const StatusProcesso &medicao, const calculoMedicao &calculado) {
+        if (slot >= 0) anel->gravar(slot, medicao, calculado);
+    }
+
+private:
+    AnelAmostras *anel = nullptr;
+    int slot = -1;
+};
+
+// Estado de um slot lido pelo LeitorAnel
+struct ResumoSlotAnel {
+    uint32_t slot;
+    int pid;
+    uint64_t starttime;
+    uint64_t escritos;
+    int64_t atualizadoMs;
+};
+
+// Classe LeitorAnel: mapeia o arquivo só para leitura (pode ser outro processo, com o monitor rodando ou
+// depois de ele ter morrido) e copia as amostras de um slot validando o seqlock e o número de cada registro.
+class LeitorAnel {
+public:
+    LeitorAnel() = default;
+    ~LeitorAnel();
+
+    // O leitor é dono do mapeamento, então não pode ser copiado
+    LeitorAnel(const LeitorAnel&) = delete;
+    LeitorAnel& operator=(const LeitorAnel&) = delete;
+
+    bool abrir(const std::string &caminho);
+    void fechar();
+
+    bool escritorAtivo() const; // algum monitor está com o arquivo aberto para escrita (flock)
+    uint32_t maxProcessos() const { return cabecalho ? cabecalho->maxProcessos : 0; }
+    uint32_t registrosPorProcesso() const { return cabecalho ? cabecalho->registrosPorProcesso : 0; }
+
+    std::vector<ResumoSlotAnel> processos() const; // slots já usados, do mais recente para o mais antigo
+
+    // Copia até 'maximo' amostras mais recentes do slot (da mais antiga para a mais nova); false se o
+    // escritor não deixou uma cópia consistente após várias tentativas
+    bool lerUltimos(uint32_t slot, size_t maximo, std::vector<RegistroAnel> &saida, ResumoSlotAnel *resumo = nullptr) const;
+
+private:
+    int fd = -1;
+    const void *mapa = nullptr;
+    size_t tamanhoMapa = 0;
+    const CabecalhoAnel *cabecalho = nullptr;
+    const SlotAnel *slots = nullptr;
+    const RegistroAnel *registros = nullptr;
+};
@@ -3,6 +3,7 @@
 #include <map>
 #include <vector>
 #include <cstdint>
+#include "psi.h"
 
 // Estrutura responsável por armazenar os dados de BlkIO de um processo em um CGroup
 struct BlkIOStats {
@@ -16,6 +17,16 @@ struct BlkIOStats {
 	uint64_t dios;
 };
 
+// Estrutura com os contadores de cpu.stat (cgroup v2) lidos sem alocação
+struct CpuStatCgroup {
+	uint64_t usageUsec;     // tempo total de CPU do cgroup (µs)
+	uint64_t userUsec;      // tempo em modo usuário (µs)
+	uint64_t systemUsec;    // tempo em modo kernel (µs)
+	uint64_t nrPeriods;     // períodos de enforcement decorridos
+	uint64_t nrThrottled;   // períodos em que o cgroup foi limitado
+	uint64_t throttledUsec; // tempo total limitado (µs)
+};
+
 // Classe CGroupManager que possuí todas as funções atribuídas
 class CGroupManager {
 public:
@@ -30,6 +41,8 @@ public:
     std::map<std::string, double> readCpuUsage(const std::string& name); // Função que mapeia o uso da CPU
     std::map<std::string, size_t> readMemoryUsage(const std::string& name); // Função que mapeia o uso da memória
     std::vector<BlkIOStats> readBlkIOUsage(const std::string& name); // Função que mapeia o uso de IO
+    bool readCpuStat(const std::string& name, CpuStatCgroup& cpu); // Lê cpu.stat direto na struct, sem mapa
+    bool readPressure(const std::string& name, RecursoPSI recurso, PressaoPSI& pressao); // Lê cpu/memory/io.pressure (PSI) do cgroup
 
     // Experimento 3 — Throttling de CPU
     void runCpuThrottlingExperiment();
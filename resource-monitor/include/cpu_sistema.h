@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t MAX_CPUS = 512;       // núcleos acompanhados (linhas "cpuN" de /proc/stat)
+constexpr double LIMIAR_SATURACAO = 90.0; // % ocupado a partir do qual um núcleo é considerado saturado
+
+// Contadores de /proc/stat em struct-of-arrays: cada estado é um vetor contíguo indexado pelo nº da CPU,
+// o que permite calcular deltas e percentuais de todos os núcleos em um laço sem dependências entre iterações
+struct ContadoresCPU {
+    alignas(64) std::array<uint64_t, MAX_CPUS> user{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> nice{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> system{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> idle{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> iowait{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> irq{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> softirq{};
+    alignas(64) std::array<uint64_t, MAX_CPUS> steal{};
+    alignas(64) std::array<uint8_t, MAX_CPUS> presente{}; // 1 se a linha "cpuN" estava nesta leitura (CPU online)
+};
+
+// Percentuais do último intervalo por núcleo (user inclui nice; irq inclui softirq)
+struct PercentuaisCPU {
+    alignas(64) std::array<double, MAX_CPUS> user{};
+    alignas(64) std::array<double, MAX_CPUS> system{};
+    alignas(64) std::array<double, MAX_CPUS> iowait{};
+    alignas(64) std::array<double, MAX_CPUS> irq{};
+    alignas(64) std::array<double, MAX_CPUS> steal{};
+    alignas(64) std::array<double, MAX_CPUS> ocupado{}; // 100 - idle - iowait
+};
+
+// Visão geral do sistema no último intervalo (linha "cpu" agregada)
+struct ResumoCPU {
+    double user, system, iowait, irq, steal, ocupado; // % de toda a máquina
+    size_t nucleosSaturados;     // núcleos com ocupação >= LIMIAR_SATURACAO
+    size_t nucleoMaisOcupado;    // índice do núcleo mais ocupado
+    unsigned long procsExecutando; // procs_running: tarefas prontas ou em execução
+};
+
+// Classe ColetorCPUSistema: lê /proc/stat uma vez por tick (descritor mantido aberto e relido com pread)
+class ColetorCPUSistema {
+public:
+    ColetorCPUSistema();
+    ~ColetorCPUSistema();
+
+    // O coletor é dono do descritor, então não pode ser copiado
+    ColetorCPUSistema(const ColetorCPUSistema&) = delete;
+    ColetorCPUSistema& operator=(const ColetorCPUSistema&) = delete;
+
+    // Relê /proc/stat e calcula os percentuais desde a coleta anterior (a primeira só guarda os contadores)
+    bool coletar();
+
+    size_t numCPUs() const { return cpus; }                  // maior índice de CPU visto + 1
+    bool temIntervalo() const { return coletas >= 2; }       // já há delta entre duas coletas
+    const PercentuaisCPU& percentuais() const { return pct; }
+    const ResumoCPU& resumo() const { return geral; }
+
+    // Índices dos K núcleos mais ocupados, em ordem decrescente
+    void nucleosMaisOcupados(size_t k, std::vector<size_t> &indices) const;
+
+private:
+    int fd = -1;
+    std::vector<char> buffer;
+    ContadoresCPU atual, anterior;
+    std::array<uint64_t, 8> totalAtual{}, totalAnterior{}; // linha "cpu" agregada, mesma ordem dos estados
+    PercentuaisCPU pct;
+    ResumoCPU geral{};
+    size_t cpus = 0;
+    unsigned coletas = 0;
+
+    void calcularPercentuais(); // laço sobre os núcleos, sem dependências entre iterações
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+
+// ---- Exportação das medições em CSV fora da thread de amostragem ----
+
+// Quando os dados escritos são forçados para o disco
+enum class PoliticaFsync {
+    Nunca,     // só write(): o kernel grava quando quiser (padrão)
+    PorLote,   // fdatasync depois de cada lote escrito pela thread
+    Periodica  // fdatasync no máximo a cada 'intervaloFsync'
+};
+
+struct ConfigEscritorCSV {
+    size_t capacidadeFila = 4096;        // registros pendentes; com a fila cheia o registro é descartado (e contado)
+    size_t tamanhoBuffer = 64 * 1024;    // linhas formatadas acumuladas antes de cada write()
+    PoliticaFsync fsync = PoliticaFsync::Nunca;
+    std::chrono::milliseconds intervaloFsync{ 1000 };
+    uint64_t rotacaoBytes = 0;           // 0 = sem rotação; acima disso o arquivo vira <arquivo>.1, .2, ...
+    unsigned arquivosRotacionados = 3;   // quantos arquivos antigos são mantidos
+    bool bloquearQuandoCheia = false;    // espera espaço na fila em vez de descartar (conversões, fora da amostragem)
+};
+
+ConfigEscritorCSV configuracaoCSV();                          // configuração usada por novos escritores
+void definirConfiguracaoCSV(const ConfigEscritorCSV &config); // troca a configuração (menu principal)
+const char* nomePoliticaFsync(PoliticaFsync politica);
+
+// Classe EscritorCSV: grava uma linha por medição em um arquivo mantido aberto (O_APPEND).
+// A thread de amostragem só copia a medição para uma fila limitada; uma thread própria formata as linhas
+// com std::to_chars em um buffer grande, escreve com write(), aplica o fsync e a rotação.
+// Um disco lento atrasa a exportação, não o laço de amostragem.
+class EscritorCSV {
+public:
+    explicit EscritorCSV(std::string caminho, const ConfigEscritorCSV &config = configuracaoCSV());
+    ~EscritorCSV(); // escreve o que estiver na fila e fecha o arquivo
+
+    // O escritor é dono do arquivo e da thread, então não pode ser copiado
+    EscritorCSV(const EscritorCSV&) = delete;
+    EscritorCSV& operator=(const EscritorCSV&) = delete;
+
+    bool valido() const { return ativo; }
+
+    // Enfileira uma linha; false se a fila estava cheia (linha descartada) ou o arquivo não abriu
+    bool registrar(const StatusProcesso &medicao, const calculoMedicao &calculado);
+    // Mesmo que o anterior, com o horário da linha informado (ex.: amostras lidas de uma série binária)
+    bool registrar(const StatusProcesso &medicao, const calculoMedicao &calculado, std::time_t horario);
+
+    void descarregar(); // bloqueia até a fila esvaziar e as linhas estarem no arquivo
+
+    uint64_t linhasEscritas() const { return escritas.load(std::memory_order_relaxed); }
+    uint64_t linhasDescartadas() const { return descartadas.load(std::memory_order_relaxed); }
+    uint64_t linhasComFalha() const { return falhasEscrita.load(std::memory_order_relaxed); } // write() falhou
+    uint64_t rotacoes() const { return totalRotacoes.load(std::memory_order_relaxed); }
+    const std::string& arquivo() const { return caminho; }
+
+    void imprimirResumo(); // descarrega a fila e mostra linhas escritas, descartadas, com falha e rotações
+
+private:
+    // Uma medição na fila; a formatação acontece na thread do escritor
+    struct Registro {
+        std::time_t horario; // relógio de parede do momento em que a medição foi registrada
+        StatusProcesso medicao;
+        calculoMedicao calculado;
+    };
+
+    std::string caminho;
+    ConfigEscritorCSV config;
+    bool ativo = false;    // arquivo aberto e thread rodando (fixo depois do construtor)
+    int fd = -1;           // trocado pela thread na rotação
+    uint64_t tamanhoArquivo = 0;
+
+    // Fila circular limitada, protegida por 'trava'
+    std::mutex trava;
+    std::condition_variable cvDados, cvVazia;
+    std::vector<Registro> fila;
+    size_t inicio = 0, quantidade = 0;
+    bool gravando = false; // a thread está escrevendo um lote já retirado da fila
+    bool encerrar = false;
+    std::atomic<uint64_t> escritas{0};
+    std::atomic<uint64_t> descartadas{0};
+    std::atomic<uint64_t> falhasEscrita{0};
+    std::atomic<uint64_t> totalRotacoes{0};
+
+    std::thread thread;
+
+    // Usados só pela thread do escritor
+    std::vector<char> buffer;
+    size_t usados = 0;
+    size_t linhasNoBuffer = 0; // linhas formatadas em 'buffer' que ainda não passaram pelo write()
+    std::time_t ultimoHorario = -1;
+    char horarioFormatado[32]{};
+    std::chrono::steady_clock::time_point ultimoFsync;
+
+    bool abrirArquivo();   // abre (ou cria) o arquivo e escreve o cabeçalho se ele estiver vazio
+    void executar();       // laço da thread
+    void formatar(const Registro &registro);
+    size_t escreverBuffer(); // write() do buffer inteiro, fsync e rotação; devolve as linhas gravadas inteiras
+    void rotacionar();
+};
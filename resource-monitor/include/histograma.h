@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ---- Histograma log-linear (estilo HDR) para latências em ns ----
+// Valores abaixo de 128 têm um contador cada; acima, cada potência de 2 [2^e, 2^(e+1)) é dividida em 64
+// faixas iguais. O erro de um percentil é no máximo metade de uma faixa: < 0,8% do valor, em qualquer
+// escala. Os contadores são um vetor fixo (~20 KiB): registrar() é O(1) (um bit_width e um incremento),
+// sem alocação, e dois histogramas se mesclam somando contador a contador.
+class HistogramaLatencia {
+public:
+    static constexpr uint32_t BITS_SUBFAIXA = 6;                  // 64 faixas por potência de 2
+    static constexpr uint32_t EXPOENTE_MAXIMO = 43;               // 2^44 ns ~ 4,9 h; acima, última faixa
+    static constexpr uint32_t NUM_CONTADORES = (2u << BITS_SUBFAIXA) + (EXPOENTE_MAXIMO - BITS_SUBFAIXA) * (1u << BITS_SUBFAIXA);
+
+    HistogramaLatencia() { limpar(); }
+
+    void registrar(uint64_t valorNs);
+    void mesclar(const HistogramaLatencia &outro);
+    void limpar();
+
+    uint64_t contagem() const { return total; }
+    uint64_t minimo() const { return total ? menor : 0; }
+    uint64_t maximo() const { return maior; }
+    double media() const { return total ? static_cast<double>(soma) / static_cast<double>(total) : 0; }
+    uint64_t percentil(double p) const; // p em [0, 100]; ponto médio da faixa, limitado a [mínimo, máximo]
+
+private:
+    uint64_t contadores[NUM_CONTADORES];
+    uint64_t total;
+    uint64_t menor, maior;
+    uint64_t soma;
+
+    static uint32_t indice(uint64_t valor);
+    static uint64_t inicioFaixa(uint32_t indice);
+    static uint64_t larguraFaixa(uint32_t indice);
+};
+
+// Coletores medidos separadamente em cada amostra
+enum class ColetorMedido : uint8_t { CPU, Memoria, IO, Rede, Taskstats };
+constexpr size_t NUM_COLETORES_MEDIDOS = 5;
+
+const char* nomeColetorMedido(ColetorMedido coletor);
+
+// Um histograma por coletor: mostra qual deles produz os picos de p99, não a média dos quatro juntos
+struct LatenciasColetores {
+    HistogramaLatencia porColetor[NUM_COLETORES_MEDIDOS];
+
+    void registrar(ColetorMedido coletor, uint64_t ns) { porColetor[static_cast<size_t>(coletor)].registrar(ns); }
+    void mesclar(const LatenciasColetores &outras);
+    void limpar();
+    void imprimir() const; // tabela com amostras, média, p50/p90/p99/p99.9 e máximo (µs); omite coletores sem amostras
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+
+// ---- Histórico em memória por PID, com agregação automática em níveis ----
+// Cada série guarda as métricas de um processo (PID + starttime) em três níveis de retenção:
+//   bruto  -> cada amostra, por 10 min (até 'capacidadeBruta' amostras: a 10 ms cobre menos tempo)
+//   10 s   -> mínimo/máximo/soma/contagem por janela de 10 s, por 6 h
+//   1 min  -> mínimo/máximo/soma/contagem por janela de 1 min, por 7 dias
+// Os vetores de uma série são alocados uma vez, na reserva; adicionar() só escreve em posições já
+// existentes (anéis), então o caminho quente não aloca e a memória total é limitada por maxSeries.
+
+// Métricas guardadas por amostra
+enum class MetricaHistorico : uint8_t {
+    CPU,      // usoCPU (%)
+    RSS,      // VmRSS (kB)
+    Swap,     // VmSwap (kB)
+    Leitura,  // taxaLeituraTotal (KiB/s)
+    Escrita,  // taxaEscritaTotal (KiB/s)
+    Threads
+};
+constexpr size_t NUM_METRICAS_HISTORICO = 6;
+
+const char* nomeMetricaHistorico(MetricaHistorico metrica); // ex.: "CPU (%)"
+
+// Nível que respondeu uma consulta
+enum class NivelHistorico : uint8_t { Bruto, Agregado10s, Agregado1min };
+
+const char* nomeNivelHistorico(NivelHistorico nivel);
+
+// Resultado de uma consulta em janela
+struct ConsultaHistorico {
+    double minimo;
+    double maximo;
+    double media;
+    double percentil;
+    uint64_t amostras;        // amostras brutas cobertas pela janela
+    int64_t inicioMs;         // instante do dado mais antigo usado
+    int64_t fimMs;            // instante da última amostra da série (fim da janela)
+    NivelHistorico nivel;
+    bool percentilAproximado; // níveis agregados: percentil das médias de cada janela, ponderado pela contagem
+};
+
+// Classe SerieHistorico: as métricas de um processo. adicionar() e consultar() podem rodar em threads
+// diferentes (saída do pipeline x menu); uma trava por série protege os anéis.
+class SerieHistorico {
+public:
+    static constexpr int64_t RETENCAO_BRUTA_MS = 10LL * 60 * 1000;
+    static constexpr int64_t PASSO_10S_MS = 10LL * 1000;
+    static constexpr int64_t RETENCAO_10S_MS = 6LL * 3600 * 1000;
+    static constexpr int64_t PASSO_1MIN_MS = 60LL * 1000;
+    static constexpr int64_t RETENCAO_1MIN_MS = 7LL * 24 * 3600 * 1000;
+
+    explicit SerieHistorico(uint32_t capacidadeBruta);
+
+    // A série é compartilhada por endereço com as reservas, então não pode ser copiada
+    SerieHistorico(const SerieHistorico&) = delete;
+    SerieHistorico& operator=(const SerieHistorico&) = delete;
+
+    // Acrescenta uma amostra (instante em CLOCK_REALTIME, ms). Sem alocação
+    void adicionar(int64_t instanteMs, const StatusProcesso &medicao, const calculoMedicao &calculado);
+
+    // Janela terminando na última amostra da série. Usa o nível mais fino que cobre a janela inteira (o bruto
+    // também além de 10 min, enquanto o anel tiver as amostras); nos níveis agregados a janela é arredondada
+    // para o passo do nível. false se a série está vazia
+    bool consultar(MetricaHistorico metrica, int64_t janelaMs, double percentil, ConsultaHistorico &resultado) const;
+
+    size_t bytesReservados() const;
+
+private:
+    friend class HistoricoMetricas;
+
+    // Um nível agregado: anel de janelas de 'passoMs', cada uma com min/max/soma por métrica
+    struct Nivel {
+        int64_t passoMs = 0;
+        uint64_t escritos = 0;        // janelas já abertas; a atual é (escritos - 1) % capacidade
+        std::vector<int64_t> inicioMs;
+        std::vector<uint32_t> contagem;
+        std::vector<float> minimo;    // [janela * NUM_METRICAS_HISTORICO + métrica]
+        std::vector<float> maximo;
+        std::vector<double> soma;
+
+        Nivel(int64_t passo, int64_t retencao);
+        void adicionar(int64_t instanteMs, const float *valores);
+    };
+
+    mutable std::mutex trava;
+    int pid = 0;
+    uint64_t starttime = 0;
+    bool emUso = false;
+    int64_t primeiroMs = 0;           // primeira amostra desde a reserva
+    int64_t atualizadoMs = 0;
+
+    uint64_t brutos = 0;              // amostras brutas já escritas; a próxima vai para brutos % capacidade
+    std::vector<int64_t> instantes;
+    std::vector<float> valores;       // [amostra * NUM_METRICAS_HISTORICO + métrica]
+    Nivel nivel10s;
+    Nivel nivel1min;
+
+    void limpar(int novoPid, uint64_t novoStarttime); // reaproveita a série para outro processo (sem alocar)
+};
+
+// Estado de uma série, para listagem
+struct ResumoSerieHistorico {
+    int pid;
+    uint64_t starttime;
+    bool emUso;             // algum perfilador está gravando nela
+    uint64_t amostras;      // total desde a reserva
+    int64_t primeiroMs;     // dado mais antigo ainda retido (qualquer nível)
+    int64_t atualizadoMs;
+};
+
+// Classe HistoricoMetricas: conjunto limitado de séries. A série de um processo continua a mesma entre
+// execuções do perfilador no mesmo monitor (PID + starttime); sem séries livres, a menos recente que não
+// está em uso é reaproveitada. Séries são alocadas na primeira reserva de cada posição e nunca liberadas.
+class HistoricoMetricas {
+public:
+    HistoricoMetricas(uint32_t maxSeries, uint32_t capacidadeBruta);
+
+    // O histórico é dono das séries, então não pode ser copiado
+    HistoricoMetricas(const HistoricoMetricas&) = delete;
+    HistoricoMetricas& operator=(const HistoricoMetricas&) = delete;
+
+    SerieHistorico* reservar(int pid, uint64_t starttime); // nullptr se todas as séries estão em uso
+    void liberar(SerieHistorico *serie);                    // os dados continuam consultáveis
+
+    std::vector<ResumoSerieHistorico> series() const; // da atualizada mais recentemente para a mais antiga
+
+    // Consulta a série mais recente do PID; false se o PID não tem histórico
+    bool consultar(int pid, MetricaHistorico metrica, int64_t janelaMs, double percentil, ConsultaHistorico &resultado) const;
+
+    uint32_t capacidade() const { return static_cast<uint32_t>(posicoes.size()); }
+    size_t bytesReservados() const;
+
+    static HistoricoMetricas& padrao(); // 16 séries x 1200 amostras brutas (10 min a 0,5 s), ~1,3 MiB por série
+
+private:
+    uint32_t capacidadeBruta;
+    mutable std::mutex trava;                          // protege 'posicoes' e a troca de dono das séries
+    std::vector<std::unique_ptr<SerieHistorico>> posicoes; // nullptr = posição ainda não alocada
+};
+
+// Classe ReservaHistorico: uma série reservada, liberada no destrutor. Pode ser movida junto com o alvo
+// (ex.: na tabela do motor); sem histórico (construtor padrão) adicionar() não faz nada.
+class ReservaHistorico {
+public:
+    ReservaHistorico() = default;
+    ReservaHistorico(HistoricoMetricas &historico, const ProcessoMonitorado &processo);
+    ~ReservaHistorico();
+
+    ReservaHistorico(ReservaHistorico &&outra) noexcept;
+    ReservaHistorico& operator=(ReservaHistorico &&outra) noexcept;
+    ReservaHistorico(const ReservaHistorico&) = delete;
+    ReservaHistorico& operator=(const ReservaHistorico&) = delete;
+
+    bool valida() const { return serie != nullptr; }
+    void adicionar(int64_t instanteMs, const StatusProcesso &medicao, const calculoMedicao &calculado) {
+        if (serie) serie->adicionar(instanteMs, medicao, calculado);
+    }
+
+private:
+    HistoricoMetricas *historico = nullptr;
+    SerieHistorico *serie = nullptr;
+};
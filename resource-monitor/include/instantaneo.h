@@ -0,0 +1,143 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "anel.h" // RegistroAnel: o mesmo registro de largura fixa do anel de amostras
+
+// ---- Tabela compartilhada com a amostra mais recente de cada PID (POSIX shm) ----
+// Segmento /dev/shm/<nome> (shm_open + mmap MAP_SHARED):
+//   CabecalhoInstantaneo | SlotInstantaneo x maxProcessos
+// Cada PID monitorado ocupa um slot com só a última amostra. Painéis, sidecars e alertas leem a tabela pelo
+// mapeamento, sem nenhuma syscall por leitura, em vez de sondar os mesmos arquivos de /proc que o monitor.
+// Diferente do anel (docs/recentes.anel), não guarda histórico nem sobrevive ao monitor: o segmento é
+// recriado a cada execução e removido quando o monitor encerra.
+
+static constexpr const char* NOME_INSTANTANEO = "/resource-monitor"; // nome padrão para shm_open
+static constexpr uint32_t MAGICA_INSTANTANEO = 0x48534d52; // "RMSH"
+static constexpr uint16_t VERSAO_INSTANTANEO = 1;
+
+// Cabeçalho do segmento (fixo depois da criação)
+struct alignas(64) CabecalhoInstantaneo {
+    uint32_t magica;          // "RMSH"
+    uint16_t versao;
+    uint16_t tamanhoSlot;     // sizeof(SlotInstantaneo), conferido pelo leitor
+    uint32_t maxProcessos;
+    int32_t pidEscritor;      // PID do monitor que criou o segmento
+    int64_t criadoMs;         // CLOCK_REALTIME da criação
+};
+
+// Um PID e a sua última amostra. 'sequencia' é um seqlock: ímpar enquanto o escritor mexe no slot;
+// o leitor copia o slot e só aceita a cópia se a sequência for a mesma (e par) antes e depois.
+struct alignas(64) SlotInstantaneo {
+    std::atomic<uint32_t> sequencia;
+    int32_t pid;              // 0 = slot livre (processo não é mais monitorado)
+    uint64_t starttime;       // identidade do processo: um PID reutilizado aparece com outro starttime
+    uint64_t amostras;        // amostras publicadas desde a reserva (0 = registro ainda vazio)
+    int64_t atualizadoMs;     // instante da última amostra (CLOCK_REALTIME)
+    RegistroAnel registro;
+};
+
+// Classe InstantaneoCompartilhado: o escritor da tabela. Um único monitor por segmento (flock exclusivo);
+// se outro já estiver publicando, a tabela fica desativada nesta instância.
+class InstantaneoCompartilhado {
+public:
+    InstantaneoCompartilhado(std::string nome, uint32_t maxProcessos);
+    ~InstantaneoCompartilhado(); // remove o segmento (shm_unlink)
+
+    // A tabela é dona do mapeamento, então não pode ser copiada
+    InstantaneoCompartilhado(const InstantaneoCompartilhado&) = delete;
+    InstantaneoCompartilhado& operator=(const InstantaneoCompartilhado&) = delete;
+
+    bool valido() const { return mapa != nullptr; }
+    const std::string& segmento() const { return nome; }
+
+    int reservar(int pid, uint64_t starttime); // slot livre, ou -1 se a tabela está cheia
+    void liberar(int slot);                    // o slot some da tabela (pid = 0) e pode ser reutilizado
+
+    // Publica a amostra no slot (só a thread dona do slot chama). Sem syscalls além do clock_gettime (vDSO)
+    void publicar(int slot, const StatusProcesso &medicao, const calculoMedicao &calculado);
+
+    static InstantaneoCompartilhado& padrao(); // NOME_INSTANTANEO com 1024 slots, criado no primeiro uso
+
+private:
+    std::string nome;
+    int fd = -1;
+    void *mapa = nullptr;
+    size_t tamanhoMapa = 0;
+    CabecalhoInstantaneo *cabecalho = nullptr;
+    SlotInstantaneo *slots = nullptr;
+
+    std::mutex trava;         // protege 'emUso'
+    std::vector<bool> emUso;
+};
+
+// Classe ReservaInstantaneo: um slot reservado na tabela, liberado no destrutor. Pode ser movida junto com o
+// alvo (ex.: na tabela do motor); sem tabela (construtor padrão) publicar() não faz nada.
+class ReservaInstantaneo {
+public:
+    ReservaInstantaneo() = default;
+    ReservaInstantaneo(InstantaneoCompartilhado &tabela, const ProcessoMonitorado &processo);
+    ~ReservaInstantaneo();
+
+    ReservaInstantaneo(ReservaInstantaneo &&outra) noexcept;
+    ReservaInstantaneo& operator=(ReservaInstantaneo &&outra) noexcept;
+    ReservaInstantaneo(const ReservaInstantaneo&) = delete;
+    ReservaInstantaneo& operator=(const ReservaInstantaneo&) = delete;
+
+    bool valida() const { return slot >= 0; }
+    void publicar(const StatusProcesso &medicao, const calculoMedicao &calculado) {
+        if (slot >= 0) tabela->publicar(slot, medicao, calculado);
+    }
+
+private:
+    InstantaneoCompartilhado *tabela = nullptr;
+    int slot = -1;
+};
+
+// Cópia consistente de um slot, feita pelo LeitorInstantaneo
+struct AmostraInstantaneo {
+    uint32_t slot;
+    int pid;
+    uint64_t starttime;
+    uint64_t amostras;
+    int64_t atualizadoMs;
+    RegistroAnel registro;
+};
+
+// Classe LeitorInstantaneo: a biblioteca de leitura. Mapeia o segmento só para leitura e copia os slots
+// validando o seqlock; depois de abrir(), ler() e lerTodos() não fazem syscalls. Usada pelas ferramentas
+// de tools/ (que ligam só src/shm_reader.cpp, sem o resto do monitor).
+class LeitorInstantaneo {
+public:
+    LeitorInstantaneo() = default;
+    ~LeitorInstantaneo();
+
+    // O leitor é dono do mapeamento, então não pode ser copiado
+    LeitorInstantaneo(const LeitorInstantaneo&) = delete;
+    LeitorInstantaneo& operator=(const LeitorInstantaneo&) = delete;
+
+    bool abrir(const std::string &nome = NOME_INSTANTANEO);
+    void fechar();
+    bool aberto() const { return mapa != nullptr; }
+
+    // O monitor que criou o segmento ainda publica nele (flock; uma syscall). Falso depois que ele encerra:
+    // o mapeamento continua legível, mas congelado, e abrir() de novo encontra o segmento da execução nova
+    bool escritorAtivo() const;
+    uint32_t maxProcessos() const { return cabecalho ? cabecalho->maxProcessos : 0; }
+    int pidEscritor() const { return cabecalho ? cabecalho->pidEscritor : 0; }
+
+    // Copia um slot; false se está livre, ainda sem amostra ou sem cópia consistente após várias tentativas
+    bool ler(uint32_t slot, AmostraInstantaneo &saida) const;
+    bool lerPID(int pid, AmostraInstantaneo &saida) const; // a amostra mais recente do PID
+    size_t lerTodos(std::vector<AmostraInstantaneo> &saida) const; // slots ocupados, na ordem dos slots
+
+private:
+    int fd = -1;
+    const void *mapa = nullptr;
+    size_t tamanhoMapa = 0;
+    const CabecalhoInstantaneo *cabecalho = nullptr;
+    const SlotInstantaneo *slots = nullptr;
+};
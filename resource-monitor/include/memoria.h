@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include "sessao.h"
+
+// ---- Memória proporcional do processo, de /proc/<pid>/smaps_rollup (valores em kB) ----
+// O VmRSS conta integralmente as páginas compartilhadas (ex.: workers de um pool pré-forkado);
+// o PSS divide cada página compartilhada entre os processos que a mapeiam e o USS conta só as privadas.
+struct MemoriaDetalhada {
+    unsigned long rss;          // Rss: igual ao VmRSS
+    unsigned long pss;          // Pss: custo proporcional do processo
+    unsigned long uss;          // Private_Clean + Private_Dirty: liberado se o processo encerrar
+    unsigned long compartilhada; // Shared_Clean + Shared_Dirty
+    unsigned long pssAnonima;   // Pss_Anon: heap, pilhas e mapeamentos anônimos
+    unsigned long pssArquivo;   // Pss_File: páginas de arquivos mapeados (cache)
+    unsigned long pssShmem;     // Pss_Shmem: memória compartilhada (tmpfs/shm)
+    unsigned long swap;         // Swap
+    unsigned long swapPss;      // SwapPss: parcela proporcional do swap
+};
+
+// Classe ColetorSmaps: lê smaps_rollup com limite opcional de frequência.
+// O kernel percorre todas as VMAs do processo a cada leitura, o que é caro em espaços de endereçamento
+// grandes; dentro do intervalo mínimo o coletor devolve a última amostra daquele processo sem ler o arquivo.
+// A amostra é guardada por PID (com o starttime, quando o chamador o conhece), então alternar entre vários
+// processos não desfaz o limite.
+// O descritor fica em uma SessaoColeta própria: uma leitura que falha libera o PID na sessão, e em uma sessão
+// compartilhada isso fecharia também o stat/status/io do mesmo processo.
+class ColetorSmaps {
+public:
+    explicit ColetorSmaps(std::chrono::milliseconds intervaloMinimo = std::chrono::milliseconds(0));
+
+    void definirIntervaloMinimo(std::chrono::milliseconds intervalo); // 0 = lê em toda chamada
+
+    // Preenche 'memoria'; false se o arquivo não pôde ser lido (processo encerrou, sem permissão ou kernel < 4.14).
+    // 'starttime' (campo 22 do stat) separa um PID reutilizado da amostra guardada; 0 = não confere
+    bool coletar(int pid, MemoriaDetalhada &memoria, uint64_t starttime = 0);
+
+    bool ultimaFoiCache() const { return usouCache; } // true se a última chamada devolveu a amostra guardada
+
+private:
+    static constexpr size_t LIMITE_AMOSTRAS = 256; // acima disso as amostras vencidas são descartadas
+
+    struct AmostraSmaps {
+        uint64_t starttime;
+        std::chrono::steady_clock::time_point leitura;
+        MemoriaDetalhada memoria;
+    };
+
+    std::chrono::milliseconds intervaloMinimo;
+    std::unordered_map<int, AmostraSmaps> amostras; // última leitura de cada PID
+    bool usouCache = false;
+    SessaoColeta sessao; // só o smaps_rollup
+};
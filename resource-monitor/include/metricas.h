@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+#include "psi.h"
+
+// ---- Exposição das métricas em formato OpenMetrics (texto) por HTTP/1.1 ----
+
+// Classe RenderizadorMetricas: monta um snapshot OpenMetrics completo. As amostras de cada família ficam
+// juntas (exigência do formato) mesmo com vários processos: cada família tem o seu buffer, e finalizar()
+// emite as famílias em ordem fixa, terminando com "# EOF". Quem renderiza é quem coleta (saída do pipeline,
+// laço do motor); o servidor só entrega o texto pronto.
+class RenderizadorMetricas {
+public:
+    RenderizadorMetricas();
+
+    // Valores atuais de um processo (rótulo pid); taxas de calculoMedicao convertidas para bytes/s
+    void processo(const StatusProcesso &medicao, const calculoMedicao &calculado);
+
+    // cpu.stat, memory.current, io.stat e PSI de um cgroup v2 (caminho como em /proc/<pid>/cgroup);
+    // arquivos ausentes (controlador desabilitado) são ignorados
+    void cgroup(const std::string &caminho);
+
+    // /proc/pressure/{cpu,memory,io}
+    void pressaoSistema();
+
+    std::string finalizar(); // texto completo; o renderizador fica vazio para o próximo snapshot
+
+private:
+    struct Familia {
+        const char *nome;
+        const char *tipo;    // "gauge" ou "counter"
+        const char *unidade; // "" se não houver
+        const char *ajuda;
+        std::string amostras;
+    };
+    std::vector<Familia> familias;
+
+    void amostra(size_t familia, const std::string &rotulos, double valor);
+    void pressao(const std::string &origem, RecursoPSI recurso, const PressaoPSI &p); // origem: rótulo do cgroup ou vazio
+};
+
+// Classe ServidorMetricas: servidor HTTP/1.1 mínimo, de uma thread, com epoll. Escuta em 127.0.0.1:<porta>
+// e/ou num socket Unix e responde GET /metrics com o último snapshot publicado, sem coletar nada na
+// requisição. Conexões keep-alive são mantidas; requisições maiores que 8 KiB são recusadas.
+class ServidorMetricas {
+public:
+    ServidorMetricas();
+    ~ServidorMetricas(); // parar()
+
+    // O servidor é dono dos sockets e da thread, então não pode ser copiado
+    ServidorMetricas(const ServidorMetricas&) = delete;
+    ServidorMetricas& operator=(const ServidorMetricas&) = delete;
+
+    bool escutarTCP(uint16_t porta);              // só loopback; inicia a thread na primeira escuta
+    bool escutarUnix(const std::string &caminho); // remove um socket antigo no mesmo caminho
+    void parar();                                 // fecha escutas e conexões e junta a thread
+
+    bool ativo() const { return executando.load(std::memory_order_acquire); }
+    std::vector<std::string> enderecos() const;
+    uint64_t requisicoes() const { return atendidas.load(std::memory_order_relaxed); }
+
+    // Troca o snapshot servido (texto OpenMetrics completo). Barato: só troca um ponteiro sob a trava
+    void publicar(std::string snapshot);
+
+    static ServidorMetricas& padrao(); // usado pelo menu e pelos perfiladores
+
+private:
+    struct Escuta {
+        int fd;
+        std::string endereco; // "127.0.0.1:9101" ou "unix:/caminho"
+        std::string caminhoUnix;
+    };
+    struct Conexao {
+        std::string entrada;                      // bytes da requisição ainda não respondida
+        std::string cabecalho;                    // resposta em envio: cabeçalho...
+        std::shared_ptr<const std::string> corpo; // ...e o snapshot (mantido vivo até o fim do envio)
+        size_t enviados = 0;
+        bool fecharAposEnvio = false;
+        bool aguardandoSaida = false;             // EPOLLOUT registrado (socket cheio)
+        bool entradaEncerrada = false;            // cliente fez shutdown(SHUT_WR): responde ao que chegou e fecha
+    };
+
+    int epfd = -1;
+    int eventoParar = -1; // eventfd que acorda o epoll_wait em parar()
+    std::thread thread;
+    std::atomic<bool> executando{false};
+    std::atomic<uint64_t> atendidas{0};
+
+    mutable std::mutex trava;                      // protege 'escutas' e 'snapshot'
+    std::vector<Escuta> escutas;
+    std::shared_ptr<const std::string> snapshot;
+    std::unordered_map<int, Conexao> conexoes;     // só a thread do servidor mexe
+
+    bool adicionarEscuta(int fd, std::string endereco, std::string caminhoUnix);
+    void executar();
+    void aceitar(int fd);
+    void ler(int fd);
+    void escrever(int fd);
+    void processar(int fd, Conexao &conexao);  // responde às requisições completas já recebidas, uma por vez
+    void responder(Conexao &conexao, std::string_view requisicao);
+    void fecharConexao(int fd);
+};
@@ -1,12 +1,19 @@
 #pragma once // garante inclusão única do header
+#include <cstdint>
+#include "sessao.h" // SessaoColeta: descritores de /proc mantidos abertos entre coletas
+#include "rede.h"   // RastreadorFds: fds de socket rastreados de forma incremental
+#include "pidfd.h"  // ProcessoMonitorado: PID validado uma vez, com pidfd e starttime
 
 // ---- Estrutura que guarda o status atual de um processo ----
 struct StatusProcesso{
     int PID; // identificador do processo
+    uint64_t instanteNs; // CLOCK_MONOTONIC do momento da coleta (ns), para taxas pelo intervalo medido
 
     // --- CPU ---
     double utime;   // tempo em modo usuário consumido pelo processo (segundos)
     double stime;   // tempo em modo kernel (sistema) consumido pelo processo (segundos)
+    double tempoCPU;  // tempo total em CPU (s) com precisão de ns; utime/stime têm resolução de 1 tick (10 ms)
+    double esperaCPU; // tempo esperando na fila de execução (s), de schedstat; 0 se indisponível
     unsigned int threads; // número de threads ativas no processo
     unsigned int contextSwitchfree;   // trocas de contexto voluntárias
     unsigned int contextSwitchforced; // trocas de contexto forçadas
@@ -48,17 +55,35 @@ struct RelatorioFilho {
     uint64_t operacoes;         // número de iterações read+write no período
     double   latMediaMs;        // latência média das operações no período (ms)
     uint64_t timestampNs;       // timestamp em nanossegundos do relatório
+    uint32_t janela;            // número da janela de 1 s (o relatório final fecha a última, parcial)
+    uint32_t bytesSketch;       // tamanho do SketchQuantis serializado que segue a estrutura no pipe (latências em ns)
 };
 
-// ---- Funções auxiliares ----
-bool processoExiste(int PID);            // retorna true se o processo existe
-bool temPermissao(int PID);              // retorna true se temos permissão de acesso
+// Os coletores recebem o processo já validado (existência e permissão conferidas uma vez, em abrir())
+// e gravam o PID dele em medicao.PID. Quem lê stat confere o starttime: PID reutilizado é uma falha.
+// Os arquivos de /proc são relidos pelos descritores mantidos na sessão; sem sessão explícita
+// é usada SessaoColeta::padrao().
+bool coletorIO(const ProcessoMonitorado &processo, StatusProcesso &medicao, SessaoColeta &sessao = SessaoColeta::padrao());      // preenche métricas de I/O
+bool coletorNetwork(const ProcessoMonitorado &processo, StatusProcesso &medicao, RastreadorFds &rastreador = RastreadorFds::padrao()); // preenche métricas de rede
+// Tempo gasto em cada parte do coletorSnapshot (ns, CLOCK_MONOTONIC)
+struct TemposColeta {
+    uint64_t cpuNs;     // stat + schedstat
+    uint64_t memoriaNs; // status
+    uint64_t ioNs;      // io
+};
+struct LatenciasColetores; // histogramas por coletor (histograma.h)
 
-bool coletorCPU(StatusProcesso &medicao);     // preenche métricas de CPU
-bool coletorMemoria(StatusProcesso &medicao); // preenche métricas de memória
-bool coletorIO(StatusProcesso &medicao);      // preenche métricas de I/O
-bool coletorNetwork(StatusProcesso &medicao); // preenche métricas de rede
+// Lê stat, status e io uma única vez cada e preenche todos os campos de CPU, memória e I/O.
+// Com 'tempos', mede cada parte separadamente (três leituras extras do relógio pelo vDSO).
+// Com 'tempoCPUExterno', utime/stime/tempoCPU/esperaCPU já foram preenchidos (TASKSTATS) e schedstat não é lido
+bool coletorSnapshot(const ProcessoMonitorado &processo, StatusProcesso &medicao, SessaoColeta &sessao = SessaoColeta::padrao(),
+                     TemposColeta *tempos = nullptr, bool tempoCPUExterno = false);
+// Coleta completa, retorna latência (ms); com 'latencias', registra o tempo de cada coletor
+double coletarAmostra(const ProcessoMonitorado &processo, StatusProcesso &status, SessaoColeta &sessao, RastreadorFds &rastreador,
+                      LatenciasColetores *latencias = nullptr);
+uint64_t tempoCPUThreadNs(); // CPU consumida pela thread chamadora (CLOCK_THREAD_CPUTIME_ID), em ns
 
 void overheadMonitoramento(); // mede o overhead do monitoramento em si
 void cargaExecutar();         // executa carga de teste para medir métricas
 void limitacaoIO();           // executa teste de limitação de I/O
+void benchmarkParsers();      // compara ciclos por parse dos parsers antigos e novos
@@ -0,0 +1,114 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+#include "anel.h"
+#include "instantaneo.h"
+#include "historico.h"
+
+// ---- Motor do profiler para vários processos no mesmo laço de amostragem ----
+
+// Como os alvos são escolhidos
+enum class CriterioAlvos {
+    ListaPIDs, // PIDs informados explicitamente
+    Nome,      // processos cujo comm contém o texto
+    Cgroup     // processos do cgroup (v2) e de todos os seus descendentes
+};
+
+// Uma linha da tabela de alvos. A tabela é um único vetor contíguo ordenado por PID; cada linha guarda
+// a amostra anterior e a atual, e as taxas entre elas. Alinhada a 64 bytes para que dois workers
+// escrevendo em linhas vizinhas não disputem a mesma linha de cache.
+struct alignas(64) AlvoProfiler {
+    int pid;
+    uint32_t trabalhador; // worker responsável (fixo enquanto o PID estiver na tabela)
+    uint32_t amostras;    // coletas bem-sucedidas; taxas válidas a partir da segunda
+    bool ativo;           // false depois que o processo encerrou ou a coleta falhou
+    ProcessoMonitorado processo; // pidfd + starttime: um PID reutilizado não herda as amostras do anterior
+    ReservaAnel anel;     // slot no anel mmap de amostras recentes (vazio se o motor não grava no anel)
+    ReservaHistorico historico; // série no histórico em memória (vazia se o motor não guarda histórico)
+    ReservaInstantaneo instantaneo; // slot na tabela compartilhada (POSIX shm) com a última amostra
+    StatusProcesso anterior;
+    StatusProcesso atual;
+    calculoMedicao taxas; // CPU% e KiB/s entre 'anterior' e 'atual', pelo intervalo medido
+};
+
+// Taxas entre duas amostras do mesmo processo, usando os instantes monotônicos de cada uma.
+// 'nucleosOnline' (sysconf(_SC_NPROCESSORS_ONLN)) é lido pelo chamador fora do caminho quente (uma vez por tick no motor)
+void calcularMedicao(const StatusProcesso &anterior, const StatusProcesso &atual, long nucleosOnline, calculoMedicao &resultado);
+
+// Classe MotorProfiler: amostra um conjunto de PIDs a cada tick com um pool de workers.
+// Cada PID pertence sempre ao mesmo worker, que mantém a própria SessaoColeta e RastreadorFds,
+// então os descritores de /proc/<pid> são abertos uma vez e só por uma thread.
+// A tabela de sockets por namespace (CacheSockets) é compartilhada e montada uma vez por tick.
+class MotorProfiler {
+public:
+    explicit MotorProfiler(size_t trabalhadores = 0); // 0 = um worker por núcleo online
+    ~MotorProfiler();
+
+    // O motor é dono das threads e dos descritores, então não pode ser copiado
+    MotorProfiler(const MotorProfiler&) = delete;
+    MotorProfiler& operator=(const MotorProfiler&) = delete;
+
+    // Seleção dos alvos; a tabela é montada no próximo amostrar()
+    void alvosPorPIDs(std::vector<int> pids);
+    void alvosPorNome(const std::string &nome);
+    void alvosPorCgroup(const std::string &cgroup); // relativo a /sys/fs/cgroup ou caminho absoluto
+
+    void definirReavaliacao(unsigned ticks); // Nome/Cgroup: refaz a seleção a cada N ticks (0 = só no início)
+    void definirColetaRede(bool ativa);      // fds de socket por PID (o custo mais alto por alvo)
+    void definirAnel(AnelAmostras *anel);    // grava cada amostra no anel (nullptr = não grava); vale para alvos novos
+    void definirHistorico(HistoricoMetricas *historico); // idem, no histórico em memória (a partir da 2ª amostra)
+    void definirInstantaneo(InstantaneoCompartilhado *tabela); // publica a última amostra de cada alvo na tabela compartilhada
+
+    // Coleta todos os alvos ativos em paralelo; false se não há nenhum alvo ativo
+    bool amostrar();
+
+    const std::vector<AlvoProfiler>& alvos() const { return tabela; }
+    size_t alvosAtivos() const;
+    size_t numTrabalhadores() const { return trabalhadores.size(); }
+    double duracaoUltimoTickMs() const { return ultimoTickMs; }
+
+private:
+    struct Trabalhador {
+        std::thread thread;
+        SessaoColeta sessao;           // /proc/<pid>/{stat,status,io,schedstat} dos PIDs do worker
+        RastreadorFds rastreador;      // /proc/<pid>/fd dos PIDs do worker
+        std::vector<uint32_t> indices; // linhas da tabela atribuídas a este worker
+    };
+
+    std::vector<std::unique_ptr<Trabalhador>> trabalhadores;
+    std::vector<AlvoProfiler> tabela;
+
+    CriterioAlvos criterio = CriterioAlvos::ListaPIDs;
+    std::vector<int> pidsInformados;
+    std::string filtro;            // nome ou cgroup
+    unsigned reavaliarACada = 10;
+    bool coletarRede = true;
+    AnelAmostras *anelAmostras = nullptr;
+    HistoricoMetricas *historicoMetricas = nullptr;
+    InstantaneoCompartilhado *tabelaInstantaneo = nullptr;
+    bool selecaoPendente = false;  // critério trocado: tabela precisa ser remontada
+    uint64_t ticks = 0;
+    double ultimoTickMs = 0;
+    long nucleosOnline = 1;        // lido no início de cada tick, para o CPU% global de todos os alvos
+
+    // Sincronização do pool: cada tick incrementa 'geracao' e espera 'pendentes' chegar a zero
+    std::mutex trava;
+    std::condition_variable cvInicio, cvFim;
+    uint64_t geracao = 0;
+    size_t pendentes = 0;
+    bool encerrar = false;
+
+    void executarTrabalhador(Trabalhador &t);
+    void coletarFatia(Trabalhador &t);
+    void reavaliar();                       // resolve o critério e mescla o resultado na tabela
+    std::vector<int> resolverAlvos() const; // PIDs atuais do critério, ordenados
+};
+
+void benchmarkMotor(); // Experimento nº9: duração do tick com 1000+ alvos e diferentes nº de workers
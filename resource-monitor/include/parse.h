@@ -0,0 +1,86 @@
+#pragma once
+#include <string_view>
+#include <charconv>
+#include <array>
+#include <cstring>
+#include <cstddef>
+
+// ---- Biblioteca mínima de parsing sem alocação ----
+// Todas as funções trabalham com std::string_view sobre um buffer já lido (ex.: pela SessaoColeta),
+// avançando a view conforme consomem o texto. Nenhuma delas cria std::string nem usa streams.
+
+// Descarta espaços e tabs no início da view
+inline void pularEspacos(std::string_view &texto) {
+    size_t i = 0;
+    while (i < texto.size() && (texto[i] == ' ' || texto[i] == '\t'))
+        ++i;
+    texto.remove_prefix(i);
+}
+
+// Retorna o próximo token separado por espaço/tab/quebra de linha e avança a view
+inline std::string_view proximoToken(std::string_view &texto) {
+    pularEspacos(texto);
+    size_t fim = 0;
+    while (fim < texto.size() && texto[fim] != ' ' && texto[fim] != '\t' && texto[fim] != '\n')
+        ++fim;
+    std::string_view token = texto.substr(0, fim);
+    texto.remove_prefix(fim);
+    return token;
+}
+
+// Descarta os próximos 'quantidade' tokens
+inline void pularTokens(std::string_view &texto, int quantidade) {
+    for (int i = 0; i < quantidade; ++i)
+        proximoToken(texto);
+}
+
+// Retorna a próxima linha (sem o '\n') e avança a view para depois dela
+inline std::string_view proximaLinha(std::string_view &texto) {
+    size_t fim = texto.find('\n');
+    std::string_view linha = texto.substr(0, fim);
+    texto.remove_prefix(fim == std::string_view::npos ? texto.size() : fim + 1);
+    return linha;
+}
+
+// Converte o token inteiro com std::from_chars; false se não começar com número
+template <typename T>
+inline bool converterNumero(std::string_view token, T &valor, int base = 10) {
+    auto [ptr, erro] = std::from_chars(token.data(), token.data() + token.size(), valor, base);
+    (void)ptr;
+    return erro == std::errc();
+}
+
+// Lê o próximo token como número
+template <typename T>
+inline bool lerNumero(std::string_view &texto, T &valor) {
+    return converterNumero(proximoToken(texto), valor);
+}
+
+// Tabela de chaves pré-computada: o tamanho e o primeiro caractere de cada chave são
+// guardados na construção, então a maioria das linhas é descartada sem comparar strings.
+template <size_t N>
+class TabelaChaves {
+public:
+    constexpr TabelaChaves(const std::array<std::string_view, N> &lista) : chaves(lista) {
+        for (size_t i = 0; i < N; ++i) {
+            tamanhos[i] = chaves[i].size();
+            iniciais[i] = chaves[i].empty() ? '\0' : chaves[i][0];
+        }
+    }
+
+    // Retorna o índice da chave na tabela ou -1 se ela não interessa
+    int buscar(std::string_view chave) const {
+        if (chave.empty()) return -1;
+        for (size_t i = 0; i < N; ++i) {
+            if (tamanhos[i] != chave.size() || iniciais[i] != chave[0]) continue;
+            if (std::memcmp(chaves[i].data(), chave.data(), chave.size()) == 0)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+private:
+    std::array<std::string_view, N> chaves;
+    std::array<size_t, N> tamanhos{};
+    std::array<char, N> iniciais{};
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+struct CamposStat; // include/procfs.h
+
+// ---- Handle de um processo monitorado (pidfd + starttime) ----
+
+// Classe ProcessoMonitorado: valida o PID uma vez (existência e permissão) e fixa a identidade do processo.
+// O pidfd (pidfd_open) continua apontando para o mesmo processo mesmo que o PID seja reutilizado,
+// e fica legível (POLLIN) quando ele encerra, então a saída pode ser esperada com poll() em vez de sondada.
+// O starttime de /proc/<pid>/stat é guardado para os coletores conferirem, a cada leitura de stat,
+// que o PID ainda é o mesmo processo (sem isso um PID reutilizado entre dois ticks corromperia os deltas).
+class ProcessoMonitorado {
+public:
+    ProcessoMonitorado() = default;
+    explicit ProcessoMonitorado(int pid, bool avisar = true) { abrir(pid, avisar); }
+    ~ProcessoMonitorado();
+
+    // O handle é dono do pidfd: pode ser movido (ex.: dentro da tabela do motor), não copiado
+    ProcessoMonitorado(ProcessoMonitorado &&outro) noexcept;
+    ProcessoMonitorado& operator=(ProcessoMonitorado &&outro) noexcept;
+    ProcessoMonitorado(const ProcessoMonitorado&) = delete;
+    ProcessoMonitorado& operator=(const ProcessoMonitorado&) = delete;
+
+    // Abre o pidfd e lê o starttime; false (com a mensagem no std::cerr, se 'avisar') se o processo
+    // não existe ou se não temos permissão para ler /proc/<pid>
+    bool abrir(int pid, bool avisar = true);
+    void fechar();
+
+    bool valido() const { return id > 0; }
+    int pid() const { return id; }
+    int descritor() const { return fd; }           // pidfd para poll(); -1 em kernels sem pidfd_open (< 5.3)
+    uint64_t inicio() const { return starttime; }  // ticks desde o boot
+
+    // true se 'stat' (lido pelo coletor) é do mesmo processo aberto; sem syscall
+    bool mesmaIdentidade(const CamposStat &stat) const;
+
+    // true se o processo já encerrou: um poll() sem espera no pidfd (ou kill(pid, 0), sem pidfd).
+    // Para esperar a saída junto com outros eventos, coloque descritor() no mesmo poll()
+    bool encerrou() const;
+
+private:
+    int id = -1;
+    int fd = -1;
+    uint64_t starttime = 0;
+};
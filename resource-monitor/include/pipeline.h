@@ -0,0 +1,197 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+#include "taskstats.h"
+#include "psi.h"
+#include "agendador.h"
+#include "histograma.h"
+
+// ---- Fila lock-free de um produtor e um consumidor ----
+
+// Classe FilaSPSC: anel de capacidade fixa (potência de 2) entre exatamente duas threads.
+// Produtor e consumidor só tocam os próprios índices; cada um guarda uma cópia do índice do outro e só
+// relê o atômico quando a cópia indica fila cheia/vazia, então o caso comum não disputa linha de cache.
+// Esperas usam std::atomic::wait (futex), sem custo para o outro lado quando ninguém está dormindo.
+template <typename T>
+class FilaSPSC {
+public:
+    explicit FilaSPSC(size_t capacidadeMinima) {
+        size_t capacidade = 2;
+        while (capacidade < capacidadeMinima) capacidade <<= 1;
+        itens.resize(capacidade);
+        mascara = capacidade - 1;
+    }
+
+    // A fila é compartilhada por endereço entre as duas threads, então não pode ser copiada nem movida
+    FilaSPSC(const FilaSPSC&) = delete;
+    FilaSPSC& operator=(const FilaSPSC&) = delete;
+
+    size_t capacidade() const { return itens.size(); }
+    size_t tamanho() const { return static_cast<size_t>(cauda.load(std::memory_order_acquire) - cabeca.load(std::memory_order_acquire)); }
+
+    // Produtor: false se a fila está cheia (nada é escrito)
+    bool tentarInserir(const T &item) {
+        uint64_t c = cauda.load(std::memory_order_relaxed);
+        if (c - cabecaVista >= itens.size()) {
+            cabecaVista = cabeca.load(std::memory_order_acquire);
+            if (c - cabecaVista >= itens.size()) return false;
+        }
+        itens[c & mascara] = item;
+        cauda.store(c + 1, std::memory_order_release);
+        cauda.notify_one();
+        return true;
+    }
+
+    // Consumidor: false se a fila está vazia
+    bool tentarRetirar(T &item) {
+        uint64_t h = cabeca.load(std::memory_order_relaxed);
+        if (h == caudaVista) {
+            caudaVista = cauda.load(std::memory_order_acquire);
+            if (h == caudaVista) return false;
+        }
+        item = std::move(itens[h & mascara]);
+        cabeca.store(h + 1, std::memory_order_release);
+        cabeca.notify_one();
+        return true;
+    }
+
+    // Consumidor: dorme até existir ao menos um item
+    void esperarDados() {
+        uint64_t h = cabeca.load(std::memory_order_relaxed);
+        cauda.wait(h, std::memory_order_acquire);
+    }
+
+    // Produtor: dorme até existir ao menos uma posição livre
+    void esperarEspaco() {
+        uint64_t c = cauda.load(std::memory_order_relaxed);
+        uint64_t h = cabeca.load(std::memory_order_acquire);
+        if (c - h < itens.size()) return;
+        cabeca.wait(h, std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> itens;
+    size_t mascara = 0;
+    alignas(64) std::atomic<uint64_t> cabeca{0}; // próximo item a retirar (escrito pelo consumidor)
+    uint64_t caudaVista = 0;                     // cópia de 'cauda' do consumidor
+    alignas(64) std::atomic<uint64_t> cauda{0};  // próxima posição livre (escrita pelo produtor)
+    uint64_t cabecaVista = 0;                    // cópia de 'cabeca' do produtor
+};
+
+// ---- Pipeline do perfilador: coleta -> derivação -> saídas ----
+
+// Por que o pipeline terminou (item Fim)
+enum class MotivoFim : uint8_t {
+    Parado,           // parar() chamado pelo menu
+    ProcessoEncerrou, // pidfd legível
+    FalhaColeta       // leitura de /proc falhou
+};
+
+// O que trafega pelas filas: uma amostra, um aviso de PSI ou o fim do fluxo
+struct ItemPipeline {
+    enum class Tipo : uint8_t { Amostra, Travamento, Fim };
+    Tipo tipo = Tipo::Amostra;
+    MotivoFim motivo = MotivoFim::Parado;
+
+    // Preenchidos pelo coletor
+    uint64_t sequencia = 0;       // número da amostra (lacunas = descartes na fila da coleta)
+    int64_t instanteMs = 0;       // CLOCK_REALTIME da coleta
+    uint64_t cpuColetorNs = 0;    // CPU da thread coletora até esta amostra (custo do próprio monitor)
+    uint64_t prazosPerdidos = 0;  // do agendador, no momento da coleta
+    bool comAtrasos = false;
+    StatusProcesso medicao{};
+    AtrasosProcesso atrasos{};
+
+    // Preenchido pela derivação (taxas entre esta amostra e a anterior; zeros na primeira)
+    calculoMedicao calculado{};
+
+    // Travamento: gatilho de PSI que disparou entre duas coletas
+    bool removido = false;
+    char rotulo[64]{};
+    PressaoPSI pressao{};
+};
+
+// Contadores de um estágio (cópia para exibição)
+struct EstatisticasEstagio {
+    std::string nome;
+    uint64_t processados;  // itens entregues ao estágio
+    uint64_t descartados;  // fila cheia além da espera máxima
+    uint64_t esperas;      // vezes em que a fila estava cheia e o produtor esperou (backpressure)
+    size_t capacidade;
+};
+
+// Classe PipelinePerfilador: separa o laço do Resource Profiler em threads ligadas por filas SPSC.
+//   coletor   -> pacing pelo AgendadorAmostras, /proc + TASKSTATS, espera PSI/pidfd; nunca espera saída:
+//                com a fila cheia a amostra é descartada e contada
+//   derivação -> CPU% e taxas de I/O entre amostras consecutivas (calcularMedicao) e distribuição
+//   saídas    -> uma thread e uma fila por saída (CSV, terminal, exportadores); com a fila cheia a derivação
+//                espera até 'esperaMaxima' (backpressure) e depois descarta, contando os dois casos
+// Uma saída lenta atrasa só a si mesma; o intervalo de coleta continua o do agendador.
+class PipelinePerfilador {
+public:
+    using Consumidor = std::function<void(const ItemPipeline&)>;
+
+    PipelinePerfilador(ProcessoMonitorado &processo, double intervaloSegundos, MonitorPSI &psi,
+                       size_t capacidadeColeta = 1024);
+    ~PipelinePerfilador(); // parar()
+
+    // O pipeline é dono das threads e das filas, então não pode ser copiado
+    PipelinePerfilador(const PipelinePerfilador&) = delete;
+    PipelinePerfilador& operator=(const PipelinePerfilador&) = delete;
+
+    // Registra uma saída (antes de iniciar). O consumidor roda na thread da saída e recebe todos os tipos
+    // de item; o Fim é sempre entregue, mesmo que a fila esteja cheia
+    void adicionarSaida(std::string nome, size_t capacidade, std::chrono::microseconds esperaMaxima, Consumidor consumir);
+
+    void iniciar();
+    void parar(); // encerra a coleta, esvazia as filas e junta as threads
+
+    bool terminou() const { return fimColeta.load(std::memory_order_acquire); } // coletor já enviou o Fim
+    uint64_t amostrasColetadas() const { return coletadas.load(std::memory_order_relaxed); }
+    std::vector<EstatisticasEstagio> estatisticas() const;
+
+    void imprimirResumo(); // prazos perdidos/jitter do agendador, contadores de cada estágio e latência de cada coletor (após parar)
+
+private:
+    struct Saida {
+        std::string nome;
+        FilaSPSC<ItemPipeline> fila;
+        std::chrono::microseconds esperaMaxima;
+        Consumidor consumir;
+        std::thread thread;
+        std::atomic<uint64_t> processados{0};
+        std::atomic<uint64_t> descartados{0};
+        std::atomic<uint64_t> esperas{0};
+
+        Saida(std::string n, size_t capacidade, std::chrono::microseconds espera, Consumidor c)
+            : nome(std::move(n)), fila(capacidade), esperaMaxima(espera), consumir(std::move(c)) {}
+    };
+
+    ProcessoMonitorado &processo;
+    MonitorPSI &monitorPSI;
+    FilaSPSC<ItemPipeline> filaColeta; // coletor -> derivação
+    std::vector<std::unique_ptr<Saida>> saidas;
+    AgendadorAmostras agendador;       // usado só pela thread coletora enquanto ela roda
+    std::unique_ptr<LatenciasColetores> latencias; // idem: tempo de cada coletor por amostra
+
+    std::thread threadColetor, threadDerivacao;
+    std::atomic<bool> encerrar{false};
+    std::atomic<bool> fimColeta{false};
+    std::atomic<uint64_t> coletadas{0};
+    std::atomic<uint64_t> descartadasColeta{0};
+    bool iniciado = false;
+
+    void executarColetor();
+    void executarDerivacao();
+    void executarSaida(Saida &saida);
+    void entregar(Saida &saida, const ItemPipeline &item); // com espera limitada, descarte e contadores
+    void enviarFim(FilaSPSC<ItemPipeline> &fila, const ItemPipeline &fim); // bloqueante: o Fim nunca é descartado
+};
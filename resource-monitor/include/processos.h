@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+struct proc_event; // <linux/cn_proc.h>, incluído só em src/process_table.cpp
+
+// ---- Tabela de processos vivos mantida pelos eventos do proc connector (NETLINK_CONNECTOR) ----
+
+// Um processo da tabela (só líderes de grupo: PID == TGID; threads não entram)
+struct EntradaProcesso {
+    int pid;
+    std::string nome; // comm (até 15 caracteres), atualizado em exec e em mudanças de nome
+};
+
+// Classe TabelaProcessos: descobre os processos do sistema sem varrer /proc a cada consulta.
+// Uma thread assina os eventos fork/exec/exit/comm do kernel e aplica cada um na tabela; /proc só é varrido
+// inteiro na partida e quando o socket transborda (ENOBUFS: eventos perdidos, a tabela pode estar errada).
+// Sem o conector (kernel sem CONFIG_PROC_EVENTS ou sem CAP_NET_ADMIN), cada consulta volta a varrer /proc.
+class TabelaProcessos {
+public:
+    TabelaProcessos();
+    ~TabelaProcessos();
+
+    // A tabela é dona do socket netlink e da thread de eventos, então não pode ser copiada
+    TabelaProcessos(const TabelaProcessos&) = delete;
+    TabelaProcessos& operator=(const TabelaProcessos&) = delete;
+
+    bool conectorAtivo() const { return fd >= 0; }
+
+    // Cópias consistentes da tabela, ordenadas por PID
+    std::vector<EntradaProcesso> listar();
+    std::vector<int> pids();
+
+    uint64_t eventos() const { return totalEventos.load(std::memory_order_relaxed); }    // eventos aplicados
+    uint64_t varreduras() const { return totalVarreduras.load(std::memory_order_relaxed); } // varreduras completas de /proc
+    uint64_t estouros() const { return totalEstouros.load(std::memory_order_relaxed); }     // ENOBUFS recebidos
+
+    static TabelaProcessos& padrao(); // Tabela compartilhada, iniciada no primeiro uso
+
+private:
+    int fd = -1;        // socket NETLINK_CONNECTOR inscrito no grupo CN_IDX_PROC
+    int fdParar = -1;   // eventfd que acorda a thread no destrutor
+    std::thread thread;
+
+    std::mutex trava;   // protege 'processos'
+    std::map<int, std::string> processos; // PID -> comm
+
+    std::atomic<uint64_t> totalEventos{0};
+    std::atomic<uint64_t> totalVarreduras{0};
+    std::atomic<uint64_t> totalEstouros{0};
+
+    bool assinar(bool ativar);     // PROC_CN_MCAST_LISTEN / PROC_CN_MCAST_IGNORE
+    void varrer();                 // refaz a tabela a partir de /proc
+    void executar();               // laço da thread: poll() no socket e aplica os eventos
+    void aplicar(const proc_event &evento);
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+#include "monitor.h"
+#include "cgroup.h"
+#include "memoria.h"
+
+// ---- Campos de /proc/<pid>/stat usados pelo monitor (valores brutos, em ticks) ----
+struct CamposStat {
+    unsigned long minflt; // campo 10: page faults menores
+    unsigned long majflt; // campo 12: page faults maiores
+    unsigned long utime;  // campo 14: tempo em modo usuário (ticks)
+    unsigned long stime;  // campo 15: tempo em modo kernel (ticks)
+    unsigned long long starttime; // campo 22: início do processo (ticks desde o boot), identifica o PID
+};
+
+// ---- Parsers únicos dos arquivos de /proc/<pid> ----
+// Todos recebem o conteúdo já lido (ex.: pela SessaoColeta) e não fazem I/O.
+bool parseStat(std::string_view conteudo, CamposStat &campos);       // stat: utime, stime, minflt, majflt, starttime
+void parseStatus(std::string_view conteudo, StatusProcesso &medicao); // status: Threads, ctxt switches, VmSize/VmRSS/VmSwap
+void parseIO(std::string_view conteudo, StatusProcesso &medicao);     // io: read/write_bytes, syscr/syscw, rchar/wchar
+
+// ---- Campos de /proc/<pid>/schedstat e /proc/<pid>/task/<tid>/schedstat (em ns) ----
+struct CamposSchedstat {
+    uint64_t cpuNs;    // tempo executando na CPU
+    uint64_t esperaNs; // tempo esperando na fila de execução
+    uint64_t fatias;   // nº de vezes que a tarefa foi escalonada
+};
+
+bool parseSchedstat(std::string_view conteudo, CamposSchedstat &campos); // "cpuNs esperaNs fatias"
+void parseSmapsRollup(std::string_view conteudo, MemoriaDetalhada &memoria); // smaps_rollup: Pss, Private_*, Shared_*, SwapPss...
+
+// ---- Parsers dos arquivos de estatística do cgroup v2 ----
+void parseCpuStat(std::string_view conteudo, CpuStatCgroup &cpu);                        // cpu.stat
+size_t parseIoStat(std::string_view conteudo, BlkIOStats *saida, size_t capacidade);    // io.stat, retorna nº de dispositivos
+
+// Lê /proc/<pid>/stat pela sessão e devolve utime/stime em ticks (fallback de lerTempoCPU)
+bool lerTemposStat(int pid, SessaoColeta &sessao, unsigned long &utime, unsigned long &stime);
+
+// ---- Tempo de CPU de um processo em nanossegundos ----
+// utime/stime de stat são contados em ticks (_SC_CLK_TCK, normalmente 10 ms): em intervalos de 250 ms
+// o CPU% oscila vários pontos só por quantização. As fontes abaixo têm resolução de ns.
+enum class FonteCPU {
+    RelogioProcesso, // clock_gettime no relógio de CPU do processo (soma de todas as threads, inclusive encerradas)
+    Schedstat,       // /proc/<pid>/schedstat: só a thread principal, usado se o relógio não estiver acessível
+    Ticks            // utime + stime de /proc/<pid>/stat (fallback)
+};
+
+struct TempoCPU {
+    uint64_t cpuNs;    // tempo total em CPU
+    uint64_t esperaNs; // espera na fila de execução da thread principal (0 sem schedstat)
+    FonteCPU fonte;
+};
+
+// Preenche 'tempo' com a fonte mais precisa disponível; false se nenhuma pôde ser lida.
+// Quem já leu stat pode passar os campos para o fallback não reler o arquivo.
+bool lerTempoCPU(int pid, SessaoColeta &sessao, TempoCPU &tempo, const CamposStat *stat = nullptr);
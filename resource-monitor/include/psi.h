@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <poll.h>
+
+// ---- PSI (Pressure Stall Information): tempo em que tarefas ficaram paradas esperando um recurso ----
+enum class RecursoPSI { CPU = 0, Memoria = 1, IO = 2 };
+
+// Uma linha de um arquivo de pressão ("some" ou "full")
+struct LinhaPSI {
+    double avg10;     // % do tempo com tarefas paradas nos últimos 10 s
+    double avg60;
+    double avg300;
+    uint64_t totalUs; // tempo parado acumulado (µs)
+};
+
+// "some": pelo menos uma tarefa parada; "full": todas as tarefas não ociosas paradas (não existe em cpu do sistema)
+struct PressaoPSI {
+    LinhaPSI some;
+    LinhaPSI full;
+};
+
+const char* nomeRecursoPSI(RecursoPSI recurso); // "cpu", "memory" ou "io" (nome do arquivo)
+
+bool parsePressao(std::string_view conteudo, PressaoPSI &pressao);  // conteúdo de um arquivo *.pressure
+bool lerPressaoSistema(RecursoPSI recurso, PressaoPSI &pressao);    // /proc/pressure/<recurso>
+std::string cgroupDoProcesso(int pid); // caminho do cgroup v2 do processo ("/user.slice/..."), vazio se não houver
+
+// Evento de um gatilho disparado pelo kernel
+struct EventoPSI {
+    int gatilho;           // índice devolvido por adicionarGatilho
+    std::string rotulo;    // descrição do gatilho (ex.: "memory some 150ms/1s em /proc/pressure")
+    PressaoPSI pressao;    // pressão lida logo após o disparo
+    bool removido;         // POLLERR: o cgroup do gatilho foi removido
+};
+
+// Classe MonitorPSI: registra gatilhos de PSI no kernel e espera por eles com poll().
+// Um gatilho "some 150000 1000000" dispara quando as tarefas ficam paradas 150 ms ou mais em uma janela de 1 s,
+// então o monitor pode amostrar com intervalo longo e ainda ser avisado de travamentos curtos, sem sondar.
+class MonitorPSI {
+public:
+    MonitorPSI() = default;
+    ~MonitorPSI();
+
+    // O monitor é dono dos descritores dos gatilhos, então não pode ser copiado
+    MonitorPSI(const MonitorPSI&) = delete;
+    MonitorPSI& operator=(const MonitorPSI&) = delete;
+
+    // Registra um gatilho em um arquivo de pressão (/proc/pressure/<r> ou <cgroup>/<r>.pressure).
+    // A janela deve estar entre 500 ms e 10 s; sem privilégios o kernel só aceita múltiplos de 2 s,
+    // e a janela é arredondada (com o limiar proporcional). Retorna o índice ou -1.
+    int adicionarGatilho(const std::string &arquivo, bool full, uint32_t limiarUs, uint32_t janelaUs);
+
+    // Espera até 'limite' por um disparo; true com o evento preenchido, false quando o prazo acaba.
+    // 'extra' (ex.: o pidfd do processo monitorado) entra no mesmo poll(): quando fica legível,
+    // retorna true com evento.gatilho = -1
+    bool esperarEvento(std::chrono::steady_clock::time_point limite, EventoPSI &evento, int extra = -1);
+
+    size_t totalGatilhos() const { return gatilhos.size(); }
+    void removerTodos();
+
+private:
+    struct Gatilho {
+        int fd;
+        std::string rotulo;
+    };
+    std::vector<Gatilho> gatilhos;
+    std::vector<pollfd> descritores; // mesma ordem de 'gatilhos', reaproveitado no poll()
+
+    bool aguardarDisparo(std::chrono::steady_clock::time_point limite, EventoPSI &evento); // laço do poll()
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+// ---- Backends de coleta das filas de socket usados pelo coletorNetwork ----
+enum class BackendRede {
+    TextoProc, // lê e tokeniza /proc/net/{tcp,tcp6,udp,udp6}
+    SockDiag   // consulta NETLINK_SOCK_DIAG (inet_diag) e recebe as filas em binário
+};
+
+// Filas de um socket (em bytes), como aparecem em tx_queue:rx_queue de /proc/net/tcp
+struct FilasSocket {
+    unsigned long rx; // bytes na fila de recepção
+    unsigned long tx; // bytes na fila de transmissão
+};
+
+// Tabela inode do socket -> filas, em um mapa plano de endereçamento aberto (sondagem linear).
+// As entradas ficam em um único vetor contíguo e a capacidade é mantida entre as atualizações,
+// então reconstruir a tabela a cada tick não aloca memória depois que ela atinge o tamanho do host.
+class TabelaSockets {
+public:
+    void limpar();                                            // esvazia mantendo a capacidade
+    void inserir(unsigned long inode, const FilasSocket &f);  // insere ou sobrescreve (inode != 0)
+    const FilasSocket* buscar(unsigned long inode) const;     // nullptr se o inode não está na tabela
+    size_t tamanho() const { return ocupadas; }
+
+private:
+    // inode 0 nunca é um socket válido, então marca slot vazio
+    struct Entrada {
+        unsigned long inode = 0;
+        FilasSocket filas{};
+    };
+
+    std::vector<Entrada> entradas; // capacidade sempre potência de 2
+    size_t ocupadas = 0;
+
+    size_t posicao(unsigned long inode) const; // hash multiplicativo -> slot inicial
+    void crescer();                            // dobra a capacidade e reinsere
+};
+
+void definirBackendRede(BackendRede backend); // troca o backend em tempo de execução
+BackendRede backendRedeAtual();               // backend usado pelo coletorNetwork
+const char* nomeBackendRede(BackendRede backend);
+
+// Preenchem a tabela com todos os sockets TCP/UDP (IPv4 e IPv6) de um namespace de rede.
+// O texto lê /proc/<pid>/net/* (pid 0 = namespace do monitor); o sock_diag só enxerga o namespace do monitor.
+bool lerTabelaSocketsTexto(TabelaSockets &tabela, int pid = 0);
+bool lerTabelaSocketsDiag(TabelaSockets &tabela);
+
+// Classe CacheSockets: guarda uma tabela de sockets por namespace de rede (chave = inode de /proc/<pid>/ns/net).
+// A tabela é reconstruída no máximo uma vez por tick (ou quando o TTL expira) e compartilhada por todos os
+// PIDs amostrados nesse tick, então N processos custam uma leitura das tabelas do host + N buscas.
+// Pode ser consultada por vários workers ao mesmo tempo: o primeiro a pedir um namespace no tick monta a tabela
+// e os demais esperam; as tabelas só são remontadas no tick seguinte, então os ponteiros valem até lá.
+class CacheSockets {
+public:
+    void novoTick(); // chamado pelo laço de amostragem antes de coletar os PIDs do tick
+    void definirTTL(std::chrono::milliseconds ttl); // 0 = reconstruir a cada tick; > 0 reaproveita entre ticks
+    void invalidar(); // força a reconstrução na próxima consulta (ex.: troca de backend)
+
+    // Tabela do namespace de rede do PID, atualizada se necessário; nullptr se o namespace não pôde ser lido
+    const TabelaSockets* obter(int pid);
+
+    static CacheSockets& padrao(); // cache usado pelo coletorNetwork
+
+private:
+    struct EntradaNetns {
+        TabelaSockets tabela;
+        uint64_t tick = 0; // tick em que a tabela foi montada
+        std::chrono::steady_clock::time_point atualizadoEm{};
+        bool valida = false;
+    };
+
+    std::unordered_map<unsigned long, EntradaNetns> porNetns; // inode do netns -> tabela
+    uint64_t tickAtual = 1;
+    std::chrono::milliseconds ttl{ 0 };
+    unsigned long netnsProprio = 0; // netns do monitor, único consultável pelo sock_diag
+    std::mutex trava;               // protege o mapa e a montagem (buffers e socket netlink são compartilhados)
+
+    bool atualizar(int pid, unsigned long netns, TabelaSockets &tabela);
+};
+
+// Classe RastreadorFds: lista os inodes dos sockets abertos por um processo de forma incremental.
+// Mantém /proc/<pid>/fd aberto, relê as entradas com getdents64 e guarda o mapeamento fd -> inode do socket.
+// A classificação de cada fd (socket ou não) é guardada por (fd, d_ino) e só o fd novo é lido com readlinkat.
+// O d_ino vem do número do fd, então não detecta um fd fechado e reaberto: revalidar() relê uma vez os sockets
+// que não estão na tabela de sockets (e marca os que ela não cobre, como Unix e netlink), e a cada
+// 'intervaloResync' amostras todos os links são relidos (fd que deixou de ser ou passou a ser socket, ou socket
+// reutilizado que continua aberto em outro processo e por isso segue na tabela).
+class RastreadorFds {
+public:
+    RastreadorFds() = default;
+    ~RastreadorFds();
+
+    // O rastreador é dono dos descritores de diretório, então não pode ser copiado
+    RastreadorFds(const RastreadorFds&) = delete;
+    RastreadorFds& operator=(const RastreadorFds&) = delete;
+
+    // Preenche 'inodes' com os sockets abertos pelo PID; false se /proc/<pid>/fd não pôde ser lido
+    bool listarSockets(int pid, std::vector<unsigned long> &inodes);
+
+    // Relê os fds da última listagem cujo socket em cache não está na tabela e refaz 'inodes'
+    void revalidar(int pid, const TabelaSockets &tabela, std::vector<unsigned long> &inodes);
+
+    void liberar(int pid);                       // Fecha o diretório e descarta o estado de um PID
+    void definirResync(unsigned amostras);       // 0 desativa a ressincronização periódica
+    size_t ultimosReadlinks() const { return readlinksUltimaAmostra; } // readlinkat feitos na última amostra
+
+    static RastreadorFds& padrao(); // Rastreador usado quando o chamador não informa um
+
+private:
+    // Estado de um número de fd; indexado pelo próprio fd (os números são pequenos e densos)
+    struct EntradaFd {
+        uint64_t dIno = 0;            // d_ino da entrada em /proc/<pid>/fd (0 = fd não aberto; não muda se o fd for reutilizado)
+        unsigned long socket = 0;     // inode do socket ou 0 se o fd não é socket
+        uint32_t visto = 0;           // número da última varredura em que o fd apareceu
+        bool foraDaTabela = false;    // socket que a tabela não cobre (Unix, netlink): não é relido até o resync
+    };
+
+    struct EstadoPid {
+        int dirfd = -1;
+        std::vector<EntradaFd> fds;
+        uint32_t varredura = 0;       // contador de varreduras (marca os fds vistos)
+    };
+
+    std::unordered_map<int, EstadoPid> estados; // PID -> estado
+    std::vector<char> bufferDirent;             // buffer reutilizável do getdents64
+    unsigned intervaloResync = 64;
+    size_t readlinksUltimaAmostra = 0;
+};
+
+// Lista os inodes dos sockets com um readlink por fd (varredura completa, sem estado)
+void listarInodesSockets(int pid, std::vector<unsigned long> &inodes);
+
+void benchmarkRede(); // Experimento nº7: compara o custo dos dois backends e do cache
@@ -0,0 +1,133 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "monitor.h"
+
+// ---- Série temporal binária em colunas (arquivos .rmts) ----
+// Layout (little-endian, como a máquina que grava):
+//   CabecalhoSerie | bloco 0 | bloco 1 | ... | índice (EntradaIndiceSerie x N) | RodapeSerie
+// Cada bloco guarda até 'amostrasPorBloco' amostras, coluna por coluna:
+//   - instante (ms): primeiro no cabeçalho do bloco, depois delta-of-delta em varint zigzag (1 byte a 1 Hz estável)
+//   - contadores inteiros e tempos de CPU (em ns): delta para a amostra anterior em varint zigzag
+//   - taxas de calculoMedicao (double): XOR com o valor anterior, só os bits significativos (Gorilla)
+// O índice só é gravado ao fechar; se o monitor morrer antes, o leitor reconstrói o índice percorrendo
+// os cabeçalhos dos blocos (cada bloco tem tamanho e soma de verificação próprios).
+
+struct CabecalhoSerie {
+    uint32_t magica;           // "RMTS"
+    uint16_t versao;
+    uint16_t colunas;          // colunas por amostra (conferido na leitura)
+    uint32_t amostrasPorBloco;
+    uint32_t reservado;
+};
+
+struct CabecalhoBlocoSerie {
+    uint32_t magica;           // "RMB1"
+    int32_t pid;
+    uint32_t amostras;
+    uint32_t bytes;            // tamanho dos dados codificados que seguem o cabeçalho
+    int64_t primeiroMs;        // instante (CLOCK_REALTIME, ms) da primeira amostra
+    int64_t ultimoMs;          // instante da última amostra
+    uint32_t verificacao;      // FNV-1a dos dados do bloco
+    uint32_t reservado;
+};
+
+struct EntradaIndiceSerie {
+    int64_t primeiroMs;
+    int64_t ultimoMs;
+    uint64_t offset;           // posição do CabecalhoBlocoSerie no arquivo
+    uint32_t amostras;
+    uint32_t bytes;            // cabeçalho + dados
+};
+
+struct RodapeSerie {
+    uint64_t offsetIndice;
+    uint32_t blocos;
+    uint32_t magica;           // "RMTI"
+};
+
+// Uma amostra decodificada
+struct AmostraSerie {
+    int64_t instanteMs;        // CLOCK_REALTIME em ms (o CSV mostra em segundos UTC)
+    StatusProcesso medicao;    // medicao.instanteNs não é gravado (relógio monotônico só vale na sessão)
+    calculoMedicao calculado;
+};
+
+int64_t instanteRealMs(); // CLOCK_REALTIME em ms
+
+// Classe EscritorSerie: acumula as amostras de um bloco em memória e grava o bloco codificado com um
+// único write() quando ele enche (256 amostras = ~4 min a 1 Hz). Um arquivo existente é continuado:
+// o índice antigo é lido e truncado, e os blocos novos entram no fim.
+class EscritorSerie {
+public:
+    explicit EscritorSerie(std::string caminho, uint32_t amostrasPorBloco = 256);
+    ~EscritorSerie(); // grava o bloco parcial e o índice
+
+    // O escritor é dono do arquivo, então não pode ser copiado
+    EscritorSerie(const EscritorSerie&) = delete;
+    EscritorSerie& operator=(const EscritorSerie&) = delete;
+
+    bool valido() const { return fd >= 0; }
+    bool adicionar(int64_t instanteMs, const StatusProcesso &medicao, const calculoMedicao &calculado);
+    bool fechar(); // bloco parcial + índice + rodapé; chamado pelo destrutor
+
+    uint64_t amostrasGravadas() const { return totalAmostras; }
+    uint64_t bytesArquivo() const { return tamanho; }
+    size_t blocos() const { return indice.size(); }
+    const std::string& arquivo() const { return caminho; }
+
+    void imprimirResumo(); // grava o bloco parcial e mostra amostras, blocos e bytes por amostra
+
+private:
+    std::string caminho;
+    int fd = -1;
+    uint32_t porBloco;
+    uint64_t tamanho = 0;      // fim dos dados (onde o próximo bloco entra)
+    uint64_t totalAmostras = 0;
+    std::vector<AmostraSerie> pendentes;
+    std::vector<EntradaIndiceSerie> indice;
+    std::vector<uint8_t> codificado; // buffer reutilizado na codificação
+
+    bool gravarBloco();
+};
+
+// Classe LeitorSerie: abre um .rmts, carrega (ou reconstrói) o índice e decodifica blocos sob demanda
+class LeitorSerie {
+public:
+    LeitorSerie() = default;
+    ~LeitorSerie();
+
+    // O leitor é dono do descritor, então não pode ser copiado
+    LeitorSerie(const LeitorSerie&) = delete;
+    LeitorSerie& operator=(const LeitorSerie&) = delete;
+
+    bool abrir(const std::string &caminho);
+    void fechar();
+
+    const std::vector<EntradaIndiceSerie>& blocos() const { return indice; }
+    uint64_t fimDados() const { return fim; }     // fim do último bloco válido
+    bool indiceReconstruido() const { return reconstruido; } // arquivo sem rodapé (escritor interrompido)
+    uint64_t totalAmostras() const;
+
+    // Bloco que contém 'instanteMs' (ou o primeiro depois dele); blocos().size() se não houver
+    size_t buscar(int64_t instanteMs) const;
+
+    // Decodifica o bloco i em 'amostras' (substitui o conteúdo); false se o bloco estiver corrompido
+    bool lerBloco(size_t i, std::vector<AmostraSerie> &amostras);
+
+private:
+    int fd = -1;
+    CabecalhoSerie cabecalho{};
+    std::vector<EntradaIndiceSerie> indice;
+    uint64_t fim = 0;
+    bool reconstruido = false;
+    std::vector<uint8_t> dados;
+
+    bool lerIndice(uint64_t tamanhoArquivo);
+    void reconstruirIndice(uint64_t tamanhoArquivo);
+};
+
+// Converte um .rmts inteiro para o mesmo CSV do perfilador; false se a entrada não pôde ser lida
+bool converterSerieParaCSV(const std::string &entrada, const std::string &saida);
@@ -0,0 +1,50 @@
+#pragma once
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <array>
+
+// Arquivos de /proc/<pid> que a sessão mantém abertos entre as coletas
+enum class ArquivoProc {
+    Stat = 0,   // /proc/<pid>/stat
+    Status = 1, // /proc/<pid>/status
+    IO = 2,     // /proc/<pid>/io
+    SmapsRollup = 3, // /proc/<pid>/smaps_rollup (aberto só se o coletor de PSS/USS for usado)
+    Schedstat = 4    // /proc/<pid>/schedstat (tempo em CPU e espera na fila, em ns)
+};
+
+// Classe SessaoColeta: mantém os descritores de /proc/<pid> abertos durante toda a amostragem.
+// A cada tick o conteúdo é relido com pread(fd, buf, n, 0) em um buffer reutilizável,
+// evitando montar o caminho, abrir e fechar o arquivo a cada coleta.
+class SessaoColeta {
+public:
+    SessaoColeta();
+    ~SessaoColeta();
+
+    // A sessão é dona dos descritores, então não pode ser copiada
+    SessaoColeta(const SessaoColeta&) = delete;
+    SessaoColeta& operator=(const SessaoColeta&) = delete;
+
+    // Relê o arquivo do PID e aponta 'conteudo' para o buffer interno.
+    // A view é válida até a próxima leitura do mesmo tipo de arquivo.
+    bool ler(int pid, ArquivoProc arquivo, std::string_view& conteudo);
+
+    void liberar(int pid); // Fecha os descritores de um PID (ex.: processo encerrou)
+    void liberarTodos();   // Fecha todos os descritores abertos
+
+    static SessaoColeta& padrao(); // Sessão usada quando o chamador não informa uma
+
+private:
+    static constexpr size_t NUM_ARQUIVOS = 5; // stat, status, io, smaps_rollup e schedstat
+
+    // Descritores de um PID; -1 indica arquivo ainda não aberto
+    struct Descritores {
+        std::array<int, NUM_ARQUIVOS> fd{ -1, -1, -1, -1, -1 };
+    };
+
+    std::unordered_map<int, Descritores> abertos;              // PID -> descritores abertos
+    std::array<std::vector<char>, NUM_ARQUIVOS> buffers;       // um buffer reutilizável por tipo de arquivo
+
+    int abrir(int pid, ArquivoProc arquivo); // Abre /proc/<pid>/<arquivo> e retorna o fd (ou -1)
+    bool lerDescritor(int fd, std::vector<char>& buffer, size_t& tamanho); // pread a partir do offset 0
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ---- Sketch de quantis mesclável (DDSketch) ----
+// Cada valor positivo cai no bucket i = ceil(log_gamma(v)), com gamma = (1 + ALFA) / (1 - ALFA): qualquer
+// quantil estimado fica a no máximo ALFA (1%) do valor real, relativo. Os buckets são um vetor fixo (sem
+// alocação ao adicionar), e dois sketches se mesclam somando bucket a bucket, então os sketches de cada
+// janela de 1 s podem ser combinados no de toda a execução sem perder precisão.
+// A unidade é do chamador (ns nas latências do Experimento 5); valores até 1 caem no bucket 0.
+
+// Cabeçalho do sketch serializado; seguem 'buckets' entradas BucketSketch (só os buckets não vazios)
+struct CabecalhoSketch {
+    uint64_t contagem;
+    uint32_t buckets;
+    uint32_t reservado;
+    double minimo;
+    double maximo;
+    double soma;
+};
+
+struct BucketSketch {
+    uint32_t indice;
+    uint32_t contagem; // um sketch serializado cobre uma janela curta: 32 bits bastam
+};
+
+class SketchQuantis {
+public:
+    static constexpr double ALFA = 0.01;         // erro relativo máximo dos quantis
+    static constexpr uint32_t NUM_BUCKETS = 1536; // gamma^1535 ~ 2,2e13 (6 h em ns); acima disso, último bucket
+
+    SketchQuantis() { limpar(); }
+
+    void adicionar(double valor);              // O(1), sem alocação
+    void mesclar(const SketchQuantis &outro);  // soma bucket a bucket (mesmo ALFA nos dois lados)
+    void limpar();
+
+    uint64_t contagem() const { return total; }
+    double minimo() const { return total ? menor : 0; }
+    double maximo() const { return total ? maior : 0; }
+    double media() const { return total ? soma / static_cast<double>(total) : 0; }
+    double quantil(double q) const;            // q em [0, 1]; 0 se vazio
+
+    // Serialização para o pipe: CabecalhoSketch + buckets não vazios. Devolve os bytes escritos
+    // (0 se 'capacidade' não couber); TAMANHO_MAXIMO_SERIALIZADO sempre cabe
+    static constexpr size_t TAMANHO_MAXIMO_SERIALIZADO = sizeof(CabecalhoSketch) + NUM_BUCKETS * sizeof(BucketSketch);
+    size_t serializar(uint8_t *destino, size_t capacidade) const;
+    bool desserializar(const uint8_t *origem, size_t tamanho); // false se o conteúdo não é um sketch válido
+
+private:
+    uint64_t contagens[NUM_BUCKETS];
+    uint64_t total;
+    double menor, maior, soma;
+};
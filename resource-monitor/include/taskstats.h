@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "monitor.h"
+
+struct taskstats; // <linux/taskstats.h>, incluído só em src/taskstats_collector.cpp
+
+// ---- Delay accounting do kernel (totais acumulados desde o início da tarefa) ----
+// Os atrasos separam falta de CPU (espera na fila de execução) de bloqueio em I/O ou memória.
+// blkio/swapin/freepages só são contabilizados com delay accounting ativo (sysctl kernel.task_delayacct=1).
+struct AtrasosProcesso {
+    uint64_t cpuTotalNs;         // tempo em CPU (sum_exec_runtime), em ns
+    uint64_t cpuEsperaNs;        // tempo esperando CPU na fila de execução
+    uint64_t cpuEsperaQtd;       // nº de esperas por CPU
+    uint64_t blkioEsperaNs;      // tempo bloqueado em I/O de bloco síncrono
+    uint64_t blkioEsperaQtd;
+    uint64_t swapinEsperaNs;     // tempo esperando swap-in de páginas
+    uint64_t swapinEsperaQtd;
+    uint64_t freepagesEsperaNs;  // tempo em recuperação de memória (direct reclaim)
+    uint64_t freepagesEsperaQtd;
+};
+
+// Classe ColetorTaskstats: consulta a interface TASKSTATS (generic netlink) do kernel.
+// Uma única mensagem binária traz CPU, I/O, page faults, context switches e os atrasos da tarefa.
+// O socket e o id da família são obtidos na primeira consulta e reaproveitados.
+class ColetorTaskstats {
+public:
+    ColetorTaskstats() = default;
+    ~ColetorTaskstats();
+
+    // O coletor é dono do socket netlink, então não pode ser copiado
+    ColetorTaskstats(const ColetorTaskstats&) = delete;
+    ColetorTaskstats& operator=(const ColetorTaskstats&) = delete;
+
+    bool disponivel(); // false se o kernel não tem TASKSTATS ou falta CAP_NET_ADMIN
+
+    // Por tarefa (TASKSTATS_CMD_ATTR_PID): utime/stime, faults, rchar/wchar, syscalls, bytes de disco,
+    // context switches e atrasos de uma única thread (para o líder, a thread principal)
+    bool coletarTarefa(int tid, StatusProcesso &medicao, AtrasosProcesso &atrasos);
+
+    // Por processo (TASKSTATS_CMD_ATTR_TGID): o kernel soma apenas o tempo em CPU (utime/stime, em µs),
+    // os atrasos e os context switches de todas as threads. Preenche utime/stime/tempoCPU/esperaCPU e os
+    // atrasos; memória, I/O, faults e os context switches (da thread principal) continuam vindo de /proc
+    bool coletarGrupo(int tgid, StatusProcesso &medicao, AtrasosProcesso &atrasos);
+
+    static ColetorTaskstats& padrao(); // Coletor usado quando o chamador não informa um
+
+private:
+    int fd = -1;
+    uint16_t familia = 0;  // id dinâmico da família "TASKSTATS"
+    bool tentouAbrir = false;
+    uint32_t sequencia = 0;
+    std::vector<char> buffer; // resposta do kernel, reutilizada entre consultas
+
+    bool abrir();
+    bool consultar(uint16_t comando, uint32_t id, taskstats &saida); // envia o pedido e extrai a struct taskstats
+};
+
+// Preenche o tempo em CPU e os atrasos do processo via TASKSTATS (por TGID).
+// Retorna false se a interface não está disponível; aí o tempo em CPU também vem de /proc (schedstat).
+bool coletorTaskstats(StatusProcesso &medicao, AtrasosProcesso &atrasos, ColetorTaskstats &coletor = ColetorTaskstats::padrao());
+
+void benchmarkTaskstats(); // Experimento nº8: uma consulta netlink x leitura de stat/status/io
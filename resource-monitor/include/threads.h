@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+
+// Métricas de uma thread entre dois ticks
+struct MetricasThread {
+    int tid;
+    char nome[16];        // comm da thread (até 15 caracteres, como no kernel)
+    double usoCPU;        // % de um core
+    double esperaMsPorS;  // ms esperando na fila de execução por segundo
+    double trocasPorS;    // vezes escalonada por segundo (schedstat)
+};
+
+// Classe ColetorThreads: amostra todas as threads de um processo a cada tick.
+// O diretório /proc/<pid>/task fica aberto e é relido com getdents64; os arquivos stat e schedstat de
+// cada thread são abertos com openat uma única vez e relidos com pread nos ticks seguintes.
+class ColetorThreads {
+public:
+    ColetorThreads() = default;
+    ~ColetorThreads();
+
+    // O coletor é dono dos descritores, então não pode ser copiado
+    ColetorThreads(const ColetorThreads&) = delete;
+    ColetorThreads& operator=(const ColetorThreads&) = delete;
+
+    // Relê todas as threads do PID e calcula as métricas desde o tick anterior.
+    // Na primeira amostra (ou de uma thread nova) não há delta e as métricas ficam zeradas.
+    bool coletar(int pid);
+
+    // As K threads com maior uso de CPU, em ordem decrescente (seleção parcial com nth_element)
+    const std::vector<MetricasThread>& threadsQuentes(size_t k);
+
+    size_t totalThreads() const { return metricas.size(); }
+    void liberar(); // fecha todos os descritores (ex.: troca de PID)
+
+private:
+    struct EstadoThread {
+        int fdStat = -1;
+        int fdSchedstat = -1;
+        uint64_t ticks = 0;      // utime + stime
+        uint64_t cpuNs = 0;
+        uint64_t esperaNs = 0;
+        uint64_t fatias = 0;
+        unsigned long long starttime = 0; // identifica a thread: um TID reutilizado tem outro starttime
+        uint32_t visto = 0;      // nº da última varredura em que a thread apareceu
+        bool temAnterior = false;
+        bool persistente = false; // fds mantidos abertos entre ticks
+    };
+
+    // Acima deste nº de threads os arquivos passam a ser abertos e fechados a cada tick,
+    // para não esgotar o limite de descritores (RLIMIT_NOFILE) em processos com milhares de threads
+    static constexpr size_t MAX_THREADS_PERSISTENTES = 256;
+    size_t persistentes = 0;
+
+    int pidAtual = -1;
+    int dirTask = -1;                                  // /proc/<pid>/task
+    uint32_t varredura = 0;
+    std::chrono::steady_clock::time_point ultimaColeta{};
+    std::unordered_map<int, EstadoThread> estados;     // TID -> estado (da thread com o starttime guardado)
+    std::vector<MetricasThread> metricas;              // métricas do último tick (todas as threads)
+    std::vector<MetricasThread> quentes;               // top-K do último pedido
+    std::vector<char> bufferDirent;
+
+    void fecharThread(EstadoThread &estado);
+};
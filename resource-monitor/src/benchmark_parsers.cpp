@@ -0,0 +1,214 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <unistd.h>
+#include "monitor.h"
+#include "procfs.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc para contar ciclos
+#endif
+
+// ---- Parsers antigos (copiados da versão com istringstream/sscanf) usados como referência ----
+
+// Versão antiga do lerCPU: divide a linha inteira de stat em um vector<string>
+static std::pair<unsigned long, unsigned long> legadoStatVetor(const std::string& linha) {
+    std::istringstream iss(linha);
+    std::vector<std::string> campos;
+    std::string campo;
+    while (iss >> campo)
+        campos.push_back(campo);
+    return { std::stoul(campos[13]), std::stoul(campos[14]) };
+}
+
+// Versão antiga de coletorCPU/coletorMemoria para stat: istringstream depois do ')'
+static void legadoStat(const std::string& conteudo, CamposStat& campos) {
+    std::string depois = conteudo.substr(conteudo.rfind(')') + 1);
+    std::istringstream fluxo(depois);
+    std::string iterador;
+    for (int i = 1; i <= 7; ++i)
+        fluxo >> iterador;
+    fluxo >> campos.minflt >> iterador >> campos.majflt >> iterador >> campos.utime >> campos.stime;
+}
+
+// Versão antiga de status: getline + rfind(...,0) + sscanf
+static void legadoStatus(const std::string& conteudo, StatusProcesso& medicao) {
+    std::istringstream fluxo(conteudo);
+    std::string linha;
+    while (std::getline(fluxo, linha)) {
+        if (linha.rfind("voluntary_ctxt_switches:", 0) == 0)
+            sscanf(linha.c_str(), "voluntary_ctxt_switches: %u", &medicao.contextSwitchfree);
+        else if (linha.rfind("nonvoluntary_ctxt_switches:", 0) == 0)
+            sscanf(linha.c_str(), "nonvoluntary_ctxt_switches: %u", &medicao.contextSwitchforced);
+        else if (linha.rfind("Threads:", 0) == 0)
+            sscanf(linha.c_str(), "Threads: %u", &medicao.threads);
+        else if (linha.rfind("VmSize:", 0) == 0)
+            sscanf(linha.c_str(), "VmSize: %lu", &medicao.vmSize);
+        else if (linha.rfind("VmSwap:", 0) == 0)
+            sscanf(linha.c_str(), "VmSwap: %lu", &medicao.vmSwap);
+        else if (linha.rfind("VmRSS:", 0) == 0)
+            sscanf(linha.c_str(), "VmRSS: %lu", &medicao.vmRss);
+    }
+}
+
+// Versão antiga de io: getline + rfind(...,0) + sscanf
+static void legadoIO(const std::string& conteudo, StatusProcesso& medicao) {
+    std::istringstream fluxo(conteudo);
+    std::string linha;
+    while (std::getline(fluxo, linha)) {
+        if (linha.rfind("read_bytes:", 0) == 0)
+            sscanf(linha.c_str(), "read_bytes: %lu", &medicao.bytesLidos);
+        else if (linha.rfind("write_bytes:", 0) == 0)
+            sscanf(linha.c_str(), "write_bytes: %lu", &medicao.bytesEscritos);
+        else if (linha.rfind("syscr:", 0) == 0)
+            sscanf(linha.c_str(), "syscr: %lu", &medicao.syscallLeitura);
+        else if (linha.rfind("syscw:", 0) == 0)
+            sscanf(linha.c_str(), "syscw: %lu", &medicao.syscallEscrita);
+        else if (linha.rfind("rchar:", 0) == 0)
+            sscanf(linha.c_str(), "rchar: %lu", &medicao.rchar);
+        else if (linha.rfind("wchar:", 0) == 0)
+            sscanf(linha.c_str(), "wchar: %lu", &medicao.wchar);
+    }
+}
+
+// Versão antiga de readCpuUsage: istringstream por linha para um std::map
+static std::map<std::string, double> legadoCpuStat(const std::string& conteudo) {
+    std::istringstream f(conteudo);
+    std::map<std::string, double> stats;
+    std::string line;
+    while (std::getline(f, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        double value;
+        if (iss >> key >> value) stats[key] = value;
+    }
+    return stats;
+}
+
+// Versão antiga de readBlkIOUsage: istringstream + substr + stoull por par chave=valor
+static std::vector<BlkIOStats> legadoIoStat(const std::string& conteudo) {
+    std::istringstream f(conteudo);
+    std::vector<BlkIOStats> list;
+    std::string line;
+    while (std::getline(f, line)) {
+        std::istringstream iss(line);
+        BlkIOStats s{};
+        std::string device, kv;
+        iss >> device;
+        auto colon = device.find(':');
+        if (colon != std::string::npos) {
+            s.major = std::stoul(device.substr(0, colon));
+            s.minor = std::stoul(device.substr(colon + 1));
+        }
+        while (iss >> kv) {
+            auto pos = kv.find('=');
+            if (pos == std::string::npos) continue;
+            std::string key = kv.substr(0, pos);
+            uint64_t val = std::stoull(kv.substr(pos + 1));
+            if (key == "rbytes") s.rbytes = val;
+            else if (key == "wbytes") s.wbytes = val;
+            else if (key == "rios") s.rios = val;
+            else if (key == "wios") s.wios = val;
+            else if (key == "dbytes") s.dbytes = val;
+            else if (key == "dios") s.dios = val;
+        }
+        list.push_back(s);
+    }
+    return list;
+}
+
+// ---- Medição ----
+
+// Contador de ciclos: TSC em x86; nos demais usa nanossegundos do steady_clock
+static inline uint64_t contadorCiclos() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Executa 'funcao' N vezes e devolve ciclos médios por parse
+template <typename F>
+static double medirCiclos(F&& funcao, int repeticoes) {
+    for (int i = 0; i < repeticoes / 10; ++i) funcao(); // aquecimento (caches e branch predictor)
+
+    uint64_t inicio = contadorCiclos();
+    for (int i = 0; i < repeticoes; ++i) funcao();
+    uint64_t fim = contadorCiclos();
+    return static_cast<double>(fim - inicio) / repeticoes;
+}
+
+// Imprime uma linha da tabela comparativa
+static void imprimirLinha(const char* arquivo, double legado, double novo) {
+    std::cout << " " << std::left << std::setw(22) << arquivo
+        << std::right << std::setw(14) << std::fixed << std::setprecision(0) << legado
+        << std::setw(14) << novo
+        << std::setw(11) << std::setprecision(1) << (novo > 0 ? legado / novo : 0.0) << "x\n";
+}
+
+// Lê um arquivo de /proc do próprio processo para uma string (apenas para montar as amostras)
+static std::string lerAmostra(ArquivoProc arquivo) {
+    std::string_view conteudo;
+    SessaoColeta sessao;
+    sessao.ler(getpid(), arquivo, conteudo);
+    return std::string(conteudo);
+}
+
+void benchmarkParsers() {
+    const int repeticoes = 200000;
+
+    std::cout << "\n\033[1;33m========== Experimento nº6 - Benchmark dos parsers de /proc ==========\033[0m\n";
+#if defined(__x86_64__) || defined(__i386__)
+    std::cout << " Unidade: ciclos (TSC) por parse, média de " << repeticoes << " repetições\n\n";
+#else
+    std::cout << " Unidade: ns por parse, média de " << repeticoes << " repetições\n\n";
+#endif
+
+    // Amostras reais do próprio monitor e amostras típicas de cgroup v2
+    const std::string stat = lerAmostra(ArquivoProc::Stat);
+    const std::string status = lerAmostra(ArquivoProc::Status);
+    const std::string io = lerAmostra(ArquivoProc::IO);
+    const std::string cpuStat =
+        "usage_usec 81839237\nuser_usec 61273456\nsystem_usec 20565781\ncore_sched.force_idle_usec 0\n"
+        "nr_periods 5120\nnr_throttled 1021\nthrottled_usec 40321987\nnr_bursts 0\nburst_usec 0\n";
+    const std::string ioStat =
+        "8:0 rbytes=1459200 wbytes=314773504 rios=192 wios=353 dbytes=0 dios=0\n"
+        "259:0 rbytes=90112 wbytes=2048000 rios=22 wios=500 dbytes=4096 dios=1\n";
+
+    StatusProcesso medicao{};
+    CamposStat campos{};
+    CpuStatCgroup cpu{};
+    BlkIOStats dispositivos[8];
+    volatile unsigned long sumidouro = 0; // impede que o compilador descarte os resultados
+
+    std::cout << " " << std::left << std::setw(22) << "Arquivo"
+        << std::right << std::setw(14) << "antigo" << std::setw(14) << "novo" << std::setw(12) << "ganho\n";
+    std::cout << " " << std::string(61, '-') << "\n";
+
+    imprimirLinha("stat (lerCPU vetor)",
+        medirCiclos([&] { sumidouro = sumidouro + legadoStatVetor(stat).first; }, repeticoes),
+        medirCiclos([&] { parseStat(stat, campos); sumidouro = sumidouro + campos.utime; }, repeticoes));
+    imprimirLinha("stat",
+        medirCiclos([&] { legadoStat(stat, campos); sumidouro = sumidouro + campos.utime; }, repeticoes),
+        medirCiclos([&] { parseStat(stat, campos); sumidouro = sumidouro + campos.utime; }, repeticoes));
+    imprimirLinha("status",
+        medirCiclos([&] { legadoStatus(status, medicao); sumidouro = sumidouro + medicao.vmRss; }, repeticoes),
+        medirCiclos([&] { parseStatus(status, medicao); sumidouro = sumidouro + medicao.vmRss; }, repeticoes));
+    imprimirLinha("io",
+        medirCiclos([&] { legadoIO(io, medicao); sumidouro = sumidouro + medicao.rchar; }, repeticoes),
+        medirCiclos([&] { parseIO(io, medicao); sumidouro = sumidouro + medicao.rchar; }, repeticoes));
+    imprimirLinha("cpu.stat (cgroup)",
+        medirCiclos([&] { sumidouro = sumidouro + legadoCpuStat(cpuStat).size(); }, repeticoes),
+        medirCiclos([&] { parseCpuStat(cpuStat, cpu); sumidouro = sumidouro + cpu.usageUsec; }, repeticoes));
+    imprimirLinha("io.stat (cgroup)",
+        medirCiclos([&] { sumidouro = sumidouro + legadoIoStat(ioStat).size(); }, repeticoes),
+        medirCiclos([&] { sumidouro = sumidouro + parseIoStat(ioStat, dispositivos, 8); }, repeticoes));
+
+    std::cout << "\n Os parsers novos trabalham sobre std::string_view com std::from_chars e não alocam memória.\n";
+}
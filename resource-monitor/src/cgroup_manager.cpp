@@ -1,4 +1,6 @@
 #include "cgroup.h"               // Cabeçalho da classe CGroupManager (declarações de métodos e structs).
+#include "procfs.h"               // lerTempoCPU, parseCpuStat, parseIoStat: parsers compartilhados.
+#include "parse.h"                // proximaLinha/proximoToken: tokenização sem alocação.
 #include <fstream>                // std::ifstream / std::ofstream para leitura/escrita em arquivos.
 #include <filesystem>             // std::filesystem para manipulação de paths e diretórios.
 #include <iostream>               // std::cout / std::cerr para saída no terminal.
@@ -13,6 +15,9 @@
 #include <sys/wait.h>             // waitpid, macros WIFEXITED, etc.
 #include <signal.h>               // kill, sinais (SIGKILL, etc.).
 #include <cmath>
+#include <algorithm>              // std::count (linhas do io.stat).
+#include <cerrno>                 // errno (EINTR na leitura dos arquivos do cgroup).
+#include <fcntl.h>                // open() para ler os arquivos do cgroup sem ifstream.
 
 namespace fs = std::filesystem; // Cria um alias `fs` para `std::filesystem`
 
@@ -143,16 +148,42 @@ bool CGroupManager::setMemoryLimit(const std::string& name, size_t bytes) {
     return true; // Limite aplicado com sucesso.
 }
 
+// Lê um arquivo do cgroup inteiro (sem ifstream) para um buffer reaproveitado por thread. Como na SessaoColeta,
+// se a leitura enche o buffer o arquivo pode ser maior: o buffer dobra e o arquivo é relido do início, então
+// nenhuma linha chega cortada ao parser. 'conteudo' vale até a próxima leitura na mesma thread.
+static bool lerArquivoCgroup(const std::string& path, std::string_view& conteudo) {
+    thread_local std::vector<char> buffer(4096);
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false; // arquivo inexistente ou sem permissão
+
+    while (true) {
+        ssize_t lidos = pread(fd, buffer.data(), buffer.size(), 0); // kernfs regenera o conteúdo no offset 0
+        if (lidos < 0) {
+            if (errno == EINTR) continue; // interrompido por sinal, tenta de novo
+            close(fd);
+            return false;
+        }
+        if (static_cast<size_t>(lidos) == buffer.size()) { // buffer cheio: dobra e relê
+            buffer.resize(buffer.size() * 2);
+            continue;
+        }
+        close(fd);
+        conteudo = std::string_view(buffer.data(), static_cast<size_t>(lidos));
+        return true;
+    }
+}
+
 // Lê o arquivo cpu.stat e retorna um mapa com métricas (chave -> valor)
 std::map<std::string, double> CGroupManager::readCpuUsage(const std::string& name) {
     // Monta o caminho completo do arquivo cpu.stat no cgroup
     const std::string path = basePath + name + "/cpu.stat";
 
-    // Abre o arquivo cpu.stat para leitura
-    std::ifstream f(path);
+    // Lê o arquivo cpu.stat inteiro
+    std::string_view conteudo;
 
     // Se não abriu, imprime erro e retorna mapa vazio
-    if (!f.is_open()) {
+    if (!lerArquivoCgroup(path, conteudo)) {
         std::cerr << "Erro: não foi possível abrir " << path << "\n";
         return {}; // Mapa vazio indica falha
     }
@@ -160,37 +191,49 @@ std::map<std::string, double> CGroupManager::readCpuUsage(const std::string& nam
     // Mapa onde serão armazenados os pares "chave valor"
     std::map<std::string, double> stats;
 
-    // Armazena cada linha lida do arquivo
-    std::string line;
+    // Percorre o arquivo linha a linha sobre o buffer, sem streams
+    while (!conteudo.empty()) {
+        std::string_view line = proximaLinha(conteudo);
 
-    // Lê o arquivo linha a linha
-    while (std::getline(f, line)) {
-
-        // Ignora linhas vazias ou apenas com espaços
+        // Ignora linhas vazias
         if (line.empty()) continue;
 
-        // Transforma a linha em um stream para processar tokens
-        std::istringstream iss(line);
-
-        // Variáveis para armazenar a chave e o valor
-        std::string key;
-        double value;
-
         // Tenta ler no formato:  key   value
-        if (!(iss >> key >> value)) {
+        std::string_view resto = line;
+        std::string_view key = proximoToken(resto);
+        uint64_t value = 0;
+        if (!lerNumero(resto, value)) {
             // Linha inválida
             std::cerr << "Aviso: linha mal formatada em cpu.stat: " << line << "\n";
             continue; // continua lendo as próximas linhas
         }
 
         // Salva no mapa: substitui se a chave já existir
-        stats[key] = value;
+        stats[std::string(key)] = static_cast<double>(value);
     }
 
     // Retorna o mapa com as métricas lidas
     return stats;
 }
 
+// Lê o arquivo cpu.stat direto para a struct, usando a tabela de chaves de procfs_parser.cpp
+bool CGroupManager::readCpuStat(const std::string& name, CpuStatCgroup& cpu) {
+    std::string_view conteudo;
+    if (!lerArquivoCgroup(basePath + name + "/cpu.stat", conteudo)) return false; // cgroup inexistente ou controlador cpu desabilitado
+
+    cpu = CpuStatCgroup{};
+    parseCpuStat(conteudo, cpu);
+    return true;
+}
+
+// Lê <cgroup>/<recurso>.pressure (PSI) com o mesmo parser de /proc/pressure
+bool CGroupManager::readPressure(const std::string& name, RecursoPSI recurso, PressaoPSI& pressao) {
+    std::string_view conteudo;
+    if (!lerArquivoCgroup(basePath + name + "/" + nomeRecursoPSI(recurso) + ".pressure", conteudo) || conteudo.empty())
+        return false; // cgroup inexistente ou kernel sem PSI
+    return parsePressao(conteudo, pressao);
+}
+
 // Lê o arquivo memory.stat e retorna um mapa com métricas (chave -> valor)
 std::map<std::string, size_t> CGroupManager::readMemoryUsage(const std::string& name) {
     // Monta o caminho completo do arquivo memory.current no cgroup
@@ -222,128 +265,35 @@ std::map<std::string, size_t> CGroupManager::readMemoryUsage(const std::string&
 
 // Função da clsse do CGroupManager que faz a leitura de BlkIOUsage. Recebe como parâmetro o nome do cgroup
 std::vector<BlkIOStats> CGroupManager::readBlkIOUsage(const std::string& name) {
-    // Abre o arquivo io.stat do cgroup especificado
-    std::ifstream f(basePath + name + "/io.stat");
-
-    // Vetor que vai armazenar todas as estatísticas encontradas
-    std::vector<BlkIOStats> list;
+    // Lê o arquivo io.stat do cgroup especificado inteiro
+    std::string_view conteudo;
 
     // Caso não consiga abrir o arquivo, retorna lista vazia
-    if (!f.is_open()) {
+    if (!lerArquivoCgroup(basePath + name + "/io.stat", conteudo)) {
         std::cerr << "Falha ao abrir io.stat\n"; // Mostra mensagem ao usuário 
-        return list;
+        return {};
     }
 
-    // Reserva espaço para algumas entradas (otimização)
-    list.reserve(8); // Geralmente há poucos dispositivos por cgroup
-
-    std::string line; 
-
-    // Lê o arquivo linha por linha
-    while (std::getline(f, line)) {
-        // Ignora linhas vazias, indo para a próxima interação
-        if (line.empty())
-            continue;
-
-        // Transforma a linha em um stream para extrair tokens
-        std::istringstream iss(line);
-
-        // Estrutura que vai armazenar os valores da linha atual. Declarada no arquivo header
-        BlkIOStats s{};
-
-        // Lê o primeiro campo: major:minor ou "Default"
-        std::string device;
-        iss >> device;
-
-        // Procura ":" para identificar o dispositivo major/minor
-        auto colon = device.find(':');
-        if (colon != std::string::npos) { // Verifica se é como exemplo 8:0
-            try {
-                // Converte parte antes dos dois pontos para major
-                s.major = std::stoul(device.substr(0, colon));
-                // Converte parte após os dois pontos para minor
-                s.minor = std::stoul(device.substr(colon + 1));
-            }
-            catch (...) {
-                continue; // Se algo deu errado, ignora toda a linha
-            }
-        }
-        else {
-            // Caso seja "Default": representa agregação de dispositivos
-            s.major = s.minor = 0;
-        }
-
-        // Lê todos os campos no formato key=value
-        std::string kv;
-        while (iss >> kv) {
-            // Procura o '=' que separa chave e valor
-            auto pos = kv.find('=');
-            if (pos == std::string::npos)
-                continue; // token inválido, ignora e vai para a próxima intereção
-
-            // Extrai chave e valor
-            std::string key = kv.substr(0, pos);
-            std::string valStr = kv.substr(pos + 1);
-
-            uint64_t val = 0; // Inicializa a variável que vai receber o valor
-            try {
-                val = std::stoull(valStr); // Converte valor para número
-            }
-            catch (...) {
-                continue; // Valor inválido
-            }
-
-            // Armazena o valor na estrutura de BlkIO
-            if (key == "rbytes") s.rbytes = val;
-            else if (key == "wbytes") s.wbytes = val;
-            else if (key == "rios")   s.rios = val;
-            else if (key == "wios")   s.wios = val;
-            else if (key == "dbytes") s.dbytes = val;
-            else if (key == "dios")   s.dios = val;
-        }
-
-        // Adiciona a estrutura preenchida ao vetor final
-        list.push_back(s);
-    }
+    // Uma linha por dispositivo: reserva uma posição por linha, sem limite fixo de dispositivos
+    std::vector<BlkIOStats> dispositivos(static_cast<size_t>(std::count(conteudo.begin(), conteudo.end(), '\n')) + 1);
+    dispositivos.resize(parseIoStat(conteudo, dispositivos.data(), dispositivos.size()));
 
     // Retorna todas as estatísticas lidas
-    return list;
+    return dispositivos;
 }
 
-// Função que faz a leitura da quantidade de interações (ticks) de CPU de um processo desde de sua execução. Recebe como parâmetro o id do processo filho 
+// Função que faz a leitura do tempo de CPU (ns) consumido por um processo desde de sua execução. Recebe como parâmetro o id do processo filho 
 uint64_t CGroupManager::readIterationsFromChild(pid_t pid) {
-    // Monta o caminho para o arquivo /proc/<pid>/stat. Esse arquivo contém dezenas de campos com estatísticas do processo
-    std::string path = "/proc/" + std::to_string(pid) + "/stat";
-
-    // Abre o arquivo para leitura
-    std::ifstream f(path);
-    if (!f.is_open()) { // Caso o processo já tenha terminado ou o arquivo não exista, retorna 0 para indicar falha/leitura inválida.
-        return 0;
-    }
-
-    std::string token;
-    std::vector<std::string> fields;
-
-    // Lê o arquivo inteiro token por token (separado por espaços)
-    // Cada token corresponde a um campo da especificação de /proc/<pid>/stat
-    while (f >> token) {
-        fields.push_back(token); // Adiciona no vetor de campos o valor da leitura
+    // Lê o tempo de CPU em ns (relógio de CPU do processo ou schedstat; utime+stime de stat como fallback).
+    // A sessão padrão mantém os arquivos do filho abertos entre as leituras do experimento.
+    TempoCPU tempo;
+    if (!lerTempoCPU(pid, SessaoColeta::padrao(), tempo)) {
+        return 0; // Caso o processo já tenha terminado, retorna 0 para indicar falha/leitura inválida.
     }
 
-    // /proc/<pid>/stat deve ter pelo menos 15 campos para acessar utime e stime.
-    if (fields.size() < 15) {
-        return 0; // Caso não haja campos suficientes, retorna 0.
-    }
-
-    // Campo 14 (vetor na posição 13) do /proc/<pid>/stat → utime (tempo de CPU em modo usuário)
-    uint64_t utime = std::stoull(fields[13]);
-
-    // Campo 15 (vetor na posição 14) do /proc/<pid>/stat → stime (tempo de CPU em modo kernel)
-    uint64_t stime = std::stoull(fields[14]);
-
-    // Retorna a soma. Isso representa o total de "ticks" de CPU consumidos pelo processo desde que começou a executar.
+    // Isso representa o total de CPU consumido pelo processo desde que começou a executar.
     // Usa isso como aproximação para "iterações", pois o processo é puramente CPU-bound (busy loop).
-    return utime + stime;
+    return tempo.cpuNs;
 }
 
 // ===== Experimento 3: testar throttling de CPU =====
@@ -409,8 +359,8 @@ void CGroupManager::runCpuThrottlingExperiment() {
         // usage_before é o tempo total de CPU consumido pelo cgroup (em segundos).
         double usage_before = stat_before["usage_usec"] / 1e6; // micros → segundos
 
-        // readIterationsFromChild(pid) retorna soma de utime+stime do processo (em ticks).
-        // Usa-se isso para estimar "throughput" do loop do filho (ticks delta por segundo).
+        // readIterationsFromChild(pid) retorna o tempo de CPU do processo (em ns).
+        // Usa-se isso para estimar "throughput" do loop do filho (ms de CPU por segundo).
         uint64_t ticks_before = this->readIterationsFromChild(pid);
 
         // Marca tempo de início da janela de medição (wall-clock)
@@ -429,7 +379,7 @@ void CGroupManager::runCpuThrottlingExperiment() {
         // Leitura final de usage (em segundos)
         double usage_after = stat_after["usage_usec"] / 1e6;
 
-        // Leitura final de utime+stime do processo (em clock ticks)
+        // Leitura final do tempo de CPU do processo (em ns)
         uint64_t ticks_after = this->readIterationsFromChild(pid);
 
         // CÁLCULOS: deltas, porcentagem de CPU e throughput
@@ -444,10 +394,11 @@ void CGroupManager::runCpuThrottlingExperiment() {
         // Ex.: se cpu_used == 0.5s em uma janela de 1.0s -> 50%
         double cpuPercent = (cpu_used / secs) * 100.0;
 
-        // Throughput estimado a partir do delta de ticks (utime+stime do processo)
-        // ticks representa clock ticks do kernel; a variação (ticks_after - ticks_before) dividida por secs dá ticks por segundo — útil como proxy de "iterações/s"
+        // Throughput estimado a partir do delta de CPU do processo
+        // A variação (ticks_after - ticks_before) em ns, convertida para ms e dividida por secs, dá ms de CPU por segundo — útil como proxy de "iterações/s".
+        // Com resolução de ns a janela de 2 s não sofre a quantização de 10 ms dos ticks de stat.
         uint64_t ticks = ticks_after - ticks_before;
-        double throughput = ticks / secs;
+        double throughput = static_cast<double>(ticks) / 1e6 / secs;
 
         // Valor esperado (lim em núcleos multiplicado por 100 para converter em %)
         double expected = lim * 100.0;
@@ -462,13 +413,14 @@ void CGroupManager::runCpuThrottlingExperiment() {
         std::cout << "CPU medido:       " << cpuPercent << "%\n";       // CPU real no período
         std::cout << "CPU esperado:     " << expected << "%\n";         // limite configurado
         std::cout << "Desvio:           " << desvio << "%\n";           // diferença relativa
-        std::cout << "Throughput (ticks/s): " << throughput << "\n";    // ticks por segundo do processo
+        std::cout << "Throughput (ms CPU/s): " << throughput << "\n";  // ms de CPU por segundo do processo
     }
 
     // Encerra o processo filho que gerou carga 
     kill(pid, SIGKILL);
     int status = 0;
     waitpid(pid, &status, 0); // Aguarda o processo finalizar
+    SessaoColeta::padrao().liberar(pid); // Fecha o /proc/<pid>/stat mantido aberto pela sessão padrão
 }
 
 // ===== Experimento 4: testar limite de memória =====
@@ -10,87 +10,12 @@
 #include <filesystem>
 #include <sys/wait.h>
 #include "monitor.h"
+#include "procfs.h"
+#include "rede.h"
+#include "agendador.h"
+#include "histograma.h"
 #include <numeric>
 
-bool temPermissao(int PID) {
-    // Cria o path para o arquivo /proc/[PID]/status do processo
-    std::string path = "/proc/" + std::to_string(PID) + "/status";
-    // Verifica se o arquivo pode ser lido (R_OK = read permission)
-    // Retorna true se acessível, false se não
-    return access(path.c_str(), R_OK) == 0;
-}
-
-bool coletorCPU(StatusProcesso &medicao){
-    int PID = medicao.PID; // guarda PID do processo monitorado
-
-    // Checa se o processo existe
-    if (!processoExiste(PID)) {
-        std::cerr << "Erro: processo " << PID << " inexistente.\n";
-        return false; // sai se processo não existe
-    }
-
-    // Checa se temos permissão para acessar arquivos do processo
-    if (!temPermissao(PID)) {
-        std::cerr << "Erro: sem permissão para acessar processo " << PID << ".\n";
-        return false; // sai se sem permissão
-    }
-
-    // Abre o arquivo stat para pegar utime e stime (tempos de CPU)
-    std::string pathStat = "/proc/" + std::to_string(PID) + "/stat";
-    std::ifstream stat(pathStat);
-    if(!stat.is_open()){
-        std::cerr << "Erro: não foi possível abrir " << pathStat << "\n";
-        std::cerr << "O processo encerrou ou sem permissões\n\n";
-        return false; // sai se não conseguiu abrir
-    }
-
-    double userTime=0, systemTime=0; // variáveis para armazenar utime e stime
-    std::string conteudo;
-
-    // Lê toda a linha do arquivo stat
-    std::getline(stat,conteudo);
-    // Procura a posição do último parêntese, que fecha o nome do processo
-    auto aposParenteses = conteudo.rfind(')');
-    // Pega substring depois do nome do processo
-    std::string depois = conteudo.substr(aposParenteses+1);
-    std::istringstream fluxoLeitura(depois); // cria fluxo para ler os campos restantes
-    std::string iterador;
-
-    // Pula os primeiros 11 campos restantes (não nos interessam)
-    for (int i = 1; i <= 11; ++i)
-        fluxoLeitura >> iterador;
-
-    // Lê utime e stime (tempo de CPU em ticks)
-    fluxoLeitura >> userTime >> systemTime;
-
-    // Obtém número de ticks por segundo do sistema
-    long tickSegundo = sysconf(_SC_CLK_TCK);
-
-    // Converte de ticks para segundos e salva no struct
-    medicao.utime = static_cast<double>(userTime)/static_cast<double>(tickSegundo);
-    medicao.stime = static_cast<double>(systemTime)/static_cast<double>(tickSegundo);
-
-    // Abre o arquivo status para pegar threads e context switches
-    std::string pathStatus = "/proc/" + std::to_string(PID) + "/status";
-    std::ifstream status(pathStatus);
-    if(!status.is_open()){
-        std::cerr << "Erro: não foi possível abrir " << pathStatus << "\n";
-        std::cerr << "O processo encerrou ou sem permissões\n\n";
-        return false; // sai se não conseguiu abrir
-    }
-
-    // Lê linha por linha e extrai informações de interesse
-    while(std::getline(status,conteudo)){
-        if (conteudo.rfind("voluntary_ctxt_switches:", 0) == 0)
-            sscanf(conteudo.c_str(), "voluntary_ctxt_switches: %u", &medicao.contextSwitchfree);
-        else if (conteudo.rfind("nonvoluntary_ctxt_switches:", 0) == 0)
-            sscanf(conteudo.c_str(), "nonvoluntary_ctxt_switches: %u", &medicao.contextSwitchforced);
-        else if (conteudo.rfind("Threads:", 0) == 0)
-            sscanf(conteudo.c_str(), "Threads: %u", &medicao.threads);
-    }
-    return true; // coleta bem-sucedida
-}
-
 void cargaExecutar() {
     // Imprime PID do processo filho
     std::cout << "Processo filho iniciado, PID: " << getpid() << "\n";
@@ -118,35 +43,35 @@ void cargaExecutar() {
     std::cout << "Processo filho terminou, resultado: " << resultadoAcumulado << "\n";
 }
 
-std::pair<unsigned long, unsigned long> lerCPU(int pid) {
-    // Lê arquivo /proc/[pid]/stat
-    std::ifstream arquivo("/proc/" + std::to_string(pid) + "/stat");
-    std::string linha;
-    std::getline(arquivo, linha); // pega primeira linha
-
-    // Separa a linha em campos usando espaço como delimitador
-    std::istringstream iss(linha);
-    std::vector<std::string> campos;
-    std::string campo;
-    while (iss >> campo)
-        campos.push_back(campo);
-
-    // utime = 14º campo, stime = 15º campo (índices 13 e 14)
-    unsigned long utime = std::stoul(campos[13]);
-    unsigned long stime = std::stoul(campos[14]);
+uint64_t lerCPU(int pid, SessaoColeta &sessao) {
+    // Tempo total de CPU em ns (relógio do processo, schedstat ou ticks de stat, nessa ordem)
+    TempoCPU tempo;
+    if (!lerTempoCPU(pid, sessao, tempo)) return 0; // em caso de falha devolve zero
+    return tempo.cpuNs;
+}
 
-    return {utime, stime}; // retorna pair com utime e stime
+uint64_t tempoCPUThreadNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts); // CPU consumida só pela thread chamadora
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
 }
 
-double coletarAmostra(StatusProcesso &status) {
+double coletarAmostra(const ProcessoMonitorado &processo, StatusProcesso &status, SessaoColeta &sessao, RastreadorFds &rastreador,
+                      LatenciasColetores *latencias) {
     // Marca início da coleta
     auto inicio = std::chrono::steady_clock::now();
 
-    // Coleta métricas de CPU, memória, I/O e rede
-    coletorCPU(status);
-    coletorMemoria(status);
-    coletorIO(status);
-    coletorNetwork(status);
+    // Coleta métricas de CPU, memória e I/O em um único snapshot (cada arquivo lido uma vez) e rede
+    TemposColeta tempos{};
+    coletorSnapshot(processo, status, sessao, latencias ? &tempos : nullptr);
+    uint64_t inicioRede = latencias ? instanteMonotonicoNs() : 0;
+    coletorNetwork(processo, status, rastreador);
+    if (latencias) {
+        latencias->registrar(ColetorMedido::CPU, tempos.cpuNs);
+        latencias->registrar(ColetorMedido::Memoria, tempos.memoriaNs);
+        latencias->registrar(ColetorMedido::IO, tempos.ioNs);
+        latencias->registrar(ColetorMedido::Rede, instanteMonotonicoNs() - inicioRede);
+    }
 
     // Calcula latência da coleta em milissegundos
     auto fim = std::chrono::steady_clock::now();
@@ -154,13 +79,9 @@ double coletarAmostra(StatusProcesso &status) {
     return latenciaMs; 
 }
 
-double calcularCpuPercent(unsigned long utimeInicio, unsigned long stimeInicio,
-                          unsigned long utimeFim, unsigned long stimeFim,
-                          double intervaloSegundos) {
-    // Obtém ticks por segundo
-    long ticks = sysconf(_SC_CLK_TCK);
+double calcularCpuPercent(uint64_t cpuNsInicio, uint64_t cpuNsFim, double intervaloSegundos) {
     // Calcula tempo total de CPU usado entre dois instantes
-    double cpuSegundos = static_cast<double>(utimeFim - utimeInicio + stimeFim - stimeInicio) / static_cast<double>(ticks);
+    double cpuSegundos = static_cast<double>(cpuNsFim - cpuNsInicio) / 1e9;
     // Converte para porcentagem em relação ao intervalo
     return (cpuSegundos / intervaloSegundos) * 100.0;
 }
@@ -177,19 +98,20 @@ void overheadMonitoramento() {
     } else {
         // Pai: marca tempo inicial
         auto inicioBase = std::chrono::steady_clock::now();
-        // Lê utime e stime inicial do processo filho
-        auto [utimeIniBase, stimeIniBase] = lerCPU(PID);
+        // Lê o tempo de CPU inicial do processo filho (ns)
+        SessaoColeta sessaoBase; // mantém /proc/<filho>/schedstat aberto entre as duas leituras
+        uint64_t cpuIniBase = lerCPU(PID, sessaoBase);
 
         // Espera quase toda a duração da carga
         std::this_thread::sleep_for(std::chrono::duration<double>(4.5));
-        // Lê utime e stime final
-        auto [utimeFimBase, stimeFimBase] = lerCPU(PID);
+        // Lê o tempo de CPU final
+        uint64_t cpuFimBase = lerCPU(PID, sessaoBase);
         waitpid(PID, nullptr, 0); // espera filho terminar
         auto fimBase = std::chrono::steady_clock::now();
 
         // Calcula tempo de execução real e uso de CPU baseline
         double tempoExecBase = std::chrono::duration<double>(fimBase - inicioBase).count();
-        double cpuBaseline = calcularCpuPercent(utimeIniBase, stimeIniBase, utimeFimBase, stimeFimBase, tempoExecBase);
+        double cpuBaseline = calcularCpuPercent(cpuIniBase, cpuFimBase, tempoExecBase);
 
         // Imprime resultados baseline
         std::cout << "=== Baseline (sem monitoramento) ===\n";
@@ -205,18 +127,25 @@ void overheadMonitoramento() {
                 _exit(0);
             } else {
                 std::vector<double> cpuAmostras; // guarda amostras de CPU%
-                std::vector<double> latenciasSampling; // guarda latência de coleta
+                HistogramaLatencia latenciasSampling; // latência da coleta completa (ns)
+                auto latenciasColetores = std::make_unique<LatenciasColetores>(); // uma por coletor (~100 KiB: fora da pilha)
                 StatusProcesso status;
-                status.PID = PID;
+                ProcessoMonitorado processo(PID); // validado uma vez, não a cada coleta
+                SessaoColeta sessao; // mantém os arquivos do filho abertos durante todo o intervalo
+                RastreadorFds rastreador; // mantém /proc/<filho>/fd aberto e o mapa fd -> socket
 
                 auto tempoInicio = std::chrono::steady_clock::now();
-                auto [utimeIni, stimeIni] = lerCPU(PID); // utime/stime inicial
+                uint64_t cpuIni = lerCPU(PID, sessao); // tempo de CPU inicial do filho (ns)
+                uint64_t cpuMonitorNs = 0; // CPU gasta pela própria thread do monitor nas coletas
 
                 while (true) {
                     auto iterInicio = std::chrono::steady_clock::now();
+                    uint64_t cpuMonitorInicio = tempoCPUThreadNs();
+                    CacheSockets::padrao().novoTick(); // tabela de sockets remontada uma vez por tick
                     // coleta amostra completa (CPU, memória, I/O, rede)
-                    double latenciaMs = coletarAmostra(status);
-                    latenciasSampling.push_back(latenciaMs);
+                    double latenciaMs = coletarAmostra(processo, status, sessao, rastreador, latenciasColetores.get());
+                    latenciasSampling.registrar(static_cast<uint64_t>(latenciaMs * 1e6));
+                    cpuMonitorNs += tempoCPUThreadNs() - cpuMonitorInicio; // só CPU, sem o tempo bloqueado
 
                     // espera intervalo definido
                     std::this_thread::sleep_for(std::chrono::milliseconds(intervalo));
@@ -227,16 +156,15 @@ void overheadMonitoramento() {
                         break;
 
                     // lê CPU atual do filho
-                    auto [utimeAtual, stimeAtual] = lerCPU(PID);
+                    uint64_t cpuAtual = lerCPU(PID, sessao);
                     auto duracaoIter = std::chrono::duration<double>(iterFim - iterInicio).count();
 
-                    // calcula uso de CPU no intervalo
-                    double cpuPercent = calcularCpuPercent(utimeIni, stimeIni, utimeAtual, stimeAtual, duracaoIter);
+                    // calcula uso de CPU no intervalo (ns: sem o ruído de quantização de 1 tick por amostra)
+                    double cpuPercent = calcularCpuPercent(cpuIni, cpuAtual, duracaoIter);
                     cpuAmostras.push_back(cpuPercent);
 
-                    // atualiza utime/stime inicial para próxima iteração
-                    utimeIni = utimeAtual;
-                    stimeIni = stimeAtual;
+                    // atualiza o tempo inicial para próxima iteração
+                    cpuIni = cpuAtual;
                 }
 
                 waitpid(PID, nullptr, 0); // espera filho terminar
@@ -246,7 +174,7 @@ void overheadMonitoramento() {
                 // calcula média CPU e overhead
                 double cpuMedio = std::accumulate(cpuAmostras.begin(), cpuAmostras.end(), 0.0) / static_cast<double>(cpuAmostras.size());
                 double overhead = cpuMedio - cpuBaseline; // diferença em relação ao baseline
-                double latenciaMedia = std::accumulate(latenciasSampling.begin(), latenciasSampling.end(), 0.0) / static_cast<double>(latenciasSampling.size());
+                double latenciaMedia = latenciasSampling.media() / 1e6;
 
                 // imprime métricas do monitoramento
                 std::cout << "=== Monitorado (intervalo " << intervalo << " ms) ===\n";
@@ -254,7 +182,13 @@ void overheadMonitoramento() {
                 std::cout << "Overhead CPU%: " << overhead << "\n";
                 std::cout << "Tempo execução baseline: " << tempoExecBase << " s\n";
                 std::cout << "Tempo execução monitorado: " << tempoExecMonitorado << " s\n";
-                std::cout << "Latência média sampling: " << latenciaMedia << " ms\n\n";
+                std::cout << "Latência média sampling: " << latenciaMedia << " ms\n";
+                std::cout << "Latência p99 / máxima sampling: " << static_cast<double>(latenciasSampling.percentil(99)) / 1e6 << " / "
+                          << static_cast<double>(latenciasSampling.maximo()) / 1e6 << " ms\n";
+                std::cout << "CPU do monitor por amostra: " << static_cast<double>(cpuMonitorNs) / 1e3 / static_cast<double>(latenciasSampling.contagem()) << " µs\n";
+                std::cout << "CPU% do monitor: " << static_cast<double>(cpuMonitorNs) / 1e9 / tempoExecMonitorado * 100.0 << "\n";
+                latenciasColetores->imprimir(); // qual coletor produz os picos
+
             }
         }
     }
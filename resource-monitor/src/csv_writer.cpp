@@ -0,0 +1,276 @@
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "csv.h"
+
+static const char CABECALHO_CSV[] =
+    "timestamp,PID,utime,stime,tempoCPU,esperaCPU,threads,contextSwitchfree,contextSwitchforced,"
+    "vmSize_kB,vmRss_kB,vmSwap_kB,minfault,mjrfault,bytesLidos,bytesEscritos,"
+    "rchar,wchar,syscallLeitura,syscallEscrita,"
+    "usoCPU_pct,usoCPUGlobal_pct,taxaLeituraDisco_KiB_s,taxaLeituraTotal_KiB_s,"
+    "taxaEscritaDisco_KiB_s,taxaEscritaTotal_KiB_s\n";
+
+// Maior linha possível: 26 campos numéricos de até ~24 caracteres mais o timestamp
+static constexpr size_t MAX_LINHA = 768;
+
+static ConfigEscritorCSV configAtual;
+
+ConfigEscritorCSV configuracaoCSV() {
+    return configAtual;
+}
+
+void definirConfiguracaoCSV(const ConfigEscritorCSV &config) {
+    configAtual = config;
+}
+
+const char* nomePoliticaFsync(PoliticaFsync politica) {
+    switch (politica) {
+    case PoliticaFsync::PorLote: return "fdatasync a cada lote";
+    case PoliticaFsync::Periodica: return "fdatasync periódico";
+    default: return "sem fsync";
+    }
+}
+
+// ---- Formatação sem iostreams ----
+
+// Inteiros: to_chars direto no buffer
+template <typename T>
+static char* escreverCampo(char *p, char *fim, T valor) {
+    p = std::to_chars(p, fim, valor).ptr;
+    *p++ = ',';
+    return p;
+}
+
+// Reais: formato geral com 6 algarismos significativos, o mesmo que o operator<< padrão produzia
+static char* escreverCampo(char *p, char *fim, double valor) {
+    p = std::to_chars(p, fim, valor, std::chars_format::general, 6).ptr;
+    *p++ = ',';
+    return p;
+}
+
+// ---- EscritorCSV ----
+
+EscritorCSV::EscritorCSV(std::string arquivo, const ConfigEscritorCSV &configuracao)
+    : caminho(std::move(arquivo)), config(configuracao) {
+    if (config.capacidadeFila == 0) config.capacidadeFila = 1;
+    if (config.tamanhoBuffer < 2 * MAX_LINHA) config.tamanhoBuffer = 2 * MAX_LINHA;
+    if (!abrirArquivo()) {
+        std::cerr << "Aviso: não foi possível abrir " << caminho << " (" << std::strerror(errno) << "), CSV desativado\n";
+        return;
+    }
+    fila.resize(config.capacidadeFila);
+    buffer.resize(config.tamanhoBuffer);
+    ultimoFsync = std::chrono::steady_clock::now();
+    thread = std::thread(&EscritorCSV::executar, this);
+    ativo = true;
+}
+
+EscritorCSV::~EscritorCSV() {
+    if (thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(trava);
+            encerrar = true;
+        }
+        cvDados.notify_one();
+        thread.join(); // a thread esvazia a fila antes de sair
+    }
+    if (fd >= 0) close(fd);
+}
+
+bool EscritorCSV::abrirArquivo() {
+    fd = open(caminho.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    struct stat info{};
+    tamanhoArquivo = fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+    if (tamanhoArquivo == 0) { // arquivo novo (ou recém-rotacionado): cabeçalho primeiro
+        ssize_t escritos = write(fd, CABECALHO_CSV, sizeof(CABECALHO_CSV) - 1);
+        if (escritos > 0) tamanhoArquivo = static_cast<uint64_t>(escritos);
+    }
+    return true;
+}
+
+bool EscritorCSV::registrar(const StatusProcesso &medicao, const calculoMedicao &calculado) {
+    return registrar(medicao, calculado, std::time(nullptr));
+}
+
+bool EscritorCSV::registrar(const StatusProcesso &medicao, const calculoMedicao &calculado, std::time_t agora) {
+    if (!ativo) return false;
+    {
+        std::unique_lock<std::mutex> lock(trava);
+        if (config.bloquearQuandoCheia) // a thread avisa em cvVazia ao terminar cada lote
+            cvVazia.wait(lock, [this] { return quantidade < fila.size(); });
+        if (quantidade == fila.size()) { // disco não acompanha: descarta em vez de bloquear a amostragem
+            descartadas.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Registro &r = fila[(inicio + quantidade) % fila.size()];
+        r.horario = agora;
+        r.medicao = medicao;
+        r.calculado = calculado;
+        ++quantidade;
+    }
+    cvDados.notify_one();
+    return true;
+}
+
+void EscritorCSV::descarregar() {
+    if (!thread.joinable()) return;
+    std::unique_lock<std::mutex> lock(trava);
+    cvVazia.wait(lock, [this] { return quantidade == 0 && !gravando; });
+}
+
+void EscritorCSV::formatar(const Registro &registro) {
+    // O timestamp só é refeito quando o segundo muda
+    if (registro.horario != ultimoHorario) {
+        std::tm tm;
+        gmtime_r(&registro.horario, &tm); // UTC
+        std::strftime(horarioFormatado, sizeof(horarioFormatado), "%Y-%m-%dT%H:%M:%SZ", &tm); // ISO 8601
+        ultimoHorario = registro.horario;
+    }
+
+    const StatusProcesso &m = registro.medicao;
+    const calculoMedicao &c = registro.calculado;
+    char *p = buffer.data() + usados;
+    char *fim = buffer.data() + buffer.size();
+
+    size_t tamanhoHorario = std::strlen(horarioFormatado);
+    std::memcpy(p, horarioFormatado, tamanhoHorario);
+    p += tamanhoHorario;
+    *p++ = ',';
+    p = escreverCampo(p, fim, m.PID);
+    p = escreverCampo(p, fim, m.utime);
+    p = escreverCampo(p, fim, m.stime);
+    p = escreverCampo(p, fim, m.tempoCPU);
+    p = escreverCampo(p, fim, m.esperaCPU);
+    p = escreverCampo(p, fim, m.threads);
+    p = escreverCampo(p, fim, m.contextSwitchfree);
+    p = escreverCampo(p, fim, m.contextSwitchforced);
+    p = escreverCampo(p, fim, m.vmSize);
+    p = escreverCampo(p, fim, m.vmRss);
+    p = escreverCampo(p, fim, m.vmSwap);
+    p = escreverCampo(p, fim, m.minfault);
+    p = escreverCampo(p, fim, m.mjrfault);
+    p = escreverCampo(p, fim, m.bytesLidos);
+    p = escreverCampo(p, fim, m.bytesEscritos);
+    p = escreverCampo(p, fim, m.rchar);
+    p = escreverCampo(p, fim, m.wchar);
+    p = escreverCampo(p, fim, m.syscallLeitura);
+    p = escreverCampo(p, fim, m.syscallEscrita);
+    p = escreverCampo(p, fim, c.usoCPU);
+    p = escreverCampo(p, fim, c.usoCPUGlobal);
+    p = escreverCampo(p, fim, c.taxaLeituraDisco);
+    p = escreverCampo(p, fim, c.taxaLeituraTotal);
+    p = escreverCampo(p, fim, c.taxaEscritaDisco);
+    p = escreverCampo(p, fim, c.taxaEscritaTotal);
+    p[-1] = '\n'; // troca a última vírgula pelo fim de linha
+    usados = static_cast<size_t>(p - buffer.data());
+}
+
+size_t EscritorCSV::escreverBuffer() {
+    size_t enviados = 0;
+    while (enviados < usados) {
+        ssize_t n = write(fd, buffer.data() + enviados, usados - enviados);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Erro ao escrever " << caminho << ": " << std::strerror(errno) << "\n";
+            break; // o lote é perdido, mas a amostragem continua
+        }
+        enviados += static_cast<size_t>(n);
+    }
+    tamanhoArquivo += enviados;
+
+    // Com o write() interrompido, só contam as linhas que chegaram inteiras ao arquivo
+    size_t gravadas = enviados == usados ? linhasNoBuffer
+                                         : static_cast<size_t>(std::count(buffer.data(), buffer.data() + enviados, '\n'));
+    falhasEscrita.fetch_add(linhasNoBuffer - gravadas, std::memory_order_relaxed);
+    usados = 0;
+    linhasNoBuffer = 0;
+
+    auto agora = std::chrono::steady_clock::now();
+    if (config.fsync == PoliticaFsync::PorLote ||
+        (config.fsync == PoliticaFsync::Periodica && agora - ultimoFsync >= config.intervaloFsync)) {
+        fdatasync(fd);
+        ultimoFsync = agora;
+    }
+
+    if (config.rotacaoBytes && tamanhoArquivo >= config.rotacaoBytes) rotacionar();
+    return gravadas;
+}
+
+void EscritorCSV::rotacionar() {
+    // <arquivo>.N-1 -> <arquivo>.N, ..., <arquivo> -> <arquivo>.1; o mais antigo é sobrescrito
+    if (config.fsync != PoliticaFsync::Nunca) fdatasync(fd);
+    close(fd);
+    fd = -1;
+    for (unsigned i = config.arquivosRotacionados; i > 1; --i) {
+        std::string de = caminho + "." + std::to_string(i - 1);
+        std::string para = caminho + "." + std::to_string(i);
+        rename(de.c_str(), para.c_str()); // ENOENT enquanto ainda não há tantos arquivos
+    }
+    if (config.arquivosRotacionados > 0) rename(caminho.c_str(), (caminho + ".1").c_str());
+    else unlink(caminho.c_str());
+
+    if (!abrirArquivo()) {
+        std::cerr << "Erro ao reabrir " << caminho << " após a rotação: " << std::strerror(errno) << "\n";
+        return;
+    }
+    totalRotacoes.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EscritorCSV::executar() {
+    std::unique_lock<std::mutex> lock(trava);
+    while (true) {
+        cvDados.wait(lock, [this] { return quantidade > 0 || encerrar; });
+        if (quantidade == 0 && encerrar) break;
+
+        // Formata tudo o que está na fila sem segurar a trava: o registrar() da amostragem não espera o disco
+        gravando = true;
+        while (quantidade > 0) {
+            Registro registro = fila[inicio];
+            inicio = (inicio + 1) % fila.size();
+            --quantidade;
+            lock.unlock();
+
+            if (usados + MAX_LINHA > buffer.size()) escritas.fetch_add(escreverBuffer(), std::memory_order_relaxed);
+            if (fd >= 0) { // fd fechado: a reabertura depois de uma rotação falhou
+                formatar(registro);
+                ++linhasNoBuffer;
+            } else {
+                descartadas.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            lock.lock();
+        }
+        lock.unlock();
+        if (fd >= 0 && usados) // lote inteiro no arquivo antes de dormir de novo
+            escritas.fetch_add(escreverBuffer(), std::memory_order_relaxed);
+        lock.lock();
+        gravando = false;
+        cvVazia.notify_all();
+    }
+    gravando = false;
+    cvVazia.notify_all();
+}
+
+void EscritorCSV::imprimirResumo() {
+    descarregar();
+    printf(
+        "| Exportação CSV           |            |\n"
+        "-----------------------------------------\n"
+        "| Linhas escritas          | %-10lu |\n"
+        "| Linhas descartadas       | %-10lu |\n"
+        "| Linhas com erro de write | %-10lu |\n"
+        "| Rotações                 | %-10lu |\n"
+        "=========================================\n"
+        "Arquivo: %s (%s)\n\n",
+        static_cast<unsigned long>(linhasEscritas()), static_cast<unsigned long>(linhasDescartadas()),
+        static_cast<unsigned long>(linhasComFalha()), static_cast<unsigned long>(rotacoes()), caminho.c_str(),
+        nomePoliticaFsync(config.fsync));
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include "histograma.h"
+
+// Primeiro índice das faixas log-lineares (os valores abaixo dele têm um contador cada)
+static constexpr uint32_t LIMITE_LINEAR = 2u << HistogramaLatencia::BITS_SUBFAIXA;
+
+uint32_t HistogramaLatencia::indice(uint64_t valor) {
+    if (valor < LIMITE_LINEAR) return static_cast<uint32_t>(valor);
+    uint32_t expoente = static_cast<uint32_t>(std::bit_width(valor)) - 1; // >= BITS_SUBFAIXA + 1
+    if (expoente > EXPOENTE_MAXIMO) return NUM_CONTADORES - 1;
+    uint32_t deslocamento = expoente - BITS_SUBFAIXA;
+    uint32_t subfaixa = static_cast<uint32_t>(valor >> deslocamento) - (1u << BITS_SUBFAIXA); // 0..63
+    return LIMITE_LINEAR + (expoente - BITS_SUBFAIXA - 1) * (1u << BITS_SUBFAIXA) + subfaixa;
+}
+
+uint64_t HistogramaLatencia::inicioFaixa(uint32_t i) {
+    if (i < LIMITE_LINEAR) return i;
+    uint32_t grupo = (i - LIMITE_LINEAR) >> BITS_SUBFAIXA;
+    uint32_t subfaixa = (i - LIMITE_LINEAR) & ((1u << BITS_SUBFAIXA) - 1);
+    return static_cast<uint64_t>((1u << BITS_SUBFAIXA) + subfaixa) << (grupo + 1);
+}
+
+uint64_t HistogramaLatencia::larguraFaixa(uint32_t i) {
+    if (i < LIMITE_LINEAR) return 1;
+    return 1ULL << (((i - LIMITE_LINEAR) >> BITS_SUBFAIXA) + 1);
+}
+
+void HistogramaLatencia::limpar() {
+    std::fill(contadores, contadores + NUM_CONTADORES, 0);
+    total = 0;
+    menor = std::numeric_limits<uint64_t>::max();
+    maior = 0;
+    soma = 0;
+}
+
+void HistogramaLatencia::registrar(uint64_t valorNs) {
+    ++contadores[indice(valorNs)];
+    ++total;
+    menor = std::min(menor, valorNs);
+    maior = std::max(maior, valorNs);
+    soma += valorNs;
+}
+
+void HistogramaLatencia::mesclar(const HistogramaLatencia &outro) {
+    if (outro.total == 0) return;
+    for (uint32_t i = 0; i < NUM_CONTADORES; ++i) contadores[i] += outro.contadores[i];
+    total += outro.total;
+    menor = std::min(menor, outro.menor);
+    maior = std::max(maior, outro.maior);
+    soma += outro.soma;
+}
+
+uint64_t HistogramaLatencia::percentil(double p) const {
+    if (total == 0) return 0;
+    // Posição da amostra pedida (nearest-rank, 1-based)
+    uint64_t posicao = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(total)));
+    posicao = std::max<uint64_t>(posicao, 1);
+    uint64_t acumulado = 0;
+    for (uint32_t i = 0; i < NUM_CONTADORES; ++i) {
+        acumulado += contadores[i];
+        if (acumulado >= posicao)
+            return std::clamp(inicioFaixa(i) + larguraFaixa(i) / 2, menor, maior); // os extremos são exatos
+    }
+    return maior;
+}
+
+// ---- LatenciasColetores ----
+
+static const char* const NOMES_COLETORES[NUM_COLETORES_MEDIDOS] = { "CPU", "Memória", "I/O", "Rede", "TASKSTATS" };
+
+const char* nomeColetorMedido(ColetorMedido coletor) {
+    return NOMES_COLETORES[static_cast<size_t>(coletor)];
+}
+
+void LatenciasColetores::mesclar(const LatenciasColetores &outras) {
+    for (size_t i = 0; i < NUM_COLETORES_MEDIDOS; ++i) porColetor[i].mesclar(outras.porColetor[i]);
+}
+
+void LatenciasColetores::limpar() {
+    for (HistogramaLatencia &h : porColetor) h.limpar();
+}
+
+void LatenciasColetores::imprimir() const {
+    printf(
+        "| Coletor (µs)  | Amostras   | Média      | p50        | p90        | p99        | p99.9      | Máximo     |\n"
+        "--------------------------------------------------------------------------------------------------------\n");
+    for (size_t i = 0; i < NUM_COLETORES_MEDIDOS; ++i) {
+        const HistogramaLatencia &h = porColetor[i];
+        if (h.contagem() == 0) continue;
+        // Largura em bytes: "Memória" tem um caractere de 2 bytes
+        int largura = i == static_cast<size_t>(ColetorMedido::Memoria) ? 14 : 13;
+        printf("| %-*s | %-10lu | %-10.1f | %-10.1f | %-10.1f | %-10.1f | %-10.1f | %-10.1f |\n", largura, NOMES_COLETORES[i],
+            static_cast<unsigned long>(h.contagem()), h.media() / 1e3, static_cast<double>(h.percentil(50)) / 1e3,
+            static_cast<double>(h.percentil(90)) / 1e3, static_cast<double>(h.percentil(99)) / 1e3,
+            static_cast<double>(h.percentil(99.9)) / 1e3, static_cast<double>(h.maximo()) / 1e3);
+    }
+    printf("========================================================================================================\n\n");
+}
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "historico.h"
+
+static const char* const NOMES_METRICAS[NUM_METRICAS_HISTORICO] = {
+    "CPU (%)", "VmRSS (kB)", "VmSwap (kB)", "Leitura (KiB/s)", "Escrita (KiB/s)", "Threads"
+};
+
+const char* nomeMetricaHistorico(MetricaHistorico metrica) {
+    return NOMES_METRICAS[static_cast<size_t>(metrica)];
+}
+
+const char* nomeNivelHistorico(NivelHistorico nivel) {
+    switch (nivel) {
+    case NivelHistorico::Bruto: return "bruto";
+    case NivelHistorico::Agregado10s: return "10 s";
+    case NivelHistorico::Agregado1min: return "1 min";
+    }
+    return "?";
+}
+
+// Valores de uma amostra na ordem de MetricaHistorico
+static void extrairValores(const StatusProcesso &m, const calculoMedicao &c, float *valores) {
+    valores[static_cast<size_t>(MetricaHistorico::CPU)] = static_cast<float>(c.usoCPU);
+    valores[static_cast<size_t>(MetricaHistorico::RSS)] = static_cast<float>(m.vmRss);
+    valores[static_cast<size_t>(MetricaHistorico::Swap)] = static_cast<float>(m.vmSwap);
+    valores[static_cast<size_t>(MetricaHistorico::Leitura)] = static_cast<float>(c.taxaLeituraTotal);
+    valores[static_cast<size_t>(MetricaHistorico::Escrita)] = static_cast<float>(c.taxaEscritaTotal);
+    valores[static_cast<size_t>(MetricaHistorico::Threads)] = static_cast<float>(m.threads);
+}
+
+// Percentil 'p' (0-100) de pares (valor, peso), ordenando o vetor por valor
+static double percentilPonderado(std::vector<std::pair<float, uint32_t>> &pares, double p) {
+    if (pares.empty()) return 0;
+    std::sort(pares.begin(), pares.end());
+    uint64_t total = 0;
+    for (const auto &par : pares) total += par.second;
+    double alvo = p / 100.0 * static_cast<double>(total);
+    uint64_t acumulado = 0;
+    for (const auto &par : pares) {
+        acumulado += par.second;
+        if (static_cast<double>(acumulado) >= alvo) return par.first;
+    }
+    return pares.back().first;
+}
+
+// ---- SerieHistorico ----
+
+SerieHistorico::Nivel::Nivel(int64_t passo, int64_t retencao) : passoMs(passo) {
+    size_t capacidade = static_cast<size_t>(retencao / passo);
+    inicioMs.assign(capacidade, 0);
+    contagem.assign(capacidade, 0);
+    minimo.assign(capacidade * NUM_METRICAS_HISTORICO, 0);
+    maximo.assign(capacidade * NUM_METRICAS_HISTORICO, 0);
+    soma.assign(capacidade * NUM_METRICAS_HISTORICO, 0);
+}
+
+void SerieHistorico::Nivel::adicionar(int64_t instanteMs, const float *v) {
+    size_t capacidade = inicioMs.size();
+    int64_t inicio = instanteMs - ((instanteMs % passoMs) + passoMs) % passoMs; // início da janela de 'passoMs'
+    size_t j;
+    // Nova janela quando o instante passa da atual; um relógio que volta (ajuste de NTP) soma na janela atual
+    if (escritos == 0 || inicio > inicioMs[(escritos - 1) % capacidade]) {
+        j = escritos % capacidade;
+        ++escritos;
+        inicioMs[j] = inicio;
+        contagem[j] = 0;
+    }
+    else {
+        j = (escritos - 1) % capacidade;
+    }
+
+    float *mn = &minimo[j * NUM_METRICAS_HISTORICO];
+    float *mx = &maximo[j * NUM_METRICAS_HISTORICO];
+    double *sm = &soma[j * NUM_METRICAS_HISTORICO];
+    if (contagem[j] == 0) {
+        for (size_t m = 0; m < NUM_METRICAS_HISTORICO; ++m) {
+            mn[m] = mx[m] = v[m];
+            sm[m] = v[m];
+        }
+    }
+    else {
+        for (size_t m = 0; m < NUM_METRICAS_HISTORICO; ++m) {
+            mn[m] = std::min(mn[m], v[m]);
+            mx[m] = std::max(mx[m], v[m]);
+            sm[m] += v[m];
+        }
+    }
+    ++contagem[j];
+}
+
+SerieHistorico::SerieHistorico(uint32_t capacidadeBruta)
+    : instantes(std::max<uint32_t>(capacidadeBruta, 1), 0),
+      valores(static_cast<size_t>(std::max<uint32_t>(capacidadeBruta, 1)) * NUM_METRICAS_HISTORICO, 0),
+      nivel10s(PASSO_10S_MS, RETENCAO_10S_MS),
+      nivel1min(PASSO_1MIN_MS, RETENCAO_1MIN_MS) {}
+
+void SerieHistorico::limpar(int novoPid, uint64_t novoStarttime) {
+    pid = novoPid;
+    starttime = novoStarttime;
+    primeiroMs = 0;
+    atualizadoMs = 0;
+    brutos = 0;
+    nivel10s.escritos = 0;
+    nivel1min.escritos = 0;
+}
+
+void SerieHistorico::adicionar(int64_t instanteMs, const StatusProcesso &medicao, const calculoMedicao &calculado) {
+    float v[NUM_METRICAS_HISTORICO];
+    extrairValores(medicao, calculado, v);
+
+    std::lock_guard<std::mutex> lock(trava);
+    size_t i = brutos % instantes.size();
+    instantes[i] = instanteMs;
+    std::copy(v, v + NUM_METRICAS_HISTORICO, &valores[i * NUM_METRICAS_HISTORICO]);
+    ++brutos;
+    nivel10s.adicionar(instanteMs, v);
+    nivel1min.adicionar(instanteMs, v);
+    if (brutos == 1) primeiroMs = instanteMs;
+    atualizadoMs = instanteMs;
+}
+
+bool SerieHistorico::consultar(MetricaHistorico metrica, int64_t janelaMs, double percentil, ConsultaHistorico &r) const {
+    size_t m = static_cast<size_t>(metrica);
+    std::lock_guard<std::mutex> lock(trava);
+    if (brutos == 0) return false;
+
+    r = ConsultaHistorico{};
+    r.fimMs = atualizadoMs;
+    r.minimo = std::numeric_limits<double>::max();
+    r.maximo = std::numeric_limits<double>::lowest();
+    int64_t inicioJanela = atualizadoMs - janelaMs;
+
+    // Nível bruto: exato, usado sempre que o anel ainda tem a amostra mais antiga pedida (ou a série inteira).
+    // A capacidade garante 10 min a 0,5 s; com intervalos maiores o anel cobre mais tempo
+    size_t capacidade = instantes.size();
+    uint64_t retidos = std::min<uint64_t>(brutos, capacidade);
+    int64_t maisAntigo = instantes[(brutos - retidos) % capacidade];
+    if (brutos <= capacidade || maisAntigo <= inicioJanela) {
+        std::vector<float> selecionados;
+        selecionados.reserve(static_cast<size_t>(retidos));
+        double soma = 0;
+        for (uint64_t k = brutos - retidos; k < brutos; ++k) {
+            size_t i = k % capacidade;
+            if (instantes[i] < inicioJanela) continue;
+            float v = valores[i * NUM_METRICAS_HISTORICO + m];
+            selecionados.push_back(v);
+            soma += v;
+            r.minimo = std::min<double>(r.minimo, v);
+            r.maximo = std::max<double>(r.maximo, v);
+            if (r.amostras++ == 0) r.inicioMs = instantes[i];
+        }
+        r.nivel = NivelHistorico::Bruto;
+        r.media = soma / static_cast<double>(r.amostras);
+        // Percentil exato por seleção (nearest-rank)
+        size_t posicao = static_cast<size_t>(std::ceil(percentil / 100.0 * static_cast<double>(selecionados.size())));
+        posicao = std::clamp<size_t>(posicao, 1, selecionados.size()) - 1;
+        std::nth_element(selecionados.begin(), selecionados.begin() + static_cast<std::ptrdiff_t>(posicao), selecionados.end());
+        r.percentil = selecionados[posicao];
+        return true;
+    }
+
+    // Níveis agregados: 10 s até 6 h, 1 min além disso (limitado ao que o anel ainda guarda)
+    const Nivel &nivel = janelaMs <= RETENCAO_10S_MS ? nivel10s : nivel1min;
+    r.nivel = janelaMs <= RETENCAO_10S_MS ? NivelHistorico::Agregado10s : NivelHistorico::Agregado1min;
+    r.percentilAproximado = true;
+    size_t capNivel = nivel.inicioMs.size();
+    uint64_t janelasRetidas = std::min<uint64_t>(nivel.escritos, capNivel);
+    std::vector<std::pair<float, uint32_t>> medias;
+    medias.reserve(static_cast<size_t>(janelasRetidas));
+    double soma = 0;
+    for (uint64_t k = nivel.escritos - janelasRetidas; k < nivel.escritos; ++k) {
+        size_t j = k % capNivel;
+        if (nivel.inicioMs[j] + nivel.passoMs <= inicioJanela || nivel.contagem[j] == 0) continue;
+        size_t p = j * NUM_METRICAS_HISTORICO + m;
+        r.minimo = std::min<double>(r.minimo, nivel.minimo[p]);
+        r.maximo = std::max<double>(r.maximo, nivel.maximo[p]);
+        soma += nivel.soma[p];
+        if (r.amostras == 0) r.inicioMs = nivel.inicioMs[j];
+        r.amostras += nivel.contagem[j];
+        medias.emplace_back(static_cast<float>(nivel.soma[p] / nivel.contagem[j]), nivel.contagem[j]);
+    }
+    r.media = r.amostras ? soma / static_cast<double>(r.amostras) : 0;
+    r.percentil = percentilPonderado(medias, percentil);
+    if (r.amostras == 0) r.minimo = r.maximo = 0;
+    return true;
+}
+
+size_t SerieHistorico::bytesReservados() const {
+    auto bytesNivel = [](const Nivel &n) {
+        return n.inicioMs.size() * sizeof(int64_t) + n.contagem.size() * sizeof(uint32_t) +
+               n.minimo.size() * sizeof(float) * 2 + n.soma.size() * sizeof(double);
+    };
+    return sizeof(*this) + instantes.size() * sizeof(int64_t) + valores.size() * sizeof(float) +
+           bytesNivel(nivel10s) + bytesNivel(nivel1min);
+}
+
+// ---- HistoricoMetricas ----
+
+HistoricoMetricas& HistoricoMetricas::padrao() {
+    static HistoricoMetricas historico(16, static_cast<uint32_t>(SerieHistorico::RETENCAO_BRUTA_MS / 500)); // 10 min a 0,5 s
+    return historico;
+}
+
+HistoricoMetricas::HistoricoMetricas(uint32_t maxSeries, uint32_t capacidade)
+    : capacidadeBruta(capacidade), posicoes(std::max<uint32_t>(maxSeries, 1)) {}
+
+SerieHistorico* HistoricoMetricas::reservar(int pid, uint64_t starttime) {
+    std::lock_guard<std::mutex> lock(trava);
+    SerieHistorico *livre = nullptr;     // posição nunca alocada ou série sem dono mais antiga
+    int64_t livreMs = std::numeric_limits<int64_t>::max();
+    std::unique_ptr<SerieHistorico> *naoAlocada = nullptr;
+
+    for (auto &posicao : posicoes) {
+        if (!posicao) {
+            if (!naoAlocada) naoAlocada = &posicao;
+            continue;
+        }
+        SerieHistorico &serie = *posicao;
+        std::lock_guard<std::mutex> lockSerie(serie.trava);
+        if (serie.emUso) continue;
+        if (serie.pid == pid && serie.starttime == starttime) { // mesmo processo: continua a série
+            serie.emUso = true;
+            return &serie;
+        }
+        if (serie.atualizadoMs < livreMs) {
+            livreMs = serie.atualizadoMs;
+            livre = &serie;
+        }
+    }
+
+    // Prefere alocar uma posição nova a apagar o histórico de outro processo
+    if (naoAlocada) {
+        *naoAlocada = std::make_unique<SerieHistorico>(capacidadeBruta);
+        livre = naoAlocada->get();
+    }
+    if (!livre) return nullptr;
+    std::lock_guard<std::mutex> lockSerie(livre->trava);
+    livre->limpar(pid, starttime);
+    livre->emUso = true;
+    return livre;
+}
+
+void HistoricoMetricas::liberar(SerieHistorico *serie) {
+    if (!serie) return;
+    std::lock_guard<std::mutex> lock(trava);
+    std::lock_guard<std::mutex> lockSerie(serie->trava);
+    serie->emUso = false;
+}
+
+std::vector<ResumoSerieHistorico> HistoricoMetricas::series() const {
+    std::vector<ResumoSerieHistorico> lista;
+    std::lock_guard<std::mutex> lock(trava);
+    for (const auto &posicao : posicoes) {
+        if (!posicao) continue;
+        const SerieHistorico &s = *posicao;
+        std::lock_guard<std::mutex> lockSerie(s.trava);
+        if (s.brutos == 0) continue;
+        // O dado mais antigo retido está no nível de 1 min (a janela mais antiga do anel)
+        uint64_t retidas = std::min<uint64_t>(s.nivel1min.escritos, s.nivel1min.inicioMs.size());
+        int64_t primeiro = std::max(s.primeiroMs, s.nivel1min.inicioMs[(s.nivel1min.escritos - retidas) % s.nivel1min.inicioMs.size()]);
+        lista.push_back({ s.pid, s.starttime, s.emUso, s.brutos, primeiro, s.atualizadoMs });
+    }
+    std::sort(lista.begin(), lista.end(),
+        [](const ResumoSerieHistorico &a, const ResumoSerieHistorico &b) { return a.atualizadoMs > b.atualizadoMs; });
+    return lista;
+}
+
+bool HistoricoMetricas::consultar(int pid, MetricaHistorico metrica, int64_t janelaMs, double percentil, ConsultaHistorico &resultado) const {
+    const SerieHistorico *escolhida = nullptr;
+    int64_t maisRecente = std::numeric_limits<int64_t>::min();
+    std::lock_guard<std::mutex> lock(trava); // a série não troca de dono durante a consulta
+    for (const auto &posicao : posicoes) {
+        if (!posicao) continue;
+        std::lock_guard<std::mutex> lockSerie(posicao->trava);
+        if (posicao->pid != pid || posicao->brutos == 0 || posicao->atualizadoMs <= maisRecente) continue;
+        maisRecente = posicao->atualizadoMs;
+        escolhida = posicao.get();
+    }
+    return escolhida && escolhida->consultar(metrica, janelaMs, percentil, resultado);
+}
+
+size_t HistoricoMetricas::bytesReservados() const {
+    std::lock_guard<std::mutex> lock(trava);
+    size_t total = 0;
+    for (const auto &posicao : posicoes)
+        if (posicao) total += posicao->bytesReservados();
+    return total;
+}
+
+// ---- ReservaHistorico ----
+
+ReservaHistorico::ReservaHistorico(HistoricoMetricas &h, const ProcessoMonitorado &processo)
+    : historico(&h), serie(h.reservar(processo.pid(), processo.inicio())) {}
+
+ReservaHistorico::~ReservaHistorico() {
+    if (serie) historico->liberar(serie);
+}
+
+ReservaHistorico::ReservaHistorico(ReservaHistorico &&outra) noexcept : historico(outra.historico), serie(outra.serie) {
+    outra.serie = nullptr;
+}
+
+ReservaHistorico& ReservaHistorico::operator=(ReservaHistorico &&outra) noexcept {
+    if (this != &outra) {
+        if (serie) historico->liberar(serie);
+        historico = outra.historico;
+        serie = outra.serie;
+        outra.serie = nullptr;
+    }
+    return *this;
+}
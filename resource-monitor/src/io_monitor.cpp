@@ -19,157 +19,63 @@
 #include <fcntl.h>
 #include <limits>
 #include "monitor.h"
-
-bool coletorIO(StatusProcesso &medicao) {
-    int pid = medicao.PID; // pega o PID do processo monitorado
-
-    //Verifica se o processo existe
-    if (!processoExiste(pid)) { 
-        std::cerr << "Erro: processo " << pid << " inexistente.\n";
-        return false; // retorna false se processo não existe
-    }
-
-    //Verifica se temos permissão para acessar arquivos do processo
-    if (!temPermissao(pid)) {
-        std::cerr << "Erro: sem permissão para acessar processo " << pid << ".\n";
-        return false; // retorna false se não há permissão
-    }
-
-    std::string pathIO = "/proc/" + std::to_string(pid) + "/io"; //caminho do arquivo de I/O do proc
-    std::ifstream arquivoIO(pathIO); //tenta abrir o arquivo
-    //Checa se conseguimos abrir o arquivo
-    if (!arquivoIO.is_open()) {
-        std::cerr << "Erro: não foi possível abrir " << pathIO << "\n";
+#include "procfs.h"
+#include "sketch.h"
+
+bool coletorIO(const ProcessoMonitorado &processo, StatusProcesso &medicao, SessaoColeta &sessao) {
+    //Existência e permissão já foram conferidas ao abrir o processo
+    if (!processo.valido()) return false;
+    int pid = processo.pid(); // pega o PID do processo monitorado
+    medicao.PID = pid;
+    //io não traz o starttime; o descritor mantido na sessão continua preso ao processo da abertura
+
+    std::string_view conteudoIO; // conteúdo de /proc/<pid>/io relido pelo descritor da sessão
+    //Checa se conseguimos ler o arquivo
+    if (!sessao.ler(pid, ArquivoProc::IO, conteudoIO)) {
+        std::cerr << "Erro: não foi possível ler /proc/" << pid << "/io\n";
         std::cerr << "O processo encerrou entre verificações ou não possui permissões para o arquivo\n";
-        return false; // retorna false se não abriu
+        return false; // retorna false se não leu
     }
 
-    std::string linha;
-    while (std::getline(arquivoIO, linha)) { //lê linha por linha
-        if (linha.rfind("read_bytes:", 0) == 0) // começa com read_bytes
-            sscanf(linha.c_str(), "read_bytes: %lu", &medicao.bytesLidos); // atualiza bytes lidos
-        else if (linha.rfind("write_bytes:", 0) == 0) // começa com write_bytes
-            sscanf(linha.c_str(), "write_bytes: %lu", &medicao.bytesEscritos); // atualiza bytes escritos
-        else if (linha.rfind("syscr:", 0) == 0) // syscall de leitura
-            sscanf(linha.c_str(), "syscr: %lu", &medicao.syscallLeitura);
-        else if (linha.rfind("syscw:", 0) == 0) // syscall de escrita
-            sscanf(linha.c_str(), "syscw: %lu", &medicao.syscallEscrita);
-        else if (linha.rfind("rchar:", 0) == 0) // bytes lidos pelo processo (aplicação)
-            sscanf(linha.c_str(), "rchar: %lu", &medicao.rchar);
-        else if (linha.rfind("wchar:", 0) == 0) // bytes escritos pelo processo (aplicação)
-            sscanf(linha.c_str(), "wchar: %lu", &medicao.wchar);
-    }
+    parseIO(conteudoIO, medicao); // preenche bytes, syscalls e rchar/wchar
 
     return true; // retorna true se tudo ocorreu sem erro
 }
 
-bool coletorNetwork(StatusProcesso &status) { // entrada: recebe estrutura onde vai gravar métricas
-    const int pid = status.PID; // PID do processo alvo
-    const std::string caminhoDiretorioFd = "/proc/" + std::to_string(pid) + "/fd"; // path para os file descriptors do processo
-
-    status.bytesRxfila = 0; // zera contador de bytes em fila de recepção
-    status.bytesTxfila = 0; // zera contador de bytes em fila de transmissão
-    status.conexoesAtivas = 0; // zera contador de sockets encontrados
-
-    std::vector<unsigned long> listaInodesSockets; // vetor para armazenar inodes de sockets do processo
-    if (std::filesystem::exists(caminhoDiretorioFd)) { // verifica existência do diretório /proc/<pid>/fd
-        for (auto &entradaFd : std::filesystem::directory_iterator(caminhoDiretorioFd, std::filesystem::directory_options::skip_permission_denied)) { // itera FDs ignorando erros de permissão
-            std::error_code codigoErro; // recebe erro de read_symlink sem lançar exceção
-            auto linkSimbolico = std::filesystem::read_symlink(entradaFd.path(), codigoErro); // lê o symlink do FD (ex.: "socket:[12345]" ou "pipe:[5678]")
-            if (codigoErro) continue; // se falhou ao ler o link, pula este FD
-            std::string alvoLink = linkSimbolico.string(); // converte o path do symlink para string
-
-            if (alvoLink.rfind("socket:[", 0) == 0) { // filtra apenas entradas que começam com "socket:["
-                auto posAbertura = alvoLink.find('['); // posição do '['
-                auto posFechamento = alvoLink.find(']'); // posição do ']'
-                if (posAbertura != std::string::npos && posFechamento != std::string::npos && posFechamento > posAbertura+1) { // garante formato válido com número entre colchetes
-                    try {
-                        unsigned long numeroInode = std::stoul(alvoLink.substr(posAbertura+1, posFechamento-posAbertura-1), nullptr, 10); // extrai número do inode do texto
-                        listaInodesSockets.push_back(numeroInode); // adiciona inode à lista
-                    } catch (...) { continue; } // se conversão falhar, ignora este FD
-                }
-            }
-        }
+// write/read completos no pipe do experimento (um relatório com sketch pode passar de PIPE_BUF)
+static bool escreverTudo(int fd, const uint8_t *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t w = write(fd, dados, tamanho);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        dados += w;
+        tamanho -= static_cast<size_t>(w);
     }
+    return true;
+}
 
-    status.conexoesAtivas = static_cast<unsigned int>(listaInodesSockets.size()); // grava quantos sockets foram detectados no processo
-    if (listaInodesSockets.empty()) return true; // se não há sockets, retorna rapidamente
-
-    std::unordered_map<unsigned long, std::pair<unsigned long, unsigned long>> tabelaInodeParaFilas; // mapa: inode -> (rxQueue, txQueue)
-    auto lerTabelaRede = [&](const std::string &caminhoTabela) { // lambda que faz parse de um /proc/net/*
-        std::ifstream arquivoRede(caminhoTabela); // abre arquivo de tabela de sockets (tcp/udp)
-        if (!arquivoRede.is_open()) return; // se não abrir, sai da lambda
-        std::string linhaTabela;
-        std::getline(arquivoRede, linhaTabela); // descarta cabeçalho (primeira linha)
-
-        while (std::getline(arquivoRede, linhaTabela)) { // itera linhas restantes, cada uma descreve um socket
-            if (linhaTabela.empty()) continue; // pula linhas vazias
-
-            std::istringstream streamTokens(linhaTabela); // stream para tokenizar a linha por whitespace
-            std::vector<std::string> listaTokens; // vetor temporário com tokens da linha
-            std::string token;
-            while (streamTokens >> token) listaTokens.push_back(token); // enche listaTokens com campos da linha
-            if (listaTokens.empty()) continue; // se não houver tokens, pula
-
-            std::string campoTxRxHex; // vai receber token no formato hex:hex (tx:rx)
-            for (const auto &t : listaTokens) { // procura token que contenha ':' e seja hex:hex
-                auto pos = t.find(':'); // posição do ':'
-                if (pos == std::string::npos) continue; // não é o token TX:RX
-
-                std::string parteEsquerda = t.substr(0, pos); // parte antes dos dois pontos (tx em hex)
-                std::string parteDireita = t.substr(pos+1); // parte depois (rx em hex)
-                if (parteEsquerda.empty() || parteDireita.empty()) continue; // precisa ter ambos os lados
-
-                bool esquerdaHex = true, direitaHex = true; // flags de validação hex
-                for (char c : parteEsquerda) if (!std::isxdigit((unsigned char)c)) { esquerdaHex = false; break; } // valida caracteres hex à esquerda
-                for (char c : parteDireita) if (!std::isxdigit((unsigned char)c)) { direitaHex = false; break; } // valida caracteres hex à direita
-
-                if (esquerdaHex && direitaHex) { campoTxRxHex = t; break; } // encontrou token válido TX:RX
-            }
-            if (campoTxRxHex.empty()) continue; // se não achou TX:RX, pula linha
-
-            unsigned long valorTxFila = 0, valorRxFila = 0; // placeholders para valores convertidos
-            try {
-                auto separador = campoTxRxHex.find(':'); // separa hex tx e hex rx
-                std::string hexTx = campoTxRxHex.substr(0, separador); // hex TX
-                std::string hexRx = campoTxRxHex.substr(separador + 1); // hex RX
-                valorTxFila = std::stoul(hexTx, nullptr, 16); // converte TX hex -> inteiro decimal
-                valorRxFila = std::stoul(hexRx, nullptr, 16); // converte RX hex -> inteiro decimal
-            } catch (...) { continue; } // em qualquer erro de conversão, pula linha
-
-            unsigned long inodeLinha = 0; // vai receber o inode extraído da linha
-            for (auto it = listaTokens.rbegin(); it != listaTokens.rend(); ++it) { // percorre tokens de trás pra frente procurando o inode numérico
-                const std::string &tokenAtual = *it;
-                if (tokenAtual.empty()) continue; // pula token vazio
-
-                bool somenteDigitos = true;
-                for (char c : tokenAtual) if (!std::isdigit((unsigned char)c)) { somenteDigitos = false; break; } // verifica se token é só dígitos
-
-                if (somenteDigitos) {
-                    try { inodeLinha = std::stoul(tokenAtual, nullptr, 10); } catch (...) { inodeLinha = 0; } // tenta converter para inteiro
-                    if (inodeLinha != 0) break; // se converteu e não é zero, usa como inode
-                }
-            }
-
-            if (inodeLinha == 0) continue; // sem inode válido, pula linha
-            tabelaInodeParaFilas[inodeLinha] = {valorRxFila, valorTxFila}; // registra rx/tx para o inode
-        }
-    };
-
-    lerTabelaRede("/proc/net/tcp"); // popula tabela com entradas TCP IPv4
-    lerTabelaRede("/proc/net/tcp6"); // popula tabela com entradas TCP IPv6
-    lerTabelaRede("/proc/net/udp"); // popula tabela com entradas UDP IPv4
-    lerTabelaRede("/proc/net/udp6"); // popula tabela com entradas UDP IPv6
-
-    for (unsigned long inodeAtual : listaInodesSockets) { // para cada inode que pertence ao processo
-        auto it = tabelaInodeParaFilas.find(inodeAtual); // busca estatísticas desse inode na tabela de rede
-        if (it != tabelaInodeParaFilas.end()) { // se encontrado (é socket de rede)
-            status.bytesRxfila += it->second.first; // acumula bytes em fila de recepção
-            status.bytesTxfila += it->second.second; // acumula bytes em fila de transmissão
-        }
+static bool lerTudo(int fd, void *destino, size_t tamanho) {
+    uint8_t *p = static_cast<uint8_t*>(destino);
+    while (tamanho > 0) {
+        ssize_t r = read(fd, p, tamanho);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false; // EOF no meio de um relatório: filho morreu
+        p += r;
+        tamanho -= static_cast<size_t>(r);
     }
+    return true;
+}
 
-    return true; // coleta concluída com sucesso
+// Quantis de latência de uma janela (ou da execução inteira), em µs
+struct QuantisLatencia {
+    uint32_t janela;
+    uint64_t operacoes;
+    double p50, p90, p99, p999, maximo;
+};
+
+static QuantisLatencia quantisDoSketch(uint32_t janela, const SketchQuantis &sketch) {
+    return { janela, sketch.contagem(), sketch.quantil(0.50) / 1e3, sketch.quantil(0.90) / 1e3,
+             sketch.quantil(0.99) / 1e3, sketch.quantil(0.999) / 1e3, sketch.maximo() / 1e3 };
 }
 
 void limitacaoIO() {
@@ -272,8 +178,23 @@ void limitacaoIO() {
 
         uint64_t bytesMovimentados = 0;                   // contador acumulado read+write
         uint64_t totalOperacoes = 0;                      // contador de iterações
-        std::vector<double> latenciasMs;                  // vetor para latências amostrais
-        latenciasMs.reserve(1024);                        // reserva para reduzir realocações
+        SketchQuantis sketchJanela;                       // latências (ns) da janela atual: buckets fixos, sem alocação por operação
+        uint32_t janela = 0;                              // número da janela atual
+        std::vector<uint8_t> mensagem(sizeof(RelatorioFilho) + SketchQuantis::TAMANHO_MAXIMO_SERIALIZADO); // relatório + sketch
+
+        // Envia o relatório da janela com o sketch serializado logo depois da estrutura e começa outra janela
+        auto enviarRelatorio = [&](steady_clock::time_point instante) {
+            RelatorioFilho rel{};                          // monta estrutura de relatório
+            rel.bytesMovimentados = bytesMovimentados;     // total acumulado
+            rel.operacoes = totalOperacoes;                // nº de iterações
+            rel.latMediaMs = sketchJanela.media() / 1e6;   // média de lat do intervalo
+            rel.timestampNs = (uint64_t) duration_cast<nanoseconds>(instante.time_since_epoch()).count(); // timestamp
+            rel.janela = janela++;
+            rel.bytesSketch = static_cast<uint32_t>(sketchJanela.serializar(mensagem.data() + sizeof(rel), mensagem.size() - sizeof(rel)));
+            std::memcpy(mensagem.data(), &rel, sizeof(rel));
+            escreverTudo(descritoresPipe[1], mensagem.data(), sizeof(rel) + rel.bytesSketch); // envia relatório para o pai
+            sketchJanela.limpar();                         // limpa amostras locais
+        };
 
         double tokens = 0.0;                              // tokens disponíveis no bucket
         const double tokensPorNs = (limiteBytesPorSegundo > 0) ? static_cast<double>(limiteBytesPorSegundo) / 1e9 : 0.0; // refill por ns
@@ -352,45 +273,20 @@ void limitacaoIO() {
             }
 
             uint64_t latenciaNs = duration_cast<nanoseconds>(fimIO - inicioIO).count(); // lat em ns
-            latenciasMs.push_back((double)latenciaNs / 1e6); // armazena latência em ms
+            sketchJanela.adicionar((double)latenciaNs);    // guarda a latência no sketch da janela (erro relativo <= 1%)
 
             bytesMovimentados += (uint64_t)lidos * 2;       // contabiliza bytes movidos (read+write)
             totalOperacoes++;                               // incrementa contador de operações
 
             agora = steady_clock::now();                    // atualiza instante atual
             if (agora >= proximoRelatorio) {                // se passou 1 segundo desde último relatório
-                double somaLat = 0.0;                       // soma latências do intervalo
-                for (double v : latenciasMs) somaLat += v;
-                double mediaLat = latenciasMs.empty() ? 0.0 : (somaLat / latenciasMs.size()); // média
-
-                RelatorioFilho rel;                         // monta estrutura de relatório
-                rel.bytesMovimentados = bytesMovimentados;  // total acumulado
-                rel.operacoes = totalOperacoes;             // nº de iterações
-                rel.latMediaMs = mediaLat;                  // média de lat do intervalo
-                rel.timestampNs = (uint64_t) duration_cast<nanoseconds>(agora.time_since_epoch()).count(); // timestamp
-
-                write(descritoresPipe[1], &rel, sizeof(rel)); // envia relatório para o pai
-                latenciasMs.clear();                        // limpa amostras locais
+                enviarRelatorio(agora);                     // relatório + sketch da janela
                 proximoRelatorio = agora + milliseconds(1000); // agenda próximo relatório (+1s)
             }
         }
 
-        // relatório final antes de sair
-        RelatorioFilho relFinal;                            // estrutura final
-        relFinal.bytesMovimentados = bytesMovimentados;     // total final
-        relFinal.operacoes = totalOperacoes;                // total de operações
-
-        if (!latenciasMs.empty()) {                         // se restaram amostras
-            double soma = 0.0;
-            for (double v : latenciasMs) soma += v;
-            relFinal.latMediaMs = soma / latenciasMs.size(); // média final
-        } else {
-            relFinal.latMediaMs = 0.0;                      // sem amostras -> 0
-        }
-
-        relFinal.timestampNs = (uint64_t) duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count(); // timestamp final
-
-        write(descritoresPipe[1], &relFinal, sizeof(relFinal)); // envia relatório final
+        // relatório final antes de sair (fecha a última janela, parcial)
+        enviarRelatorio(steady_clock::now());
 
         close(fdFonte);                                     // fecha descritores antes de terminar
         close(fdDestino);
@@ -405,13 +301,33 @@ void limitacaoIO() {
     close(descritoresPipe[1]); // fecha extremidade de escrita no pai (pai só lê)
 
     StatusProcesso statusProcesso; // estrutura existente no seu projeto
-    statusProcesso.PID = idFilho;  // guarda PID do filho para coletores
+    ProcessoMonitorado filho(idFilho); // PID do filho validado uma vez para os coletores
+    SessaoColeta sessaoFilho;      // mantém /proc/<filho>/io aberto entre as leituras
 
-    std::vector<double> latenciasColetadas; // coleciona médias parciais vindas do filho
-    latenciasColetadas.reserve(256);        // reserva para reduzir realocações
+    SketchQuantis sketchExecucao;            // sketches das janelas mesclados: quantis da execução inteira
+    SketchQuantis sketchJanela;              // sketch recebido no último relatório
+    std::vector<QuantisLatencia> quantisJanelas; // p50/p90/p99/p99.9/máx de cada janela
+    std::vector<uint8_t> bufferSketch(SketchQuantis::TAMANHO_MAXIMO_SERIALIZADO);
 
     uint64_t ultimoBytesMov = 0;             // último valor de bytes recebido do filho
 
+    // Lê um relatório inteiro (estrutura + sketch); false em EOF ou mensagem inválida
+    auto receberRelatorio = [&]() {
+        RelatorioFilho rel;                  // estrutura temporária
+        if (!lerTudo(descritoresPipe[0], &rel, sizeof(rel))) return false;
+        if (rel.bytesSketch > bufferSketch.size() || !lerTudo(descritoresPipe[0], bufferSketch.data(), rel.bytesSketch)) return false;
+        if (!sketchJanela.desserializar(bufferSketch.data(), rel.bytesSketch)) {
+            std::cerr << "Relatório do filho com sketch inválido (janela " << rel.janela << ")\n";
+            return false;
+        }
+        if (sketchJanela.contagem() > 0) {   // se relatório tem latência útil
+            sketchExecucao.mesclar(sketchJanela);
+            quantisJanelas.push_back(quantisDoSketch(rel.janela, sketchJanela));
+        }
+        ultimoBytesMov = rel.bytesMovimentados; // atualiza bytes totais
+        return true;
+    };
+
     auto inicioPai = steady_clock::now();    // instante de início para o pai
 
     while (true) {
@@ -426,16 +342,10 @@ void limitacaoIO() {
         int pronto = select(descritoresPipe[0] + 1, &conjuntoLeitura, NULL, NULL, &timeout); // espera por dados
 
         if (pronto > 0 && FD_ISSET(descritoresPipe[0], &conjuntoLeitura)) { // se há dados no pipe
-            RelatorioFilho rel;              // estrutura temporária
-            ssize_t r = read(descritoresPipe[0], &rel, sizeof(rel)); // lê relatório
-            if (r == sizeof(rel)) {          // se leitura completa
-                if (rel.latMediaMs > 0.0)    // se relatório tem latência útil
-                    latenciasColetadas.push_back(rel.latMediaMs); // armazena média parcial
-                ultimoBytesMov = rel.bytesMovimentados; // atualiza bytes totais
-            }
+            receberRelatorio();              // lê relatório e mescla o sketch da janela
         }
 
-        coletorIO(statusProcesso);            // coleta dados via /proc para validação (não usada na métrica principal)
+        coletorIO(filho, statusProcesso, sessaoFilho); // coleta dados via /proc para validação (não usada na métrica principal)
 
         int status = 0;                       // status para waitpid
         pid_t r = waitpid(idFilho, &status, WNOHANG); // verifica se filho terminou sem bloquear
@@ -445,14 +355,7 @@ void limitacaoIO() {
     }
 
     // tenta ler eventuais relatórios finais deixados no pipe
-    while (true) {
-        RelatorioFilho rel;
-        ssize_t r = read(descritoresPipe[0], &rel, sizeof(rel));
-        if (r != sizeof(rel)) break;          // sai quando não há mais relatórios
-        if (rel.latMediaMs > 0.0)             // se tem latência útil
-            latenciasColetadas.push_back(rel.latMediaMs); // acumula
-        ultimoBytesMov = rel.bytesMovimentados; // atualiza último total
-    }
+    while (receberRelatorio()) {}             // sai quando não há mais relatórios (EOF)
 
     close(descritoresPipe[0]);                // fecha leitura do pipe no pai
 
@@ -461,12 +364,7 @@ void limitacaoIO() {
 
     double throughputReal = tempoTotalExecucao > 0.0 ? (double)ultimoBytesMov / tempoTotalExecucao : 0.0; // throughput em B/s
 
-    double latenciaMediaMs = 0.0;             // média final de latências
-    if (!latenciasColetadas.empty()) {
-        double soma = 0.0;
-        for (double v : latenciasColetadas) soma += v;
-        latenciaMediaMs = soma / latenciasColetadas.size(); // calcula média
-    }
+    double latenciaMediaMs = sketchExecucao.media() / 1e6; // média por operação (soma exata / nº de operações)
 
     // cálculo do impacto no tempo total (se possível)
     bool impactoCalculavel = false;           // flag para saber se pode calcular impacto
@@ -491,7 +389,7 @@ void limitacaoIO() {
     std::cout << "Throughput medido (B/s): " << (unsigned long long)throughputReal << "\n"; // imprime throughput
 
     std::cout << "Latência média (ms/op): ";
-    if (latenciasColetadas.empty())
+    if (sketchExecucao.contagem() == 0)
         std::cout << "N/A\n";                       // sem latência disponível
     else
         std::cout << latenciaMediaMs << "\n";      // imprime lat média
@@ -505,5 +403,23 @@ void limitacaoIO() {
         std::cout << "Impacto no tempo total: N/A\n"; // não foi possível calcular
     }
 
+    // Cauda da latência por operação (read+write): cada janela e a execução inteira (sketches mesclados)
+    if (sketchExecucao.contagem() > 0) {
+        std::cout << "\nLatência por operação (µs), DDSketch com erro relativo <= "
+                  << SketchQuantis::ALFA * 100 << "%:\n";
+        printf("| %-7s | %-10s | %-10s | %-10s | %-10s | %-10s | %-10s |\n", "Janela", "Ops", "p50", "p90", "p99", "p99.9", "máx ");
+        printf("-------------------------------------------------------------------------------------\n");
+        auto imprimirLinha = [](const char *rotulo, const QuantisLatencia &q) {
+            printf("| %-7s | %-10lu | %-10.2f | %-10.2f | %-10.2f | %-10.2f | %-10.2f |\n", rotulo,
+                static_cast<unsigned long>(q.operacoes), q.p50, q.p90, q.p99, q.p999, q.maximo);
+        };
+        for (const QuantisLatencia &q : quantisJanelas) {
+            std::string rotulo = std::to_string(q.janela + 1) + "s";
+            imprimirLinha(rotulo.c_str(), q);
+        }
+        printf("-------------------------------------------------------------------------------------\n");
+        imprimirLinha("Total", quantisDoSketch(0, sketchExecucao));
+    }
+
     std::cout << "===================================================\n"; // rodapé
 }
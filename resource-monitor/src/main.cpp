@@ -1,6 +1,22 @@
 ﻿#include "cgroup.h"
 #include "monitor.h"
 #include "namespace.h"
+#include "rede.h"
+#include "taskstats.h"
+#include "threads.h"
+#include "memoria.h"
+#include "cpu_sistema.h"
+#include "psi.h"
+#include "agendador.h"
+#include "motor.h"
+#include "processos.h"
+#include "csv.h"
+#include "serie.h"
+#include "anel.h"
+#include "pipeline.h"
+#include "historico.h"
+#include "metricas.h"
+#include "instantaneo.h"
 #include <iostream>
 #include <string>
 #include <filesystem>
@@ -10,6 +26,7 @@
 #include <limits>
 #include <algorithm>
 #include <thread>
+#include <atomic>
 #include <chrono>
 #include <set>
 #include <unistd.h>
@@ -25,87 +42,12 @@ struct ProcessInfo {
 	std::string name;
 };
 
-bool processoExiste(int PID) {//Checa se o processo existe de fato
-	std::filesystem::path dir = "/proc/" + std::to_string(PID);//concatena o path do processo
-	return std::filesystem::exists(dir) && std::filesystem::is_directory(dir);//Checa existência
-}
-
-void salvarMedicoesCSV(const StatusProcesso& medicao, const calculoMedicao& calculado)
-{
-    // Obtém o diretório atual do programa
-    std::filesystem::path base = std::filesystem::current_path();
-    // Constrói o path completo para o arquivo CSV: [base]/docs/dados[PID].csv
-    std::filesystem::path path = base / "docs" / ("dados" + std::to_string(medicao.PID) + ".csv");
-
-    // Verifica se o arquivo é novo (não existe ou está vazio)
-    bool novo = !std::filesystem::exists(path) || std::filesystem::file_size(path) == 0;
-
-    // Abre o arquivo em modo append (adiciona no final)
-    std::ofstream f(path, std::ios::app);
-    if (!f) return; // Sai se não conseguiu abrir o arquivo
-
-    // Se o arquivo é novo, escreve o cabeçalho CSV
-    if (novo) {
-        f << "timestamp,PID,utime,stime,threads,contextSwitchfree,contextSwitchforced,"
-            "vmSize_kB,vmRss_kB,vmSwap_kB,minfault,mjrfault,bytesLidos,bytesEscritos,"
-            "rchar,wchar,syscallLeitura,syscallEscrita,"
-            "usoCPU_pct,usoCPUGlobal_pct,taxaLeituraDisco_KiB_s,taxaLeituraTotal_KiB_s,"
-            "taxaEscritaDisco_KiB_s,taxaEscritaTotal_KiB_s\n";
-    }
-
-    // Obtém timestamp UTC atual
-    std::time_t t = std::time(nullptr); // tempo atual em segundos desde epoch
-    std::tm tm;
-    gmtime_r(&t, &tm); // converte para UTC
-    char ts[32];
-    std::strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%SZ", &tm); // formata em ISO 8601
-
-    // Escreve uma linha no CSV com os dados do processo e métricas calculadas
-    f << ts << ","                            // timestamp
-        << medicao.PID << ","                 // PID do processo
-        << medicao.utime << ","               // tempo CPU usuário (s)
-        << medicao.stime << ","               // tempo CPU kernel (s)
-        << medicao.threads << ","             // número de threads
-        << medicao.contextSwitchfree << ","   // context switches voluntários
-        << medicao.contextSwitchforced << "," // context switches forçados
-        << medicao.vmSize << ","               // tamanho virtual (kB)
-        << medicao.vmRss << ","                // memória residente (kB)
-        << medicao.vmSwap << ","               // swap usado (kB)
-        << medicao.minfault << ","             // page faults menores
-        << medicao.mjrfault << ","             // page faults maiores
-        << medicao.bytesLidos << ","           // bytes lidos do disco
-        << medicao.bytesEscritos << ","        // bytes escritos no disco
-        << medicao.rchar << ","                // bytes lidos via syscall read
-        << medicao.wchar << ","                // bytes escritos via syscall write
-        << medicao.syscallLeitura << ","       // número de syscalls read
-        << medicao.syscallEscrita << ","       // número de syscalls write
-        << calculado.usoCPU << ","             // CPU % do processo
-        << calculado.usoCPUGlobal << ","       // CPU % global
-        << calculado.taxaLeituraDisco << ","   // taxa leitura disco (KiB/s)
-        << calculado.taxaLeituraTotal << ","   // taxa leitura total (KiB/s)
-        << calculado.taxaEscritaDisco << ","   // taxa escrita disco (KiB/s)
-        << calculado.taxaEscritaTotal          // taxa escrita total (KiB/s)
-        << "\n";                               // fim de linha
-}
-
 std::vector<ProcessInfo> listarProcessos() {
 	std::vector<ProcessInfo> lista;
 
-	for (const auto& entry : fs::directory_iterator("/proc")) {
-		if (!entry.is_directory()) continue;
-
-		const std::string dir = entry.path().filename().string();
-		if (!std::all_of(dir.begin(), dir.end(), ::isdigit)) continue;
-
-		int pid = std::stoi(dir);
-		std::ifstream cmdline("/proc/" + dir + "/comm");
-		std::string nome;
-		if (cmdline.good())
-			std::getline(cmdline, nome);
-
-		if (!nome.empty())
-			lista.push_back({ pid, nome });
-	}
+	// A tabela já tem PID e comm de todos os processos (mantida pelos eventos do kernel)
+	for (auto& p : TabelaProcessos::padrao().listar())
+		lista.push_back({ p.pid, std::move(p.nome) });
 	return lista;
 }
 
@@ -135,7 +77,7 @@ int escolherPID() {
 
 		for (const auto& p : processos) {
 			if (p.pid == pid) {
-				if (processoExiste(pid)) {
+				if (ProcessoMonitorado(pid).valido()) { // existe e temos permissão (mensagem no std::cerr se não)
 					valido = true;
 					break;
 				}
@@ -168,7 +110,11 @@ void executarExperimentos() {
 		std::cout << "\n\033[1;33m======================== PROFILER ==========================\033[0m\n";
 		std::cout << "\033[1m"; // deixa opções em negrito
 		std::cout << " 4. Experimento nº1 - Overhead de Monitoramento\n";
-		std::cout << " 5. Experimento nº5 - Limitação de I/O\n\n";
+		std::cout << " 5. Experimento nº5 - Limitação de I/O\n";
+		std::cout << " 6. Experimento nº6 - Benchmark dos parsers de /proc\n";
+		std::cout << " 7. Experimento nº7 - Benchmark de rede (texto x sock_diag)\n";
+		std::cout << " 8. Experimento nº8 - TASKSTATS (netlink) x /proc\n";
+		std::cout << " 9. Experimento nº9 - Motor multi-PID (1000 alvos)\n\n";
 		std::cout << " 0. Voltar ao menu principal.\n";
 		std::cout << " Escolha: ";
 		std::cout << "\033[0m";
@@ -196,6 +142,18 @@ void executarExperimentos() {
 		else if (sub == 5) {
 			limitacaoIO();
 		}
+		else if (sub == 6) {
+			benchmarkParsers();
+		}
+		else if (sub == 7) {
+			benchmarkRede();
+		}
+		else if (sub == 8) {
+			benchmarkTaskstats();
+		}
+		else if (sub == 9) {
+			benchmarkMotor();
+		}
 		else if (sub != 0) {
 			std::cout << "Opção inválida.\n";
 		}
@@ -350,6 +308,15 @@ void cgroupManager() {
     }
     std::cout << "CPU limitada em " << cores << " cores.\n"; // Mostra a mensagem da CPU limitada ao usuário
 
+    // Mostra o custo real de memória do processo (PSS/USS) para orientar o valor de memory.max
+    MemoriaDetalhada memoria{};
+    ColetorSmaps coletorSmaps;
+    if (coletorSmaps.coletar(pid, memoria)) {
+        std::cout << "Memória do processo: RSS " << memoria.rss << " kB | PSS " << memoria.pss << " kB | USS " << memoria.uss
+            << " kB | Swap PSS " << memoria.swapPss << " kB\n";
+        std::cout << "Sugestão: memory.max acima de PSS + Swap PSS (" << (memoria.pss + memoria.swapPss) * 1024 << " bytes).\n";
+    }
+
     // Processo de fazer o set da memória 
     size_t memBytes; // Set da variável que recebe a memória em bites
     std::cout << "Limite de memória (em bytes, ex: 1000000000): ";
@@ -471,6 +438,18 @@ void cgroupManager() {
             std::cout << "(nenhuma operação de I/O registrada até agora)\n";
         }
 
+        // Pressão (PSI) do cgroup: % do tempo em que as tarefas ficaram paradas esperando cada recurso
+        std::cout << "\nPressão (PSI, avg10):\n";
+        for (RecursoPSI recurso : { RecursoPSI::CPU, RecursoPSI::Memoria, RecursoPSI::IO }) {
+            PressaoPSI pressao{};
+            if (manager.readPressure(cgroupName, recurso, pressao))
+                std::cout << "  " << std::left << std::setw(7) << nomeRecursoPSI(recurso) << std::right
+                    << " some " << std::fixed << std::setprecision(2) << pressao.some.avg10
+                    << "%  full " << pressao.full.avg10 << "%\n";
+            else
+                std::cout << "  " << nomeRecursoPSI(recurso) << ".pressure indisponível\n";
+        }
+
         // A cada iteração aguarda 2 segundos antes de atualizar
         sleep(2);
         numeroLeitura = numeroLeitura + 1; // Incrementa em 1 no numero da leitura 
@@ -487,6 +466,281 @@ void cgroupManager() {
     }
 }
 
+// =========================================
+// Saída de terminal do Perfilador de Recursos
+// =========================================
+// Roda na thread da saída "terminal" do pipeline: imprimir a tabela nunca atrasa a coleta.
+// Mostra no máximo uma tabela por 'periodo' (o terminal não acompanha 100 tabelas por segundo); as taxas
+// são calculadas entre as duas amostras exibidas. Os coletores que só alimentam a tela (threads, smaps,
+// CPU do sistema, PSI) rodam aqui, uma vez por tabela, e não no coletor.
+struct SaidaTerminal {
+    static constexpr double PERIODO_MINIMO = 0.5; // s entre duas tabelas, no mínimo
+    static constexpr size_t threadsExibidas = 5;  // top-K de threads por uso de CPU
+    static constexpr size_t nucleosExibidos = 4;
+
+    int PID;
+    uint64_t starttime; // confere o PID nas amostras guardadas do smaps
+    double intervalo; // intervalo de coleta pedido
+    double periodo;   // intervalo entre tabelas
+    ColetorThreads coletorThreads; // stat/schedstat de cada thread, para achar threads saturadas
+    ColetorSmaps coletorSmaps{ std::chrono::milliseconds(1000) }; // smaps_rollup no máximo 1x/s (varredura cara no kernel)
+    MemoriaDetalhada memoriaDetalhada{};
+    ColetorCPUSistema cpuSistema; // /proc/stat por núcleo, para ver saturação e steal da máquina
+    std::vector<size_t> nucleosOcupados;
+    PressaoPSI pressaoSistema[3]{}; // /proc/pressure/{cpu,memory,io}
+
+    ItemPipeline anterior;     // última amostra exibida
+    bool temAnterior = false;
+    bool retomar = false;      // primeira amostra depois de uma pausa: só reinicia as bases dos deltas
+
+    std::atomic<bool> pausado{false};     // o menu está perguntando algo: nada é impresso
+    std::atomic<uint32_t> tabelas{0};     // tabelas impressas desde a última pergunta (esperado pelo menu)
+    std::atomic<bool> fim{false};         // o pipeline terminou
+    MotivoFim motivo = MotivoFim::Parado; // válido depois de 'fim'
+
+    SaidaTerminal(int pid, uint64_t inicio, double intervaloColeta)
+        : PID(pid), starttime(inicio), intervalo(intervaloColeta), periodo(std::max(intervaloColeta, PERIODO_MINIMO)) {}
+
+    void consumir(const ItemPipeline &item);
+    void rebase(const ItemPipeline &item); // nova base para os deltas, sem imprimir
+    void imprimir(const ItemPipeline &atual);
+};
+
+void SaidaTerminal::rebase(const ItemPipeline &item) {
+    anterior = item;
+    temAnterior = true;
+    coletorThreads.coletar(PID);
+    cpuSistema.coletar();
+}
+
+void SaidaTerminal::consumir(const ItemPipeline &item) {
+    if (item.tipo == ItemPipeline::Tipo::Fim) {
+        motivo = item.motivo;
+        fim.store(true, std::memory_order_release);
+        tabelas.fetch_add(1, std::memory_order_release);
+        tabelas.notify_all();
+        return;
+    }
+    if (pausado.load(std::memory_order_acquire)) {
+        retomar = true;
+        return;
+    }
+    if (item.tipo == ItemPipeline::Tipo::Travamento) {
+        if (item.removido)
+            printf("[PSI] gatilho removido pelo kernel (cgroup apagado): %s\n", item.rotulo);
+        else
+            printf("[PSI] travamento detectado (%s): some avg10 %.2f%%, full avg10 %.2f%%\n",
+                item.rotulo, item.pressao.some.avg10, item.pressao.full.avg10);
+        return;
+    }
+
+    if (!temAnterior) {
+        rebase(item);
+        std::cout << "Primeira medição detectada... \n";
+        std::cout << "Dados e métricas serão mostrados a partir da segunda medição, por favor espere " << periodo << " segundos... \n";
+        return;
+    }
+    if (retomar) { // a pausa do menu não entra nas taxas
+        rebase(item);
+        retomar = false;
+        return;
+    }
+
+    // Amostras intermediárias (coleta mais rápida que a tela) só seguem para as outras saídas
+    double decorrido = static_cast<double>(item.medicao.instanteNs - anterior.medicao.instanteNs) / 1e9;
+    if (decorrido < periodo - intervalo / 2) return;
+
+    imprimir(item);
+    anterior = item;
+    tabelas.fetch_add(1, std::memory_order_release);
+    tabelas.notify_all();
+}
+
+void SaidaTerminal::imprimir(const ItemPipeline &atual) {
+    const StatusProcesso &medicaoAtual = atual.medicao;
+    const StatusProcesso &medicaoAnterior = anterior.medicao;
+
+    // Intervalo real entre as duas amostras exibidas (CLOCK_MONOTONIC): as taxas usam o tempo medido, não o nominal
+    double intervaloReal = static_cast<double>(medicaoAtual.instanteNs - medicaoAnterior.instanteNs) / 1e9;
+    calculoMedicao taxas;
+    calcularMedicao(medicaoAnterior, medicaoAtual, sysconf(_SC_NPROCESSORS_ONLN), taxas); // uma vez por tabela exibida
+    double esperaFila = (medicaoAtual.esperaCPU - medicaoAnterior.esperaCPU) * 1000 / intervaloReal; // ms/s na fila
+    double usoCPUMonitor = static_cast<double>(atual.cpuColetorNs - anterior.cpuColetorNs) / 1e9 / intervaloReal * 100; // custo do coletor
+
+    // Coletores só da tela: deltas desde a tabela anterior
+    coletorThreads.coletar(PID);
+    bool comSmaps = coletorSmaps.coletar(PID, memoriaDetalhada, starttime); // PSS/USS (pode repetir a última amostra)
+    cpuSistema.coletar();
+    bool comPSI = lerPressaoSistema(RecursoPSI::CPU, pressaoSistema[0]) &&
+        lerPressaoSistema(RecursoPSI::Memoria, pressaoSistema[1]) &&
+        lerPressaoSistema(RecursoPSI::IO, pressaoSistema[2]);
+
+    // Imprime tabela detalhada com as métricas coletadas
+    printf(
+        "================================================================================\n"
+        "|                                MEDIÇÃO (Processo %d)                          \n"
+        "================================================================================\n"
+        "| Intervalo de monitoramento: %3.2f segundos                                      |\n"
+        "| Intervalo medido: %-9.6f s | prazos perdidos: %-6lu                             |\n"
+        "| Amostras coletadas: %-10lu (exibidas a cada %3.2f s)                         |\n"
+        "--------------------------------------------------------------------------------\n"
+        "| CPU                      |            |\n"
+        "-----------------------------------------\n"
+        "| user_time(s)             | %-10.6f |\n"
+        "| system_time(s)           | %-10.6f |\n"
+        "| cpu_time(s) (ns)         | %-10.6f |\n"
+        "| Uso por core (%%)         |  %-9.5f |\n"
+        "| Uso relativo (%%)         |  %-9.5f |\n"
+        "| Espera na fila (ms/s)    | %-10.3f |\n"
+        "| CPU do coletor (%%)       |  %-9.5f |\n"
+        "-----------------------------------------\n"
+        "| Threads / ContextSwitch  |            |\n"
+        "-----------------------------------------\n"
+        "| Threads                  | %-10u |\n"
+        "| voluntary_ctxt_switch    | %-10u |\n"
+        "| nonvoluntary_ctxt_switch | %-10u |\n"
+        "-----------------------------------------\n"
+        "| Memória                  |            |\n"
+        "-----------------------------------------\n"
+        "| VmSize (kB)              | %-10lu |\n"
+        "| VmRSS (kB)               | %-10lu |\n"
+        "| VmSwap (kB)              | %-10lu |\n"
+        "| minor faults             | %-10lu |\n"
+        "| major faults             | %-10lu |\n"
+        "-----------------------------------------\n"
+        "| Syscalls                 |            |\n"
+        "-----------------------------------------\n"
+        "| leituras                 | %-10lu |\n"
+        "| escritas                 | %-10lu |\n"
+        "-----------------------------------------\n"
+        "| Taxas (KiB/s)            |            |\n"
+        "-----------------------------------------\n"
+        "| Leitura disco            | %-10.6f |\n"
+        "| Leitura total (rchar)    | %-10.6f |\n"
+        "| Escrita disco            | %-10.6f |\n"
+        "| Escrita total (wchar)    | %-10.6f |\n"
+        "-----------------------------------------\n"
+        "| Network                  |            |\n"
+        "-----------------------------------------\n"
+        "| Bytes em fila (TX)       | %-10lu  |\n"
+        "| Bytes em fila (RX)       | %-10lu  |\n"
+        "| Conexões ativas          | %-10u  |\n"
+        "=========================================\n"
+        "| Próxima medição em %3.2f segundos...    |\n"
+        "=========================================\n\n\n\n\n",
+        medicaoAtual.PID, intervalo, intervaloReal, static_cast<unsigned long>(atual.prazosPerdidos),
+        static_cast<unsigned long>(atual.sequencia + 1), periodo,
+        medicaoAtual.utime, medicaoAtual.stime, medicaoAtual.tempoCPU, taxas.usoCPU, taxas.usoCPUGlobal,
+        esperaFila, usoCPUMonitor,
+        medicaoAtual.threads, medicaoAtual.contextSwitchfree, medicaoAtual.contextSwitchforced,
+        medicaoAtual.vmSize, medicaoAtual.vmRss, medicaoAtual.vmSwap,
+        medicaoAtual.minfault, medicaoAtual.mjrfault,
+        medicaoAtual.syscallLeitura, medicaoAtual.syscallEscrita,
+        taxas.taxaLeituraDisco, taxas.taxaLeituraTotal, taxas.taxaEscritaDisco, taxas.taxaEscritaTotal,
+        medicaoAtual.bytesTxfila, medicaoAtual.bytesRxfila,
+        medicaoAtual.conexoesAtivas,
+        periodo
+    );
+
+    // Atrasos do delay accounting: ms esperando por segundo de monitoramento
+    if (atual.comAtrasos && anterior.comAtrasos) {
+        const AtrasosProcesso &atrasosAtual = atual.atrasos;
+        const AtrasosProcesso &atrasosAnterior = anterior.atrasos;
+        auto taxaAtraso = [&](uint64_t agora, uint64_t antes) {
+            return (static_cast<double>(agora - antes) / 1e6) / intervaloReal;
+        };
+        printf(
+            "| Atrasos (ms/s)           |            |\n"
+            "-----------------------------------------\n"
+            "| Em CPU                   | %-10.3f |\n"
+            "| Espera por CPU           | %-10.3f |\n"
+            "| Espera por I/O (blkio)   | %-10.3f |\n"
+            "| Espera por swap-in       | %-10.3f |\n"
+            "| Reclaim de memória       | %-10.3f |\n"
+            "=========================================\n\n",
+            taxaAtraso(atrasosAtual.cpuTotalNs, atrasosAnterior.cpuTotalNs),
+            taxaAtraso(atrasosAtual.cpuEsperaNs, atrasosAnterior.cpuEsperaNs),
+            taxaAtraso(atrasosAtual.blkioEsperaNs, atrasosAnterior.blkioEsperaNs),
+            taxaAtraso(atrasosAtual.swapinEsperaNs, atrasosAnterior.swapinEsperaNs),
+            taxaAtraso(atrasosAtual.freepagesEsperaNs, atrasosAnterior.freepagesEsperaNs)
+        );
+    }
+
+    // Memória proporcional: o VmRSS conta as páginas compartilhadas inteiras
+    if (comSmaps) {
+        printf(
+            "| Memória (smaps_rollup)%s |            |\n"
+            "-----------------------------------------\n"
+            "| PSS (kB)                 | %-10lu |\n"
+            "| USS (kB)                 | %-10lu |\n"
+            "| Compartilhada (kB)       | %-10lu |\n"
+            "| PSS anônima (kB)         | %-10lu |\n"
+            "| PSS arquivos (kB)        | %-10lu |\n"
+            "| PSS shmem (kB)           | %-10lu |\n"
+            "| Swap PSS (kB)            | %-10lu |\n"
+            "=========================================\n\n",
+            coletorSmaps.ultimaFoiCache() ? " *" : "  ",
+            memoriaDetalhada.pss, memoriaDetalhada.uss, memoriaDetalhada.compartilhada,
+            memoriaDetalhada.pssAnonima, memoriaDetalhada.pssArquivo, memoriaDetalhada.pssShmem,
+            memoriaDetalhada.swapPss
+        );
+        if (coletorSmaps.ultimaFoiCache())
+            printf("* última leitura de smaps_rollup (limite de 1 leitura por segundo)\n\n");
+    }
+
+    // CPU da máquina: um processo a 100% só aparece olhando os núcleos saturados e o steal
+    if (cpuSistema.temIntervalo()) {
+        const ResumoCPU &geral = cpuSistema.resumo();
+        const PercentuaisCPU &pct = cpuSistema.percentuais();
+        printf(
+            "| CPU do sistema (%%)       |            |\n"
+            "-----------------------------------------\n"
+            "| Ocupado                  | %-10.2f |\n"
+            "| user / system            | %-4.1f / %-4.1f |\n"
+            "| iowait / irq             | %-4.1f / %-4.1f |\n"
+            "| steal                    | %-10.2f |\n"
+            "| Núcleos saturados        | %zu de %-5zu |\n"
+            "| procs_running            | %-10lu |\n"
+            "-----------------------------------------\n"
+            "| Núcleo | ocup. | user | sys | iow | steal\n",
+            geral.ocupado, geral.user, geral.system, geral.iowait, geral.irq, geral.steal,
+            geral.nucleosSaturados, cpuSistema.numCPUs(), geral.procsExecutando);
+        cpuSistema.nucleosMaisOcupados(nucleosExibidos, nucleosOcupados);
+        for (size_t n : nucleosOcupados)
+            printf("| cpu%-3zu | %5.1f | %4.1f | %3.1f | %3.1f | %4.1f\n",
+                n, pct.ocupado[n], pct.user[n], pct.system[n], pct.iowait[n], pct.steal[n]);
+        printf("=========================================\n\n");
+    }
+
+    // Pressão (PSI) do sistema: % do tempo com tarefas paradas esperando o recurso nos últimos 10 s
+    if (comPSI) {
+        printf(
+            "| Pressão PSI avg10 (%%)    | some / full   |\n"
+            "-----------------------------------------\n"
+            "| CPU                      | %-5.2f / %-5.2f |\n"
+            "| Memória                  | %-5.2f / %-5.2f |\n"
+            "| I/O                      | %-5.2f / %-5.2f |\n"
+            "=========================================\n\n",
+            pressaoSistema[0].some.avg10, pressaoSistema[0].full.avg10,
+            pressaoSistema[1].some.avg10, pressaoSistema[1].full.avg10,
+            pressaoSistema[2].some.avg10, pressaoSistema[2].full.avg10);
+    }
+
+    // Threads mais quentes: uma thread saturada some na média de CPU do processo
+    const auto &quentes = coletorThreads.threadsQuentes(threadsExibidas);
+    if (!quentes.empty()) {
+        printf(
+            "| Threads mais quentes (top %zu de %zu)\n"
+            "---------------------------------------------------------------\n"
+            "| TID      | Nome            | CPU (%%)  | Fila (ms/s) | Esc./s   |\n"
+            "---------------------------------------------------------------\n",
+            quentes.size(), coletorThreads.totalThreads());
+        for (const auto &t : quentes)
+            printf("| %-8d | %-15s | %-8.2f | %-11.3f | %-8.1f |\n", t.tid, t.nome, t.usoCPU, t.esperaMsPorS, t.trocasPorS);
+        printf("===============================================================\n\n");
+    }
+}
+
 // =========================================
 // FUNÇÃO PARA O Perfilador de Recursos
 // =========================================
@@ -508,8 +762,8 @@ entrada: // label usado para reiniciar o monitor caso haja erro de coleta
         std::cin >> intervalo;
         bool flagInsert = true;
 
-        // Verifica se a entrada foi válida
-        if (std::cin.fail()) {
+        // Verifica se a entrada foi válida (intervalo <= 0 viraria um timer de período mínimo, como no profilerMultiplo)
+        if (std::cin.fail() || intervalo <= 0) {
             std::cin.clear(); // limpa estado de erro do cin
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // descarta entrada inválida
             std::cout << "Entrada inválida. Tente novamente.\n";
@@ -520,189 +774,272 @@ entrada: // label usado para reiniciar o monitor caso haja erro de coleta
         }
     }
 
-    // Inicializa structs para armazenar medições
-    StatusProcesso medicaoAnterior;
-    StatusProcesso medicaoAtual;
-    medicaoAtual.PID = PID; // atribui PID atual
-    bool flagMedicao = true; // flag para primeira medição
-    int contador = 0; // contador de ciclos de medição
+    ProcessoMonitorado processo(PID); // validado uma vez; o pidfd avisa a saída e o starttime detecta PID reutilizado
+    // A fila do EscritorCSV espera em vez de descartar: a espera fica na fila da saída "csv",
+    // onde a derivação aplica o backpressure e conta os descartes
+    ConfigEscritorCSV configCSV = configuracaoCSV();
+    configCSV.bloquearQuandoCheia = true;
+    EscritorCSV csv("docs/dados" + std::to_string(PID) + ".csv", configCSV); // arquivo aberto uma vez; escrita em outra thread
+    EscritorSerie serie("docs/dados" + std::to_string(PID) + ".rmts"); // mesma medição em colunas compactadas, um write() por bloco
+    ReservaAnel anel(AnelAmostras::padrao(), processo); // últimas amostras em docs/recentes.anel (mmap): sobrevivem a um crash
+    ReservaHistorico historico(HistoricoMetricas::padrao(), processo); // histórico em memória com agregados, consultado pela opção 10
+    ReservaInstantaneo instantaneo(InstantaneoCompartilhado::padrao(), processo); // última amostra em /dev/shm para leitores externos
+
+    // Gatilhos de PSI: avisam de travamentos (150 ms parados em 1 s) que acontecem entre duas amostras.
+    // Usa os arquivos do cgroup do processo quando existem; senão, a pressão do sistema inteiro
+    MonitorPSI monitorPSI;
+    {
+        std::string cgroupPSI = "/sys/fs/cgroup" + cgroupDoProcesso(PID);
+        for (RecursoPSI recurso : { RecursoPSI::Memoria, RecursoPSI::IO, RecursoPSI::CPU }) {
+            std::string arquivo = cgroupPSI + "/" + nomeRecursoPSI(recurso) + ".pressure";
+            if (access(arquivo.c_str(), F_OK) != 0) arquivo = std::string("/proc/pressure/") + nomeRecursoPSI(recurso);
+            monitorPSI.adicionarGatilho(arquivo, false, 150000, 1000000);
+        }
+    }
+
+    // Coleta -> derivação -> saídas, cada estágio na sua thread (ver include/pipeline.h)
+    SaidaTerminal terminal(PID, processo.inicio(), intervalo);
+    PipelinePerfilador pipeline(processo, intervalo, monitorPSI);
+    pipeline.adicionarSaida("csv", 4096, std::chrono::milliseconds(2), [&](const ItemPipeline &item) {
+        if (item.tipo == ItemPipeline::Tipo::Amostra)
+            csv.registrar(item.medicao, item.calculado, static_cast<std::time_t>(item.instanteMs / 1000));
+    });
+    pipeline.adicionarSaida("exportadores", 4096, std::chrono::milliseconds(2), [&](const ItemPipeline &item) {
+        if (item.tipo != ItemPipeline::Tipo::Amostra) return;
+        serie.adicionar(item.instanteMs, item.medicao, item.calculado);
+        anel.gravar(item.medicao, item.calculado);
+        instantaneo.publicar(item.medicao, item.calculado);
+        if (item.sequencia > 0) historico.adicionar(item.instanteMs, item.medicao, item.calculado); // a 1ª amostra não tem taxas
+    });
+    // O terminal só quer a amostra mais recente: fila curta e sem espera (o que não couber é descartado)
+    pipeline.adicionarSaida("terminal", 16, std::chrono::microseconds(0), [&](const ItemPipeline &item) {
+        terminal.consumir(item);
+    });
+    // Com o servidor de métricas ligado (opção 11), a saída renderiza o snapshot OpenMetrics no máximo uma
+    // vez por segundo; a raspagem só copia o texto pronto e nunca dispara uma coleta
+    ServidorMetricas &servidorMetricas = ServidorMetricas::padrao();
+    if (servidorMetricas.ativo()) {
+        const std::string cgroupProcesso = cgroupDoProcesso(PID);
+        pipeline.adicionarSaida("metricas", 16, std::chrono::microseconds(0),
+            [&servidorMetricas, cgroupProcesso, ultimoMs = int64_t(0)](const ItemPipeline &item) mutable {
+                if (item.tipo == ItemPipeline::Tipo::Fim) {
+                    servidorMetricas.publicar(""); // sem processo monitorado: exposição vazia
+                    return;
+                }
+                if (item.tipo != ItemPipeline::Tipo::Amostra || (ultimoMs != 0 && item.instanteMs - ultimoMs < 1000)) return;
+                ultimoMs = item.instanteMs;
+                RenderizadorMetricas renderizador;
+                renderizador.processo(item.medicao, item.calculado);
+                if (!cgroupProcesso.empty()) renderizador.cgroup(cgroupProcesso);
+                renderizador.pressaoSistema();
+                servidorMetricas.publicar(renderizador.finalizar());
+            });
+    }
+    pipeline.iniciar();
 
-    // Loop principal de monitoramento
+    // A thread do menu só conversa com o usuário; a coleta continua enquanto ele responde
     while (true) {
+        // Espera 5 tabelas (ou o fim do pipeline)
+        uint32_t vistas = terminal.tabelas.load(std::memory_order_acquire);
+        while (vistas < 5 && !terminal.fim.load(std::memory_order_acquire)) {
+            terminal.tabelas.wait(vistas, std::memory_order_acquire);
+            vistas = terminal.tabelas.load(std::memory_order_acquire);
+        }
 
-        // Coleta dados de CPU, memória, I/O e rede
-        if (!(coletorCPU(medicaoAtual) && coletorMemoria(medicaoAtual) && coletorIO(medicaoAtual) && coletorNetwork(medicaoAtual))) {
-            // Se falhar na coleta, reinicia a entrada
-            std::cout << "\nFalha ao acessar dados do processo\n";
+        if (terminal.fim.load(std::memory_order_acquire)) {
+            if (terminal.motivo == MotivoFim::FalhaColeta) {
+                // Se falhar na coleta, reinicia a entrada
+                std::cout << "\nFalha ao acessar dados do processo\n";
+            }
+            else {
+                std::cout << "\nO processo " << PID << " encerrou.\n";
+            }
+            pipeline.parar();
+            pipeline.imprimirResumo();
+            csv.imprimirResumo();
+            serie.imprimirResumo();
             std::cout << "Reiniciando...\n";
             goto entrada;
         }
-        else {
-            // Criação e atualização do CSV
-            calculoMedicao resultado;
-
-            // Se for a primeira medição, inicializa métricas com zero
-            if (flagMedicao) {
-                resultado.usoCPU = 0;
-                resultado.usoCPUGlobal = 0;
-                resultado.taxaLeituraDisco = 0;
-                resultado.taxaLeituraTotal = 0;
-                resultado.taxaEscritaDisco = 0;
-                resultado.taxaEscritaTotal = 0;
-                salvarMedicoesCSV(medicaoAtual, resultado); // salva primeira linha
-            }
 
-            if (flagMedicao) {
-                std::cout << "Primeira medição detectada... \n";
-                std::cout << "Dados e métricas serão mostrados a partir da segunda medição, por favor espere " << intervalo << " segundos... \n";
-                flagMedicao = false; // desativa flag de primeira medição
+        // A cada 5 tabelas, pergunta ao usuário se deseja encerrar
+        terminal.pausado.store(true, std::memory_order_release);
+        int escolha;
+        while (true) {
+            std::cout << "Deseja encerrar o monitoramento? (1 -> sim/0 -> não): \n";
+            std::cin >> escolha;
+            bool flagInsert = true;
+            if (std::cin.fail() || escolha > 1) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << "Entrada inválida. Tente novamente.\n";
+                flagInsert = false;
             }
-            else {
-                // Calcula métricas de CPU
-                double tempoCPUAtual = medicaoAtual.utime + medicaoAtual.stime;
-                double tempoCPUAnterior = medicaoAnterior.utime + medicaoAnterior.stime;
-                double deltaCPU = tempoCPUAtual - tempoCPUAnterior; // tempo CPU decorrido
-                double usoCPU = (deltaCPU / intervalo) * 100; // uso percentual do processo
-                double usoCPUGlobal = usoCPU / (static_cast<double>(sysconf(_SC_NPROCESSORS_ONLN))); // uso relativo por core
-
-                // Calcula métricas de I/O em KiB/s
-                double taxaleituraDisco = (static_cast<double>(medicaoAtual.bytesLidos - medicaoAnterior.bytesLidos) / intervalo) / 1024;
-                double taxaleituraTotal = (static_cast<double>(medicaoAtual.rchar - medicaoAnterior.rchar) / intervalo) / 1024;
-                double taxaEscritaDisco = (static_cast<double>(medicaoAtual.bytesEscritos - medicaoAnterior.bytesEscritos) / intervalo) / 1024;
-                double taxaEscritaTotal = (static_cast<double>(medicaoAtual.wchar - medicaoAnterior.wchar) / intervalo) / 1024;
-
-                // Armazena resultados no struct
-                resultado.usoCPU = usoCPU;
-                resultado.usoCPUGlobal = usoCPUGlobal;
-                resultado.taxaLeituraDisco = taxaleituraDisco;
-                resultado.taxaLeituraTotal = taxaleituraTotal;
-                resultado.taxaEscritaDisco = taxaEscritaDisco;
-                resultado.taxaEscritaTotal = taxaEscritaTotal;
-
-                // Salva no CSV
-                salvarMedicoesCSV(medicaoAtual, resultado);
-
-                // Imprime tabela detalhada com as métricas coletadas
-                printf(
-                    "================================================================================\n"
-                    "|                                MEDIÇÃO (Processo %d)                          \n"
-                    "================================================================================\n"
-                    "| Intervalo de monitoramento: %3.2f segundos                                      |\n"
-                    "--------------------------------------------------------------------------------\n"
-                    "| CPU                      |            |\n"
-                    "-----------------------------------------\n"
-                    "| user_time(s)             | %-10.6f |\n"
-                    "| system_time(s)           | %-10.6f |\n"
-                    "| Uso por core (%%)         |  %-9.5f |\n"
-                    "| Uso relativo (%%)         |  %-9.5f |\n"
-                    "-----------------------------------------\n"
-                    "| Threads / ContextSwitch  |            |\n"
-                    "-----------------------------------------\n"
-                    "| Threads                  | %-10u |\n"
-                    "| voluntary_ctxt_switch    | %-10u |\n"
-                    "| nonvoluntary_ctxt_switch | %-10u |\n"
-                    "-----------------------------------------\n"
-                    "| Memória                  |            |\n"
-                    "-----------------------------------------\n"
-                    "| VmSize (kB)              | %-10lu |\n"
-                    "| VmRSS (kB)               | %-10lu |\n"
-                    "| VmSwap (kB)              | %-10lu |\n"
-                    "| minor faults             | %-10lu |\n"
-                    "| major faults             | %-10lu |\n"
-                    "-----------------------------------------\n"
-                    "| Syscalls                 |            |\n"
-                    "-----------------------------------------\n"
-                    "| leituras                 | %-10lu |\n"
-                    "| escritas                 | %-10lu |\n"
-                    "-----------------------------------------\n"
-                    "| Taxas (KiB/s)            |            |\n"
-                    "-----------------------------------------\n"
-                    "| Leitura disco            | %-10.6f |\n"
-                    "| Leitura total (rchar)    | %-10.6f |\n"
-                    "| Escrita disco            | %-10.6f |\n"
-                    "| Escrita total (wchar)    | %-10.6f |\n"
-                    "-----------------------------------------\n"
-                    "| Network                  |            |\n"
-                    "-----------------------------------------\n"
-                    "| Bytes em fila (TX)       | %-10lu  |\n"
-                    "| Bytes em fila (RX)       | %-10lu  |\n"
-                    "| Conexões ativas          | %-10u  |\n"
-                    "=========================================\n"
-                    "| Próxima medição em %3.2f segundos...    |\n"
-                    "=========================================\n\n\n\n\n",
-                    medicaoAtual.PID, intervalo,
-                    medicaoAtual.utime, medicaoAtual.stime, usoCPU, usoCPUGlobal,
-                    medicaoAtual.threads, medicaoAtual.contextSwitchfree, medicaoAtual.contextSwitchforced,
-                    medicaoAtual.vmSize, medicaoAtual.vmRss, medicaoAtual.vmSwap,
-                    medicaoAtual.minfault, medicaoAtual.mjrfault,
-                    medicaoAtual.syscallLeitura, medicaoAtual.syscallEscrita,
-                    taxaleituraDisco, taxaleituraTotal, taxaEscritaDisco, taxaEscritaTotal,
-                    medicaoAtual.bytesTxfila, medicaoAtual.bytesRxfila,
-                    medicaoAtual.conexoesAtivas,
-                    intervalo
-                );
-
+            if (flagInsert) {
+                break; // sai se entrada válida
             }
+        }
 
-            // Incrementa contador de ciclos
-            contador++;
-
-            // A cada 5 ciclos, pergunta ao usuário se deseja encerrar
-            if (contador == 5) {
-                int escolha;
-                while (true) {
-                    std::cout << "Deseja encerrar o monitoramento? (1 -> sim/0 -> não): \n";
-                    std::cin >> escolha;
-                    bool flagInsert = true;
-                    if (std::cin.fail() || escolha > 1) {
-                        std::cin.clear();
-                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                        std::cout << "Entrada inválida. Tente novamente.\n";
-                        flagInsert = false;
-                    }
-                    if (flagInsert) {
-                        break; // sai se entrada válida
-                    }
-                }
-
-                // Se usuário quiser encerrar
-                if (escolha == 1) {
-                    while (true) {
-                        std::cout << "Certo, você quer monitorar outro processo ou sair do resource profiler? (1 -> sair/0 -> outro processo): \n";
-                        std::cin >> escolha;
-                        bool flagInsert = true;
-                        if (std::cin.fail() || escolha > 1) {
-                            std::cin.clear();
-                            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                            std::cout << "Entrada inválida. Tente novamente. \n";
-                            flagInsert = false;
-                        }
-                        if (flagInsert) {
-                            break;
-                        }
-                    }
-
-                    if (escolha == 0) {
-                        goto entrada; // reinicia monitoramento para outro PID
-                    }
-                    else {
-                        break; // sai do loop principal
-                    }
+        // Se usuário quiser encerrar
+        if (escolha == 1) {
+            pipeline.parar(); // esvazia as filas: CSV, série e anel recebem tudo o que foi coletado
+            pipeline.imprimirResumo();
+            csv.imprimirResumo();
+            serie.imprimirResumo();
+            while (true) {
+                std::cout << "Certo, você quer monitorar outro processo ou sair do resource profiler? (1 -> sair/0 -> outro processo): \n";
+                std::cin >> escolha;
+                bool flagInsert = true;
+                if (std::cin.fail() || escolha > 1) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida. Tente novamente. \n";
+                    flagInsert = false;
                 }
-                else {
-                    std::cout << "O processo de PID: " << medicaoAtual.PID << " será monitorado por mais 5 ciclos... \n";
-                    contador = 0; // reseta contador
+                if (flagInsert) {
+                    break;
                 }
             }
 
-            // Atualiza medição anterior para calcular deltas no próximo ciclo
-            medicaoAnterior = medicaoAtual;
-            // Aguarda intervalo definido antes da próxima coleta
-            std::this_thread::sleep_for(std::chrono::duration<double>(intervalo));
+            if (escolha == 0) {
+                goto entrada; // reinicia monitoramento para outro PID
+            }
+            return; // sai do resource profiler
         }
+
+        std::cout << "O processo de PID: " << PID << " será monitorado por mais 5 ciclos... \n";
+        terminal.tabelas.store(0, std::memory_order_relaxed); // reseta contador
+        terminal.pausado.store(false, std::memory_order_release);
     }
 }
 
+// =========================================
+// FUNÇÃO PARA O Perfilador de múltiplos processos
+// =========================================
+void profilerMultiplo() {
+    std::cout << "\033[1;36m"; // muda cor para ciano em negrito
+    std::cout << "\n============================================================\n";
+    std::cout << "              Perfilador de múltiplos processos              \n";
+    std::cout << "============================================================\n";
+    std::cout << "\033[0m";
+    std::cout << "\033[1m";
+    std::cout << " 1. Lista de PIDs\n";
+    std::cout << " 2. Processos por nome (comm contém o texto)\n";
+    std::cout << " 3. Processos de um cgroup (e descendentes)\n";
+    std::cout << " 0. Voltar\n";
+    std::cout << " Escolha: ";
+    std::cout << "\033[0m";
+
+    int criterio = -1;
+    if (!(std::cin >> criterio) || criterio < 0 || criterio > 3) {
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << "Opção inválida.\n";
+        return;
+    }
+    if (criterio == 0) return;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    MotorProfiler motor; // um worker por núcleo
+    motor.definirAnel(&AnelAmostras::padrao()); // cada alvo ganha um slot no anel de amostras recentes
+    motor.definirHistorico(&HistoricoMetricas::padrao()); // e uma série no histórico em memória, enquanto houver séries livres
+    motor.definirInstantaneo(&InstantaneoCompartilhado::padrao()); // e a última amostra na tabela compartilhada (tools/snapshot_reader)
+    std::string linha;
+    if (criterio == 1) {
+        std::cout << "PIDs separados por espaço: ";
+        std::getline(std::cin, linha);
+        std::vector<int> pids;
+        std::istringstream entrada(linha);
+        for (int pid; entrada >> pid;) pids.push_back(pid);
+        motor.alvosPorPIDs(pids);
+    }
+    else {
+        std::cout << (criterio == 2 ? "Nome (ou parte do nome) do processo: " : "Cgroup (relativo a /sys/fs/cgroup): ");
+        std::getline(std::cin, linha);
+        if (criterio == 2) motor.alvosPorNome(linha);
+        else motor.alvosPorCgroup(linha);
+    }
+
+    double intervalo = 0;
+    int totalTicks = 0;
+    std::cout << "Insira o intervalo de monitoramento, em segundos: ";
+    std::cin >> intervalo;
+    std::cout << "Número de amostras: ";
+    std::cin >> totalTicks;
+    if (std::cin.fail() || intervalo <= 0 || totalTicks <= 0) {
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << "Entrada inválida.\n";
+        return;
+    }
+
+    AgendadorAmostras agendador(intervalo);
+    std::vector<uint32_t> ordem; // índices da tabela ordenados por CPU%
+    const size_t exibidos = 10;
+
+    // Snapshot OpenMetrics de todos os alvos (opção 11), renderizado no laço no máximo uma vez por segundo
+    ServidorMetricas &servidorMetricas = ServidorMetricas::padrao();
+    std::string cgroupAlvo;
+    if (criterio == 3) cgroupAlvo = (linha.empty() || linha[0] != '/') ? "/" + linha : linha;
+    uint64_t ultimaPublicacaoNs = 0;
+
+    for (int tick = 1; tick <= totalTicks; ++tick) {
+        if (!motor.amostrar()) {
+            std::cout << "Nenhum processo ativo entre os alvos. Encerrando.\n";
+            break;
+        }
+
+        // Totais do grupo e os processos com mais CPU
+        const auto &alvos = motor.alvos();
+        double cpuTotal = 0, leituraTotal = 0, escritaTotal = 0;
+        unsigned long rssTotal = 0;
+        ordem.clear();
+        for (uint32_t i = 0; i < alvos.size(); ++i) {
+            if (!alvos[i].ativo) continue;
+            cpuTotal += alvos[i].taxas.usoCPU;
+            leituraTotal += alvos[i].taxas.taxaLeituraTotal;
+            escritaTotal += alvos[i].taxas.taxaEscritaTotal;
+            rssTotal += alvos[i].atual.vmRss;
+            ordem.push_back(i);
+        }
+        size_t k = std::min(exibidos, ordem.size());
+        std::partial_sort(ordem.begin(), ordem.begin() + k, ordem.end(),
+            [&](uint32_t a, uint32_t b) { return alvos[a].taxas.usoCPU > alvos[b].taxas.usoCPU; });
+
+        printf(
+            "\n| Amostra %d de %d | alvos ativos: %zu de %zu | workers: %zu\n"
+            "| Coleta do tick: %.3f ms | prazos perdidos: %lu\n"
+            "| Grupo: CPU %.2f%% | VmRSS %lu kB | leitura %.2f KiB/s | escrita %.2f KiB/s\n"
+            "---------------------------------------------------------------------------\n"
+            "| PID      | CPU (%%)  | VmRSS (kB)   | Leitura (KiB/s) | Escrita (KiB/s) | Sockets\n"
+            "---------------------------------------------------------------------------\n",
+            tick, totalTicks, ordem.size(), alvos.size(), motor.numTrabalhadores(),
+            motor.duracaoUltimoTickMs(), static_cast<unsigned long>(agendador.prazosPerdidos()),
+            cpuTotal, rssTotal, leituraTotal, escritaTotal);
+        for (size_t i = 0; i < k; ++i) {
+            const AlvoProfiler &a = alvos[ordem[i]];
+            printf("| %-8d | %-8.2f | %-12lu | %-15.2f | %-15.2f | %u\n",
+                a.pid, a.taxas.usoCPU, a.atual.vmRss, a.taxas.taxaLeituraTotal, a.taxas.taxaEscritaTotal, a.atual.conexoesAtivas);
+        }
+        printf("===========================================================================\n");
+
+        uint64_t agoraNs = instanteMonotonicoNs();
+        if (servidorMetricas.ativo() && (ultimaPublicacaoNs == 0 || agoraNs - ultimaPublicacaoNs >= 1000000000ULL)) {
+            ultimaPublicacaoNs = agoraNs;
+            RenderizadorMetricas renderizador;
+            for (const AlvoProfiler &a : alvos)
+                if (a.ativo) renderizador.processo(a.atual, a.taxas);
+            if (!cgroupAlvo.empty()) renderizador.cgroup(cgroupAlvo);
+            renderizador.pressaoSistema();
+            servidorMetricas.publicar(renderizador.finalizar());
+        }
+
+        if (tick < totalTicks) agendador.esperar(); // prazo absoluto: a duração do tick não atrasa a grade
+    }
+    agendador.imprimirResumo();
+    if (servidorMetricas.ativo()) servidorMetricas.publicar(""); // os alvos deixam de ser monitorados
+}
+
 // Define a função 'namespaceAnalyzer', que atuará como um sub-menu para todas as operações de namespace.
 void namespaceAnalyzer() {
 	int sub; // Variável para armazenar a escolha do sub-menu.
@@ -798,11 +1135,9 @@ void namespaceAnalyzer() {
 			// Esta seção serve para ajudar o usuário, mostrando IDs de namespace válidos.
 			// Cria um 'set' para armazenar os IDs únicos encontrados.
 			std::set<std::string> idsDisponiveis;
-			// Itera por todos os diretórios em /proc
-			for (const auto& entry : std::filesystem::directory_iterator("/proc")) {
-				std::string pidStr = entry.path().filename(); // Pega o nome do diretório
-				// Verifica se o nome é composto apenas por dígitos (é um PID)
-				if (!std::all_of(pidStr.begin(), pidStr.end(), ::isdigit)) continue;
+			// Itera por todos os processos da tabela de processos
+			for (int pid : TabelaProcessos::padrao().pids()) {
+				std::string pidStr = std::to_string(pid); // PID como texto para montar o caminho
 
 				// Constrói o caminho para o arquivo de namespace (ex: /proc/123/ns/net)
 				std::string nsPath = "/proc/" + pidStr + "/ns/" + tipo;
@@ -854,6 +1189,256 @@ void namespaceAnalyzer() {
 	} while (sub != 0); // O loop continua enquanto 'sub' for diferente de 0.
 }
 
+// Permite trocar em tempo de execução o backend usado pelo coletorNetwork.
+void configurarBackendRede() {
+	std::cout << "\n\033[1;33m=================== BACKEND DE REDE ===================\033[0m\n";
+	std::cout << " Atual: " << nomeBackendRede(backendRedeAtual()) << "\n";
+	std::cout << "\033[1m"; // deixa opções em negrito
+	std::cout << " 1. " << nomeBackendRede(BackendRede::SockDiag) << " (padrão)\n";
+	std::cout << " 2. " << nomeBackendRede(BackendRede::TextoProc) << "\n";
+	std::cout << " 0. Manter atual\n";
+	std::cout << " Escolha: ";
+	std::cout << "\033[0m";
+
+	int escolha = -1;
+	if (!(std::cin >> escolha)) { // Se a leitura falhar
+		std::cin.clear(); // Limpa o "estado de erro" do cin
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Limpa o buffer de entrada
+		std::cerr << "Opção Inválida. Backend mantido.\n";
+		return;
+	}
+
+	if (escolha == 1) definirBackendRede(BackendRede::SockDiag);
+	else if (escolha == 2) definirBackendRede(BackendRede::TextoProc);
+	else if (escolha != 0) std::cout << "Opção inválida. Backend mantido.\n";
+
+	std::cout << "Backend de rede: " << nomeBackendRede(backendRedeAtual()) << "\n";
+}
+
+// Permite escolher a política de fsync e a rotação dos CSVs gravados pelo perfilador de recursos.
+void configurarExportacaoCSV() {
+	ConfigEscritorCSV config = configuracaoCSV();
+	std::cout << "\n\033[1;33m================== EXPORTAÇÃO CSV ==================\033[0m\n";
+	std::cout << " Atual: " << nomePoliticaFsync(config.fsync) << ", rotação ";
+	if (config.rotacaoBytes) std::cout << "a cada " << config.rotacaoBytes / (1024 * 1024) << " MiB\n";
+	else std::cout << "desativada\n";
+	std::cout << "\033[1m"; // deixa opções em negrito
+	std::cout << " 1. " << nomePoliticaFsync(PoliticaFsync::Nunca) << " (padrão)\n";
+	std::cout << " 2. " << nomePoliticaFsync(PoliticaFsync::PorLote) << "\n";
+	std::cout << " 3. " << nomePoliticaFsync(PoliticaFsync::Periodica) << " (1 s)\n";
+	std::cout << " 0. Manter atual\n";
+	std::cout << " Escolha: ";
+	std::cout << "\033[0m";
+
+	int escolha = -1;
+	long long rotacaoMiB = -1;
+	if (!(std::cin >> escolha)) { // Se a leitura falhar
+		std::cin.clear(); // Limpa o "estado de erro" do cin
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Limpa o buffer de entrada
+		std::cerr << "Opção Inválida. Configuração mantida.\n";
+		return;
+	}
+	if (escolha == 1) config.fsync = PoliticaFsync::Nunca;
+	else if (escolha == 2) config.fsync = PoliticaFsync::PorLote;
+	else if (escolha == 3) config.fsync = PoliticaFsync::Periodica;
+	else if (escolha != 0) std::cout << "Opção inválida. Política mantida.\n";
+
+	std::cout << "Rotacionar o arquivo a cada quantos MiB? (0 = nunca): ";
+	if (!(std::cin >> rotacaoMiB) || rotacaoMiB < 0) {
+		std::cin.clear();
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		std::cerr << "Valor inválido. Rotação mantida.\n";
+	}
+	else {
+		config.rotacaoBytes = static_cast<uint64_t>(rotacaoMiB) * 1024 * 1024;
+	}
+
+	definirConfiguracaoCSV(config); // vale para o próximo monitoramento
+	std::cout << "Exportação CSV: " << nomePoliticaFsync(config.fsync) << ", rotação "
+		<< (config.rotacaoBytes ? std::to_string(config.rotacaoBytes / (1024 * 1024)) + " MiB" : std::string("desativada")) << "\n";
+}
+
+// Converte uma série binária gravada pelo perfilador (docs/dados<PID>.rmts) para CSV.
+void converterSerieBinaria() {
+	std::string entrada;
+	std::cout << "\n\033[1;33m============== CONVERTER SÉRIE BINÁRIA ==============\033[0m\n";
+	std::cout << "Arquivo .rmts (ex.: docs/dados1234.rmts): ";
+	if (!(std::cin >> entrada)) {
+		std::cin.clear();
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		std::cerr << "Entrada inválida.\n";
+		return;
+	}
+
+	// dados1234.rmts -> dados1234_convertido.csv (não colide com o CSV gravado pelo perfilador)
+	std::string saida = entrada;
+	size_t ponto = saida.rfind('.');
+	if (ponto != std::string::npos && saida.find('/', ponto) == std::string::npos) saida.erase(ponto);
+	saida += "_convertido.csv";
+
+	if (!converterSerieParaCSV(entrada, saida)) std::cerr << "Conversão não realizada.\n";
+}
+
+// Mostra as amostras recentes guardadas no anel mmap (docs/recentes.anel), com ou sem um monitor rodando.
+// Depois de um crash do perfilador, os últimos minutos de cada PID continuam lá.
+void lerAnelAmostras() {
+	LeitorAnel leitor;
+	std::cout << "\n\033[1;33m============== AMOSTRAS RECENTES (ANEL) ==============\033[0m\n";
+	if (!leitor.abrir("docs/recentes.anel")) return;
+
+	std::vector<ResumoSlotAnel> processos = leitor.processos();
+	std::cout << "Escritor: " << (leitor.escritorAtivo() ? "monitor em execução" : "nenhum (dados da última execução)")
+		<< " | " << processos.size() << " PIDs | até " << leitor.registrosPorProcesso() << " amostras por PID\n";
+	if (processos.empty()) return;
+
+	std::vector<RegistroAnel> registros;
+	printf("| %-8s | %-10s | %-20s | %-8s | %-12s |\n", "PID", "Amostras", "Última (UTC)", "CPU %", "RSS (kB)");
+	printf("--------------------------------------------------------------------------\n");
+	for (const ResumoSlotAnel &p : processos) {
+		if (!leitor.lerUltimos(p.slot, 1, registros) || registros.empty()) continue;
+		std::time_t segundos = static_cast<std::time_t>(p.atualizadoMs / 1000);
+		std::tm tm;
+		gmtime_r(&segundos, &tm);
+		char horario[32];
+		std::strftime(horario, sizeof(horario), "%Y-%m-%d %H:%M:%S", &tm);
+		printf("| %-8d | %-10lu | %-20s | %-8.2f | %-12lu |\n", p.pid, static_cast<unsigned long>(p.escritos), horario,
+			registros.back().usoCPU, static_cast<unsigned long>(registros.back().vmRss));
+	}
+
+	int pid = 0;
+	std::cout << "PID para ver as últimas 10 amostras (0 = voltar): ";
+	if (!(std::cin >> pid)) {
+		std::cin.clear();
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		return;
+	}
+	for (const ResumoSlotAnel &p : processos) {
+		if (p.pid != pid || !leitor.lerUltimos(p.slot, 10, registros)) continue;
+		printf("| %-13s | %-8s | %-12s | %-13s | %-13s |\n", "Instante (ms)", "CPU %", "RSS (kB)", "Leitura KiB/s", "Escrita KiB/s");
+		for (const RegistroAnel &r : registros)
+			printf("| %-13lld | %-8.2f | %-12lu | %-13.1f | %-13.1f |\n", static_cast<long long>(r.instanteMs), r.usoCPU,
+				static_cast<unsigned long>(r.vmRss), r.taxaLeituraTotal, r.taxaEscritaTotal);
+		break; // o mesmo PID pode ter mais de um slot (PID reutilizado): mostra o mais recente
+	}
+}
+
+// Consultas em janela sobre o histórico em memória (perfiladores das opções 3 e 6 nesta execução).
+// Cada consulta lê só o nível que cobre a janela, sem reabrir os CSVs.
+void consultarHistorico() {
+	HistoricoMetricas &historico = HistoricoMetricas::padrao();
+	std::cout << "\n\033[1;33m============== HISTÓRICO EM MEMÓRIA ==============\033[0m\n";
+	std::vector<ResumoSerieHistorico> series = historico.series();
+	std::cout << series.size() << " de " << historico.capacidade() << " séries | "
+		<< historico.bytesReservados() / 1024 << " KiB reservados | bruto 10 min, 10 s por 6 h, 1 min por 7 dias\n";
+	if (series.empty()) {
+		std::cout << "Nenhum processo monitorado nesta execução.\n";
+		return;
+	}
+
+	printf("| %-8s | %-12s | %-12s | %-18s | %-10s |\n", "PID", "Amostras", "Retido (min)", "Última (s atrás)", "Estado");
+	printf("---------------------------------------------------------------------------\n");
+	int64_t agora = instanteRealMs();
+	for (const ResumoSerieHistorico &s : series)
+		printf("| %-8d | %-12lu | %-12.1f | %-16.1f | %-10s |\n", s.pid, static_cast<unsigned long>(s.amostras),
+			static_cast<double>(s.atualizadoMs - s.primeiroMs) / 60000.0, static_cast<double>(agora - s.atualizadoMs) / 1000.0,
+			s.emUso ? "gravando" : "encerrado");
+
+	int pid = 0;
+	double minutos = 0, percentil = 95;
+	std::cout << "PID para consultar (0 = voltar): ";
+	if (!(std::cin >> pid) || pid == 0) {
+		std::cin.clear();
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		return;
+	}
+	std::cout << "Janela, em minutos (ex.: 15, 60, 1440): ";
+	std::cin >> minutos;
+	std::cout << "Percentil (ex.: 95): ";
+	std::cin >> percentil;
+	if (std::cin.fail() || minutos <= 0 || percentil <= 0 || percentil > 100) {
+		std::cin.clear();
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		std::cout << "Entrada inválida.\n";
+		return;
+	}
+
+	int64_t janelaMs = static_cast<int64_t>(minutos * 60000.0);
+	printf("| %-17s | %-13s | %-13s | %-13s | p%-11.1f | %-10s | %-7s |\n", "Métrica", "Mínimo", "Média", "Máximo", percentil, "Amostras", "Nível");
+	printf("------------------------------------------------------------------------------------------------------\n");
+	ConsultaHistorico r;
+	for (size_t m = 0; m < NUM_METRICAS_HISTORICO; ++m) {
+		MetricaHistorico metrica = static_cast<MetricaHistorico>(m);
+		if (!historico.consultar(pid, metrica, janelaMs, percentil, r)) {
+			std::cout << "PID " << pid << " sem histórico.\n";
+			return;
+		}
+		printf("| %-16s | %-12.2f | %-12.2f | %-12.2f | %-11.2f%s | %-10lu | %-6s |\n", nomeMetricaHistorico(metrica),
+			r.minimo, r.media, r.maximo, r.percentil, r.percentilAproximado ? "~" : " ",
+			static_cast<unsigned long>(r.amostras), nomeNivelHistorico(r.nivel));
+	}
+	printf("======================================================================================================\n");
+	std::cout << "Janela efetiva: " << static_cast<double>(r.fimMs - r.inicioMs) / 60000.0 << " min até a última amostra"
+		<< (r.percentilAproximado ? " (~ = percentil das médias de cada janela do nível)" : "") << "\n";
+}
+
+// Liga e desliga o servidor HTTP de métricas (OpenMetrics). Os perfiladores das opções 3 e 6 publicam
+// um snapshot por segundo enquanto ele estiver ativo; cada GET /metrics devolve o último, sem coletar.
+void configurarServidorMetricas() {
+	ServidorMetricas &servidor = ServidorMetricas::padrao();
+	std::cout << "\n\033[1;33m============== SERVIDOR DE MÉTRICAS ==============\033[0m\n";
+	if (servidor.ativo()) {
+		std::cout << " Escutando em:";
+		for (const std::string &endereco : servidor.enderecos()) std::cout << " " << endereco;
+		std::cout << " | " << servidor.requisicoes() << " requisições atendidas\n";
+	}
+	else {
+		std::cout << " Desligado\n";
+	}
+	std::cout << "\033[1m"; // deixa opções em negrito
+	std::cout << " 1. Escutar em porta TCP (127.0.0.1)\n";
+	std::cout << " 2. Escutar em socket Unix\n";
+	std::cout << " 3. Desligar\n";
+	std::cout << " 0. Voltar\n";
+	std::cout << " Escolha: ";
+	std::cout << "\033[0m";
+
+	int escolha = -1;
+	if (!(std::cin >> escolha)) { // Se a leitura falhar
+		std::cin.clear(); // Limpa o "estado de erro" do cin
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Limpa o buffer de entrada
+		std::cerr << "Opção Inválida.\n";
+		return;
+	}
+	if (escolha == 1) {
+		int porta = -1;
+		std::cout << "Porta (ex.: 9101; 0 = escolhida pelo sistema): ";
+		if (!(std::cin >> porta) || porta < 0 || porta > 65535) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cerr << "Porta inválida.\n";
+			return;
+		}
+		if (!servidor.escutarTCP(static_cast<uint16_t>(porta))) return;
+	}
+	else if (escolha == 2) {
+		std::string caminho;
+		std::cout << "Caminho do socket (ex.: /tmp/resource-monitor.sock): ";
+		std::cin >> caminho;
+		if (!servidor.escutarUnix(caminho)) return;
+	}
+	else if (escolha == 3) {
+		servidor.parar();
+		std::cout << "Servidor de métricas desligado.\n";
+		return;
+	}
+	else {
+		return;
+	}
+	std::cout << "Servidor de métricas em:";
+	for (const std::string &endereco : servidor.enderecos()) std::cout << " " << endereco;
+	std::cout << " (GET /metrics)\n";
+}
+
 // Esta é a função principal, o ponto de entrada do programa.
 int main() {
 	int opcao; // Variável para armazenar a escolha do menu principal.
@@ -865,6 +1450,13 @@ int main() {
 		std::cout << " 2. Analisar Namespaces\n";
 		std::cout << " 3. Perfilador de Recursos\n";
 		std::cout << " 4. Executar Experimentos\n";
+		std::cout << " 5. Configurar backend de rede\n";
+		std::cout << " 6. Perfilador de múltiplos processos\n";
+		std::cout << " 7. Configurar exportação CSV\n";
+		std::cout << " 8. Converter série binária (.rmts) para CSV\n";
+		std::cout << " 9. Amostras recentes (anel mmap)\n";
+		std::cout << "10. Consultar histórico em memória\n";
+		std::cout << "11. Servidor de métricas (OpenMetrics)\n";
 		std::cout << " 0. Sair\n";
 		std::cout << " Escolha: ";
 		std::cout << "\033[0m"; // Reseta as cores
@@ -898,6 +1490,41 @@ int main() {
 			break; // Sai do 'switch'.
 		}
 
+		case 5: { // Se 'opcao' for 5
+			configurarBackendRede(); // Escolhe entre sock_diag e /proc/net.
+			break; // Sai do 'switch'.
+		}
+
+		case 6: { // Se 'opcao' for 6
+			profilerMultiplo(); // Monitora vários PIDs (lista, nome ou cgroup) no mesmo laço.
+			break; // Sai do 'switch'.
+		}
+
+		case 7: { // Se 'opcao' for 7
+			configurarExportacaoCSV(); // Política de fsync e rotação dos CSVs.
+			break; // Sai do 'switch'.
+		}
+
+		case 8: { // Se 'opcao' for 8
+			converterSerieBinaria(); // .rmts -> CSV com as mesmas colunas do perfilador.
+			break; // Sai do 'switch'.
+		}
+
+		case 9: { // Se 'opcao' for 9
+			lerAnelAmostras(); // Últimas amostras de cada PID, inclusive de uma execução interrompida.
+			break; // Sai do 'switch'.
+		}
+
+		case 10: { // Se 'opcao' for 10
+			consultarHistorico(); // Mín/média/máx/percentil em janela, pelos agregados em memória.
+			break; // Sai do 'switch'.
+		}
+
+		case 11: { // Se 'opcao' for 11
+			configurarServidorMetricas(); // HTTP em loopback/socket Unix com o último snapshot dos perfiladores.
+			break; // Sai do 'switch'.
+		}
+
 		case 0: // Se 'opcao' for 0
 			std::cout << "Encerrando...\n"; // Imprime mensagem de saída.
 			break; // Sai do 'switch'.
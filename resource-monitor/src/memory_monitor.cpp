@@ -10,67 +10,40 @@
 #include <vector>
 #include <filesystem>
 #include "monitor.h"
+#include "procfs.h"
 
-bool coletorMemoria(StatusProcesso &medicao) {
-    int pid = medicao.PID; // pega o PID do processo monitorado
+ColetorSmaps::ColetorSmaps(std::chrono::milliseconds intervalo) : intervaloMinimo(intervalo) {}
 
-    //Verifica se o processo existe
-    if (!processoExiste(pid)) {
-        std::cerr << "Erro: processo " << pid << " inexistente.\n";
-        return false; // retorna false se processo não existe
-    }
-
-    //Verifica se temos permissão para acessar arquivos do processo
-    if (!temPermissao(pid)) {
-        std::cerr << "Erro: sem permissão para acessar processo " << pid << ".\n";
-        return false; // retorna false se não há permissão
-    }
+void ColetorSmaps::definirIntervaloMinimo(std::chrono::milliseconds intervalo) {
+    intervaloMinimo = intervalo;
+    if (intervaloMinimo.count() <= 0) amostras.clear();
+}
 
-    //Coleta memória virtual (VmSize), swap (VmSwap) e residente (VmRSS)
-    std::string pathStatus = "/proc/" + std::to_string(pid) + "/status"; // caminho do arquivo status
-    std::ifstream arquivoStatus(pathStatus); // abre arquivo status
-    if (!arquivoStatus.is_open()) {
-        std::cerr << "Erro: não foi possível abrir " << pathStatus << "\n";
-        std::cerr << "O processo encerrou ou não possui permissões para o arquivo\n\n";
-        return false; // retorna false se não abriu
-    }
+bool ColetorSmaps::coletar(int pid, MemoriaDetalhada &memoria, uint64_t starttime) {
+    auto agora = std::chrono::steady_clock::now();
+    usouCache = false;
 
-    std::string linha;
-    while (std::getline(arquivoStatus, linha)) { // lê linha por linha
-        if (linha.rfind("VmSize:", 0) == 0) // começa com VmSize
-            sscanf(linha.c_str(), "VmSize: %lu", &medicao.vmSize); // atualiza vmSize
-        else if (linha.rfind("VmSwap:", 0) == 0) // começa com VmSwap
-            sscanf(linha.c_str(), "VmSwap: %lu", &medicao.vmSwap); // atualiza vmSwap
-        else if (linha.rfind("VmRSS:", 0) == 0) // começa com VmRSS
-            sscanf(linha.c_str(), "VmRSS: %lu", &medicao.vmRss); // atualiza vmRss
+    // Dentro do intervalo mínimo devolve a última amostra do mesmo processo sem pedir a varredura ao kernel
+    auto it = amostras.find(pid);
+    if (it != amostras.end() && it->second.starttime == starttime && agora - it->second.leitura < intervaloMinimo) {
+        memoria = it->second.memoria;
+        usouCache = true;
+        return true;
     }
 
-    //Coleta de page faults
-    std::string pathStat = "/proc/" + std::to_string(pid) + "/stat"; // caminho do arquivo stat
-    std::ifstream arquivoStat(pathStat); // abre arquivo stat
-    if (!arquivoStat.is_open()) {
-        std::cerr << "Erro: não foi possível abrir " << pathStat << "\n";
-        std::cerr << "O processo encerrou ou não possui permissões para o arquivo\n\n";
-        return false; // retorna false se não abriu
+    std::string_view conteudo; // conteúdo relido pelo descritor mantido na sessão
+    if (!sessao.ler(pid, ArquivoProc::SmapsRollup, conteudo)) {
+        if (it != amostras.end()) amostras.erase(it);
+        return false; // processo encerrou, sem permissão (ptrace) ou kernel sem smaps_rollup
     }
 
-    unsigned long majorFault = 0, minorFault = 0; // variáveis para page faults
-    std::getline(arquivoStat, linha); // lê primeira linha inteira
-    auto aposParenteses = linha.rfind(')'); // procura fechamento de parêntese (nome do processo)
-    std::string depois = linha.substr(aposParenteses + 1); // pega substring após parêntese
-    std::istringstream fluxo(depois); // cria fluxo de leitura
-    std::string iterador;
+    parseSmapsRollup(conteudo, memoria);
+    if (intervaloMinimo.count() <= 0) return true; // sem limite: nada a guardar
 
-    // pular os primeiros 7 campos após o parêntese
-    for (int i = 1; i <= 7; ++i)
-        fluxo >> iterador;
-
-    fluxo >> minorFault; // captura minor faults
-    fluxo >> iterador;   // pular campo desnecessário
-    fluxo >> majorFault; // captura major faults
-
-    medicao.minfault = minorFault; // atualiza struct
-    medicao.mjrfault = majorFault; // atualiza struct
-
-    return true; // retorna true se tudo ocorreu sem erro
+    if (it == amostras.end() && amostras.size() >= LIMITE_AMOSTRAS) {
+        // PIDs que não voltaram a ser pedidos: uma amostra vencida seria relida de qualquer forma
+        std::erase_if(amostras, [&](const auto &par) { return agora - par.second.leitura >= intervaloMinimo; });
+    }
+    amostras[pid] = AmostraSmaps{ starttime, agora, memoria };
+    return true;
 }
@@ -0,0 +1,556 @@
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "metricas.h"
+#include "cgroup.h"
+#include "psi.h"
+
+// ---- RenderizadorMetricas ----
+
+// Índices das famílias, na ordem em que aparecem no snapshot
+enum FamiliaMetrica : size_t {
+    CPU_PROCESSO, CPU_MODO_PROCESSO, ESPERA_CPU_PROCESSO, USO_CPU_PROCESSO, THREADS_PROCESSO, TROCAS_CONTEXTO,
+    MEMORIA_PROCESSO, FALTAS_PAGINA, IO_BYTES_PROCESSO, IO_CHAMADAS_PROCESSO, IO_TAXA_PROCESSO, FILA_SOCKETS,
+    CONEXOES_PROCESSO,
+    CPU_CGROUP, CPU_MODO_CGROUP, PERIODOS_CGROUP, LIMITADO_CGROUP, MEMORIA_CGROUP, IO_BYTES_CGROUP, IO_OPERACOES_CGROUP,
+    PRESSAO_TOTAL, PRESSAO_MEDIA,
+    NUM_FAMILIAS
+};
+
+// Nome, tipo, unidade e ajuda de cada família; as amostras de contadores recebem o sufixo "_total"
+static const char* const DESCRICOES[NUM_FAMILIAS][4] = {
+    { "resmon_process_cpu_seconds", "counter", "seconds", "CPU time consumed by the process (user + system)" },
+    { "resmon_process_cpu_mode_seconds", "counter", "seconds", "CPU time consumed by the process per mode (tick resolution)" },
+    { "resmon_process_cpu_wait_seconds", "counter", "seconds", "Time spent waiting on a run queue (schedstat)" },
+    { "resmon_process_cpu_usage_percent", "gauge", "percent", "CPU usage over the last interval (100 = one core)" },
+    { "resmon_process_threads", "gauge", "", "Number of threads" },
+    { "resmon_process_context_switches", "counter", "", "Context switches" },
+    { "resmon_process_memory_bytes", "gauge", "bytes", "Process memory (VmRSS, VmSize, VmSwap)" },
+    { "resmon_process_page_faults", "counter", "", "Page faults" },
+    { "resmon_process_io_bytes", "counter", "bytes", "Bytes read and written (disk: storage layer; total: rchar/wchar)" },
+    { "resmon_process_io_syscalls", "counter", "", "Read and write system calls" },
+    { "resmon_process_io_rate_bytes_per_second", "gauge", "bytes_per_second", "I/O rate over the last interval" },
+    { "resmon_process_socket_queue_bytes", "gauge", "bytes", "Bytes queued on the process sockets" },
+    { "resmon_process_connections", "gauge", "", "Active network connections" },
+    { "resmon_cgroup_cpu_usage_seconds", "counter", "seconds", "cgroup cpu.stat usage_usec" },
+    { "resmon_cgroup_cpu_mode_seconds", "counter", "seconds", "cgroup cpu.stat user_usec/system_usec" },
+    { "resmon_cgroup_cpu_periods", "counter", "", "cgroup cpu.stat nr_periods/nr_throttled" },
+    { "resmon_cgroup_cpu_throttled_seconds", "counter", "seconds", "cgroup cpu.stat throttled_usec" },
+    { "resmon_cgroup_memory_current_bytes", "gauge", "bytes", "cgroup memory.current" },
+    { "resmon_cgroup_io_bytes", "counter", "bytes", "cgroup io.stat bytes per device" },
+    { "resmon_cgroup_io_operations", "counter", "", "cgroup io.stat operations per device" },
+    { "resmon_pressure_stall_seconds", "counter", "seconds", "PSI total stall time" },
+    { "resmon_pressure_stall_percent", "gauge", "percent", "PSI stall averages" },
+};
+
+RenderizadorMetricas::RenderizadorMetricas() {
+    familias.reserve(NUM_FAMILIAS);
+    for (const auto &d : DESCRICOES) familias.push_back(Familia{ d[0], d[1], d[2], d[3], {} });
+}
+
+// Valor no formato OpenMetrics: inteiros sem expoente até 1e15, NaN e infinitos com os nomes do formato
+static void anexarValor(std::string &saida, double valor) {
+    if (std::isnan(valor)) { saida += "NaN"; return; }
+    if (std::isinf(valor)) { saida += valor > 0 ? "+Inf" : "-Inf"; return; }
+    char buffer[32];
+    int n = snprintf(buffer, sizeof(buffer), "%.15g", valor);
+    saida.append(buffer, static_cast<size_t>(n));
+}
+
+// nome="valor" com \, " e quebra de linha escapados (caminhos de cgroup vêm do sistema)
+static std::string rotulo(const char *nome, std::string_view valor) {
+    std::string r = nome;
+    r += "=\"";
+    for (char c : valor) {
+        if (c == '\\') r += "\\\\";
+        else if (c == '"') r += "\\\"";
+        else if (c == '\n') r += "\\n";
+        else r += c;
+    }
+    r += '"';
+    return r;
+}
+
+void RenderizadorMetricas::amostra(size_t familia, const std::string &rotulos, double valor) {
+    Familia &f = familias[familia];
+    f.amostras += f.nome;
+    if (f.tipo[0] == 'c') f.amostras += "_total";
+    if (!rotulos.empty()) {
+        f.amostras += '{';
+        f.amostras += rotulos;
+        f.amostras += '}';
+    }
+    f.amostras += ' ';
+    anexarValor(f.amostras, valor);
+    f.amostras += '\n';
+}
+
+void RenderizadorMetricas::processo(const StatusProcesso &m, const calculoMedicao &c) {
+    const std::string pid = rotulo("pid", std::to_string(m.PID));
+    const double KIB = 1024.0; // VmRSS/VmSize/VmSwap em kB e taxas em KiB/s
+
+    amostra(CPU_PROCESSO, pid, m.tempoCPU);
+    amostra(CPU_MODO_PROCESSO, pid + ",mode=\"user\"", m.utime);
+    amostra(CPU_MODO_PROCESSO, pid + ",mode=\"system\"", m.stime);
+    amostra(ESPERA_CPU_PROCESSO, pid, m.esperaCPU);
+    amostra(USO_CPU_PROCESSO, pid, c.usoCPU);
+    amostra(THREADS_PROCESSO, pid, m.threads);
+    amostra(TROCAS_CONTEXTO, pid + ",kind=\"voluntary\"", m.contextSwitchfree);
+    amostra(TROCAS_CONTEXTO, pid + ",kind=\"involuntary\"", m.contextSwitchforced);
+
+    amostra(MEMORIA_PROCESSO, pid + ",type=\"resident\"", static_cast<double>(m.vmRss) * KIB);
+    amostra(MEMORIA_PROCESSO, pid + ",type=\"virtual\"", static_cast<double>(m.vmSize) * KIB);
+    amostra(MEMORIA_PROCESSO, pid + ",type=\"swap\"", static_cast<double>(m.vmSwap) * KIB);
+    amostra(FALTAS_PAGINA, pid + ",kind=\"minor\"", static_cast<double>(m.minfault));
+    amostra(FALTAS_PAGINA, pid + ",kind=\"major\"", static_cast<double>(m.mjrfault));
+
+    amostra(IO_BYTES_PROCESSO, pid + ",direction=\"read\",source=\"disk\"", static_cast<double>(m.bytesLidos));
+    amostra(IO_BYTES_PROCESSO, pid + ",direction=\"write\",source=\"disk\"", static_cast<double>(m.bytesEscritos));
+    amostra(IO_BYTES_PROCESSO, pid + ",direction=\"read\",source=\"total\"", static_cast<double>(m.rchar));
+    amostra(IO_BYTES_PROCESSO, pid + ",direction=\"write\",source=\"total\"", static_cast<double>(m.wchar));
+    amostra(IO_CHAMADAS_PROCESSO, pid + ",direction=\"read\"", static_cast<double>(m.syscallLeitura));
+    amostra(IO_CHAMADAS_PROCESSO, pid + ",direction=\"write\"", static_cast<double>(m.syscallEscrita));
+    amostra(IO_TAXA_PROCESSO, pid + ",direction=\"read\",source=\"disk\"", c.taxaLeituraDisco * KIB);
+    amostra(IO_TAXA_PROCESSO, pid + ",direction=\"write\",source=\"disk\"", c.taxaEscritaDisco * KIB);
+    amostra(IO_TAXA_PROCESSO, pid + ",direction=\"read\",source=\"total\"", c.taxaLeituraTotal * KIB);
+    amostra(IO_TAXA_PROCESSO, pid + ",direction=\"write\",source=\"total\"", c.taxaEscritaTotal * KIB);
+
+    amostra(FILA_SOCKETS, pid + ",direction=\"rx\"", static_cast<double>(m.bytesRxfila));
+    amostra(FILA_SOCKETS, pid + ",direction=\"tx\"", static_cast<double>(m.bytesTxfila));
+    amostra(CONEXOES_PROCESSO, pid, m.conexoesAtivas);
+}
+
+// PSI de uma origem (sistema ou cgroup): total acumulado e médias de 10/60/300 s das linhas some e full
+void RenderizadorMetricas::pressao(const std::string &origem, RecursoPSI recurso, const PressaoPSI &p) {
+    const std::string base = (origem.empty() ? std::string() : origem + ",") + rotulo("resource", nomeRecursoPSI(recurso));
+    const LinhaPSI *linhas[2] = { &p.some, &p.full };
+    const char *tipos[2] = { "some", "full" };
+    for (int i = 0; i < 2; ++i) {
+        const std::string rotulos = base + ",kind=\"" + tipos[i] + "\"";
+        amostra(PRESSAO_TOTAL, rotulos, static_cast<double>(linhas[i]->totalUs) / 1e6);
+        amostra(PRESSAO_MEDIA, rotulos + ",window=\"10s\"", linhas[i]->avg10);
+        amostra(PRESSAO_MEDIA, rotulos + ",window=\"60s\"", linhas[i]->avg60);
+        amostra(PRESSAO_MEDIA, rotulos + ",window=\"300s\"", linhas[i]->avg300);
+    }
+}
+
+void RenderizadorMetricas::cgroup(const std::string &caminho) {
+    CGroupManager cg;
+    const std::string grupo = rotulo("cgroup", caminho);
+
+    CpuStatCgroup cpu;
+    if (cg.readCpuStat(caminho, cpu)) {
+        amostra(CPU_CGROUP, grupo, static_cast<double>(cpu.usageUsec) / 1e6);
+        amostra(CPU_MODO_CGROUP, grupo + ",mode=\"user\"", static_cast<double>(cpu.userUsec) / 1e6);
+        amostra(CPU_MODO_CGROUP, grupo + ",mode=\"system\"", static_cast<double>(cpu.systemUsec) / 1e6);
+        amostra(PERIODOS_CGROUP, grupo + ",kind=\"elapsed\"", static_cast<double>(cpu.nrPeriods));
+        amostra(PERIODOS_CGROUP, grupo + ",kind=\"throttled\"", static_cast<double>(cpu.nrThrottled));
+        amostra(LIMITADO_CGROUP, grupo, static_cast<double>(cpu.throttledUsec) / 1e6);
+    }
+
+    // memory.current e io.stat não existem no cgroup raiz nem com o controlador desabilitado; os leitores
+    // do CGroupManager avisam no cerr, então a existência é conferida antes
+    if (access((cg.basePath + caminho + "/memory.current").c_str(), R_OK) == 0) {
+        auto memoria = cg.readMemoryUsage(caminho);
+        auto atual = memoria.find("memory.current");
+        if (atual != memoria.end()) amostra(MEMORIA_CGROUP, grupo, static_cast<double>(atual->second));
+    }
+    if (access((cg.basePath + caminho + "/io.stat").c_str(), R_OK) == 0) {
+        for (const BlkIOStats &d : cg.readBlkIOUsage(caminho)) {
+            const std::string dispositivo = grupo + "," + rotulo("device", std::to_string(d.major) + ":" + std::to_string(d.minor));
+            amostra(IO_BYTES_CGROUP, dispositivo + ",direction=\"read\"", static_cast<double>(d.rbytes));
+            amostra(IO_BYTES_CGROUP, dispositivo + ",direction=\"write\"", static_cast<double>(d.wbytes));
+            amostra(IO_BYTES_CGROUP, dispositivo + ",direction=\"discard\"", static_cast<double>(d.dbytes));
+            amostra(IO_OPERACOES_CGROUP, dispositivo + ",direction=\"read\"", static_cast<double>(d.rios));
+            amostra(IO_OPERACOES_CGROUP, dispositivo + ",direction=\"write\"", static_cast<double>(d.wios));
+            amostra(IO_OPERACOES_CGROUP, dispositivo + ",direction=\"discard\"", static_cast<double>(d.dios));
+        }
+    }
+
+    for (RecursoPSI recurso : { RecursoPSI::CPU, RecursoPSI::Memoria, RecursoPSI::IO }) {
+        PressaoPSI p;
+        if (cg.readPressure(caminho, recurso, p)) pressao(grupo, recurso, p);
+    }
+}
+
+void RenderizadorMetricas::pressaoSistema() {
+    for (RecursoPSI recurso : { RecursoPSI::CPU, RecursoPSI::Memoria, RecursoPSI::IO }) {
+        PressaoPSI p;
+        if (lerPressaoSistema(recurso, p)) pressao("", recurso, p);
+    }
+}
+
+std::string RenderizadorMetricas::finalizar() {
+    size_t tamanho = 8;
+    for (const Familia &f : familias) tamanho += f.amostras.size() + 256;
+    std::string texto;
+    texto.reserve(tamanho);
+    for (Familia &f : familias) {
+        if (f.amostras.empty()) continue;
+        texto += "# TYPE "; texto += f.nome; texto += ' '; texto += f.tipo; texto += '\n';
+        if (f.unidade[0]) { texto += "# UNIT "; texto += f.nome; texto += ' '; texto += f.unidade; texto += '\n'; }
+        texto += "# HELP "; texto += f.nome; texto += ' '; texto += f.ajuda; texto += '\n';
+        texto += f.amostras;
+        f.amostras.clear();
+    }
+    texto += "# EOF\n";
+    return texto;
+}
+
+// ---- ServidorMetricas ----
+
+// Os 32 bits altos do dado de cada evento do epoll dizem o que é o descritor (o fd fica nos 32 baixos)
+static constexpr uint64_t TIPO_CONEXAO = 0, TIPO_ESCUTA = 1, TIPO_PARAR = 2;
+static constexpr size_t LIMITE_REQUISICAO = 8192; // linha de requisição + cabeçalhos
+static constexpr size_t MAXIMO_CONEXOES = 64;
+static const char* const TIPO_OPENMETRICS = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+static bool registrarEpoll(int epfd, int operacao, int fd, uint64_t tipo, uint32_t eventos) {
+    epoll_event ev{};
+    ev.events = eventos;
+    ev.data.u64 = (tipo << 32) | static_cast<uint32_t>(fd);
+    return epoll_ctl(epfd, operacao, fd, &ev) == 0;
+}
+
+ServidorMetricas::ServidorMetricas() = default;
+
+ServidorMetricas::~ServidorMetricas() {
+    parar();
+}
+
+ServidorMetricas& ServidorMetricas::padrao() {
+    static ServidorMetricas servidor;
+    return servidor;
+}
+
+bool ServidorMetricas::adicionarEscuta(int fd, std::string endereco, std::string caminhoUnix) {
+    std::lock_guard<std::mutex> lock(trava);
+    if (epfd < 0) {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        eventoParar = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epfd < 0 || eventoParar < 0 || !registrarEpoll(epfd, EPOLL_CTL_ADD, eventoParar, TIPO_PARAR, EPOLLIN)) {
+            std::cerr << "Erro ao criar epoll do servidor de métricas: " << strerror(errno) << "\n";
+            if (epfd >= 0) close(epfd);
+            if (eventoParar >= 0) close(eventoParar);
+            epfd = eventoParar = -1;
+            close(fd);
+            return false;
+        }
+    }
+    // epoll_ctl pode ser chamado com a thread já dentro do epoll_wait: a nova escuta passa a valer na hora
+    if (!registrarEpoll(epfd, EPOLL_CTL_ADD, fd, TIPO_ESCUTA, EPOLLIN)) {
+        std::cerr << "Erro ao registrar " << endereco << " no epoll: " << strerror(errno) << "\n";
+        close(fd);
+        return false;
+    }
+    escutas.push_back(Escuta{ fd, std::move(endereco), std::move(caminhoUnix) });
+    if (!executando.load(std::memory_order_relaxed)) {
+        executando.store(true, std::memory_order_release);
+        thread = std::thread(&ServidorMetricas::executar, this);
+    }
+    return true;
+}
+
+bool ServidorMetricas::escutarTCP(uint16_t porta) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Erro ao criar socket TCP: " << strerror(errno) << "\n";
+        return false;
+    }
+    int um = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+
+    sockaddr_in endereco{};
+    endereco.sin_family = AF_INET;
+    endereco.sin_port = htons(porta);
+    endereco.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // nunca exposto fora da máquina
+    if (bind(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 || listen(fd, 64) < 0) {
+        std::cerr << "Erro ao escutar em 127.0.0.1:" << porta << ": " << strerror(errno) << "\n";
+        close(fd);
+        return false;
+    }
+    // Porta 0: o kernel escolhe; a real é lida de volta para aparecer no endereço
+    socklen_t tamanho = sizeof(endereco);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&endereco), &tamanho);
+    return adicionarEscuta(fd, "127.0.0.1:" + std::to_string(ntohs(endereco.sin_port)), "");
+}
+
+bool ServidorMetricas::escutarUnix(const std::string &caminho) {
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (caminho.empty() || caminho.size() >= sizeof(endereco.sun_path)) {
+        std::cerr << "Caminho de socket Unix inválido (máximo " << sizeof(endereco.sun_path) - 1 << " caracteres)\n";
+        return false;
+    }
+    std::memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+
+    // Um socket deixado por uma execução anterior impede o bind; qualquer outro tipo de arquivo é preservado
+    struct stat info;
+    if (lstat(caminho.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            std::cerr << caminho << " já existe e não é um socket\n";
+            return false;
+        }
+        unlink(caminho.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Erro ao criar socket Unix: " << strerror(errno) << "\n";
+        return false;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 || listen(fd, 64) < 0) {
+        std::cerr << "Erro ao escutar em " << caminho << ": " << strerror(errno) << "\n";
+        close(fd);
+        return false;
+    }
+    return adicionarEscuta(fd, "unix:" + caminho, caminho);
+}
+
+void ServidorMetricas::parar() {
+    if (thread.joinable()) {
+        uint64_t um = 1;
+        if (write(eventoParar, &um, sizeof(um)) < 0) std::cerr << "Erro ao sinalizar o servidor de métricas\n";
+        thread.join();
+    }
+    // Sem a thread, nada mais usa as conexões nem o epoll
+    for (auto &[fd, conexao] : conexoes) close(fd);
+    conexoes.clear();
+
+    std::lock_guard<std::mutex> lock(trava);
+    for (const Escuta &e : escutas) {
+        close(e.fd);
+        if (!e.caminhoUnix.empty()) unlink(e.caminhoUnix.c_str());
+    }
+    escutas.clear();
+    if (epfd >= 0) close(epfd);
+    if (eventoParar >= 0) close(eventoParar);
+    epfd = eventoParar = -1;
+    executando.store(false, std::memory_order_release);
+}
+
+std::vector<std::string> ServidorMetricas::enderecos() const {
+    std::lock_guard<std::mutex> lock(trava);
+    std::vector<std::string> lista;
+    for (const Escuta &e : escutas) lista.push_back(e.endereco);
+    return lista;
+}
+
+void ServidorMetricas::publicar(std::string texto) {
+    auto novo = texto.empty() ? nullptr : std::make_shared<const std::string>(std::move(texto));
+    std::lock_guard<std::mutex> lock(trava);
+    snapshot = std::move(novo); // respostas em envio mantêm o snapshot antigo vivo pelo próprio shared_ptr
+}
+
+void ServidorMetricas::executar() {
+    epoll_event eventos[64];
+    while (true) {
+        int n = epoll_wait(epfd, eventos, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Erro no epoll do servidor de métricas: " << strerror(errno) << "\n";
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            uint64_t tipo = eventos[i].data.u64 >> 32;
+            int fd = static_cast<int>(eventos[i].data.u64 & 0xffffffffu);
+            if (tipo == TIPO_PARAR) return;
+            if (tipo == TIPO_ESCUTA) {
+                aceitar(fd);
+                continue;
+            }
+            if (eventos[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP)) ler(fd); // erro aparece no recv
+            if ((eventos[i].events & EPOLLOUT) && conexoes.count(fd)) escrever(fd);
+        }
+    }
+}
+
+void ServidorMetricas::aceitar(int fd) {
+    while (true) {
+        int cliente = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (cliente < 0) return; // EAGAIN: fila de conexões vazia
+        if (conexoes.size() >= MAXIMO_CONEXOES || !registrarEpoll(epfd, EPOLL_CTL_ADD, cliente, TIPO_CONEXAO, EPOLLIN | EPOLLRDHUP)) {
+            close(cliente);
+            continue;
+        }
+        conexoes[cliente] = Conexao{};
+    }
+}
+
+void ServidorMetricas::fecharConexao(int fd) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    conexoes.erase(fd);
+}
+
+void ServidorMetricas::ler(int fd) {
+    auto it = conexoes.find(fd);
+    if (it == conexoes.end()) return;
+    Conexao &conexao = it->second;
+    if (conexao.entradaEncerrada) { // sem EPOLLIN registrado: só chega aqui por EPOLLERR/EPOLLHUP
+        fecharConexao(fd);
+        return;
+    }
+
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conexao.entrada.append(buffer, static_cast<size_t>(n));
+            if (conexao.entrada.size() > 2 * LIMITE_REQUISICAO) break; // o excesso é recusado em processar()
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) { // erro (ex.: ECONNRESET): não há a quem responder
+            fecharConexao(fd);
+            return;
+        }
+        // 0: o cliente encerrou o envio (shutdown(SHUT_WR) ou close), mas pode estar esperando a resposta.
+        // Para de observar a entrada (o EOF continuaria sinalizando EPOLLIN) e responde ao que já chegou
+        conexao.entradaEncerrada = true;
+        registrarEpoll(epfd, EPOLL_CTL_MOD, fd, TIPO_CONEXAO, conexao.aguardandoSaida ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        break;
+    }
+    processar(fd, conexao);
+}
+
+void ServidorMetricas::processar(int fd, Conexao &conexao) {
+    // Uma resposta por vez: requisições em pipeline esperam a anterior terminar de ser enviada
+    while (conexao.cabecalho.empty()) {
+        size_t fim = conexao.entrada.find("\r\n\r\n");
+        if (fim == std::string::npos) {
+            if (conexao.entrada.size() <= LIMITE_REQUISICAO) {
+                if (conexao.entradaEncerrada) fecharConexao(fd); // respostas enviadas e nada mais vai chegar
+                return; // requisição ainda incompleta
+            }
+            conexao.entrada.clear();
+            conexao.cabecalho = "HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            conexao.fecharAposEnvio = true;
+        } else {
+            responder(conexao, std::string_view(conexao.entrada).substr(0, fim + 2));
+            conexao.entrada.erase(0, fim + 4);
+        }
+        escrever(fd);
+        if (!conexoes.count(fd)) return; // fechada ao terminar o envio ou por erro
+    }
+}
+
+void ServidorMetricas::responder(Conexao &conexao, std::string_view requisicao) {
+    // Linha de requisição: "<método> <alvo> <versão>"
+    std::string_view linha = requisicao.substr(0, requisicao.find("\r\n"));
+    size_t espaco1 = linha.find(' ');
+    size_t espaco2 = espaco1 == std::string_view::npos ? std::string_view::npos : linha.find(' ', espaco1 + 1);
+    if (espaco2 == std::string_view::npos) {
+        conexao.cabecalho = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        conexao.fecharAposEnvio = true;
+        return;
+    }
+    std::string_view metodo = linha.substr(0, espaco1);
+    std::string_view alvo = linha.substr(espaco1 + 1, espaco2 - espaco1 - 1);
+    std::string_view versao = linha.substr(espaco2 + 1);
+    alvo = alvo.substr(0, alvo.find('?'));
+
+    // Keep-alive é o padrão no HTTP/1.1 e exceção no 1.0; o cabeçalho Connection decide quando presente
+    std::string cabecalhos(requisicao.substr(linha.size()));
+    std::transform(cabecalhos.begin(), cabecalhos.end(), cabecalhos.begin(), [](unsigned char c) { return std::tolower(c); });
+    bool manter = versao == "HTTP/1.1";
+    if (cabecalhos.find("\r\nconnection: close") != std::string::npos) manter = false;
+    else if (cabecalhos.find("\r\nconnection: keep-alive") != std::string::npos) manter = true;
+
+    bool cabeca = metodo == "HEAD";
+    const char *status = "200 OK";
+    bool metodoInvalido = metodo != "GET" && !cabeca;
+    std::shared_ptr<const std::string> corpo;
+    if (metodoInvalido) {
+        status = "405 Method Not Allowed";
+        manter = false; // um corpo eventual não é lido: a conexão não pode ser reaproveitada
+    } else if (alvo != "/metrics") {
+        status = "404 Not Found";
+    } else {
+        std::lock_guard<std::mutex> lock(trava);
+        corpo = snapshot;
+    }
+    // Nada publicado ainda (ou perfilador encerrado): exposição vazia, mas válida
+    static const auto vazio = std::make_shared<const std::string>("# EOF\n");
+    if (!metodoInvalido && alvo == "/metrics" && !corpo) corpo = vazio;
+
+    conexao.cabecalho = "HTTP/1.1 ";
+    conexao.cabecalho += status;
+    conexao.cabecalho += "\r\n";
+    if (corpo) {
+        conexao.cabecalho += "Content-Type: ";
+        conexao.cabecalho += TIPO_OPENMETRICS;
+        conexao.cabecalho += "\r\n";
+    }
+    if (metodoInvalido) conexao.cabecalho += "Allow: GET, HEAD\r\n";
+    conexao.cabecalho += "Content-Length: " + std::to_string(corpo ? corpo->size() : 0) + "\r\n";
+    conexao.cabecalho += manter ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    conexao.corpo = cabeca ? nullptr : std::move(corpo);
+    conexao.enviados = 0;
+    conexao.fecharAposEnvio = !manter;
+    atendidas.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ServidorMetricas::escrever(int fd) {
+    auto it = conexoes.find(fd);
+    if (it == conexoes.end()) return;
+    Conexao &conexao = it->second;
+
+    size_t tamanhoCorpo = conexao.corpo ? conexao.corpo->size() : 0;
+    size_t total = conexao.cabecalho.size() + tamanhoCorpo;
+    while (conexao.enviados < total) {
+        // Cabeçalho e snapshot saem num único sendmsg, sem copiar o snapshot para um buffer da conexão
+        iovec partes[2];
+        int numPartes = 0;
+        if (conexao.enviados < conexao.cabecalho.size()) {
+            partes[numPartes++] = { conexao.cabecalho.data() + conexao.enviados, conexao.cabecalho.size() - conexao.enviados };
+            if (tamanhoCorpo) partes[numPartes++] = { const_cast<char*>(conexao.corpo->data()), tamanhoCorpo };
+        } else {
+            size_t inicio = conexao.enviados - conexao.cabecalho.size();
+            partes[numPartes++] = { const_cast<char*>(conexao.corpo->data()) + inicio, tamanhoCorpo - inicio };
+        }
+        msghdr mensagem{};
+        mensagem.msg_iov = partes;
+        mensagem.msg_iovlen = static_cast<size_t>(numPartes);
+        ssize_t n = sendmsg(fd, &mensagem, MSG_NOSIGNAL); // cliente que fechou não gera SIGPIPE
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Socket cheio: continua quando o epoll avisar que há espaço
+                if (!conexao.aguardandoSaida)
+                    registrarEpoll(epfd, EPOLL_CTL_MOD, fd, TIPO_CONEXAO, conexao.entradaEncerrada ? EPOLLOUT : EPOLLIN | EPOLLOUT | EPOLLRDHUP);
+                conexao.aguardandoSaida = true;
+                return;
+            }
+            fecharConexao(fd);
+            return;
+        }
+        conexao.enviados += static_cast<size_t>(n);
+    }
+
+    conexao.cabecalho.clear();
+    conexao.corpo.reset();
+    conexao.enviados = 0;
+    if (conexao.fecharAposEnvio) {
+        fecharConexao(fd);
+        return;
+    }
+    if (conexao.aguardandoSaida) {
+        registrarEpoll(epfd, EPOLL_CTL_MOD, fd, TIPO_CONEXAO, conexao.entradaEncerrada ? 0 : EPOLLIN | EPOLLRDHUP);
+        conexao.aguardandoSaida = false;
+        processar(fd, conexao); // requisições que chegaram enquanto o envio esperava
+    }
+}
@@ -1,4 +1,5 @@
 ﻿#include "../include/namespace.h"
+#include "../include/processos.h"
 #include <algorithm>  // Para std::all_of (verificar se string é dígito) e std::sort
 #include <iostream>   // Para std::cout, std::cerr
 #include <filesystem> // Para std::filesystem (fs::exists, fs::directory_iterator)
@@ -105,12 +106,9 @@ void findProcessesInNamespace(const std::string& nsType, const std::string& nsId
 	std::string base = "/proc"; // Diretório base para procurar
 	bool encontrado = false; // Flag para imprimir o cabeçalho apenas uma vez
 
-	// Itera por todas as entradas em /proc
-	for (const auto& entry : fs::directory_iterator(base)) {
-		if (!entry.is_directory()) continue; // Pula arquivos (ex: /proc/version)
-		std::string pidStr = entry.path().filename(); // Pega o nome do diretório
-		// Verifica se o nome do diretório é composto apenas por dígitos (é um PID)
-		if (!std::all_of(pidStr.begin(), pidStr.end(), ::isdigit)) continue;
+	// Itera pelos processos da tabela (sem varrer /proc)
+	for (int pid : TabelaProcessos::padrao().pids()) {
+		std::string pidStr = std::to_string(pid); // PID como texto para montar o caminho
 
 		// Constrói o caminho para o arquivo de namespace específico (ex: /proc/123/ns/net)
 		std::string nsPath = base + "/" + pidStr + "/ns/" + nsType;
@@ -142,14 +140,10 @@ void reportSystemNamespaces() {
 	// Mapa: Chave (string, tipo) -> Valor (Set de strings, IDs únicos)
 	std::map<std::string, std::set<std::string>> mapa;
 
-	// Itera por todos os PIDs em /proc
-	for (const auto& entry : fs::directory_iterator("/proc")) {
-		if (!entry.is_directory()) continue; // Pula arquivos
-		std::string pidStr = entry.path().filename(); // Pega o nome
-		if (!std::all_of(pidStr.begin(), pidStr.end(), ::isdigit)) continue; // Pula se não for PID
-
+	// Itera por todos os PIDs da tabela de processos
+	for (int pid : TabelaProcessos::padrao().pids()) {
 		// Pega todos os namespaces para este PID
-		auto namespaces = getNamespacesOfProcess(std::stoi(pidStr));
+		auto namespaces = getNamespacesOfProcess(pid);
 		// Itera sobre os namespaces deste PID
 		for (auto& ns : namespaces)
 			// Insere o ID no set. O set automaticamente cuida da duplicidade.
@@ -377,12 +371,8 @@ void reportProcessCountsPerNamespace() {
 	std::map<std::string, std::map<std::string, int>> contagem;
 
 	// 1. Iterar por todos os processos
-	for (const auto& entry : fs::directory_iterator("/proc")) { // Itera em /proc
-		if (!entry.is_directory()) continue; // Pula arquivos
-		std::string pidStr = entry.path().filename(); // Pega nome
-		if (!std::all_of(pidStr.begin(), pidStr.end(), ::isdigit)) continue; // Pula se não for PID
-
-		std::string nsDir = entry.path().string() + "/ns"; // Caminho /proc/<pid>/ns
+	for (int pid : TabelaProcessos::padrao().pids()) { // Itera pela tabela de processos
+		std::string nsDir = "/proc/" + std::to_string(pid) + "/ns"; // Caminho /proc/<pid>/ns
 		if (!fs::exists(nsDir)) continue; // Pula se não existir
 
 		// 2. Iterar pelos namespaces desse processo
@@ -0,0 +1,559 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include "monitor.h"
+#include "parse.h"
+#include "rede.h"
+
+// Backend atual; sock_diag por padrão, com queda automática para o texto se o netlink falhar
+static BackendRede backendAtual = BackendRede::SockDiag;
+
+void definirBackendRede(BackendRede backend) {
+    backendAtual = backend;
+    CacheSockets::padrao().invalidar(); // tabelas montadas pelo backend anterior deixam de valer
+}
+
+BackendRede backendRedeAtual() {
+    return backendAtual;
+}
+
+const char* nomeBackendRede(BackendRede backend) {
+    return backend == BackendRede::SockDiag ? "netlink sock_diag" : "/proc/net (texto)";
+}
+
+// ---- Tabela plana inode -> filas ----
+
+size_t TabelaSockets::posicao(unsigned long inode) const {
+    // Hash de Fibonacci: inodes costumam ser sequenciais, a multiplicação espalha os bits altos
+    return static_cast<size_t>((static_cast<uint64_t>(inode) * 0x9E3779B97F4A7C15ull) >> 32) & (entradas.size() - 1);
+}
+
+void TabelaSockets::limpar() {
+    for (auto &e : entradas) e.inode = 0; // mantém a memória para o próximo tick
+    ocupadas = 0;
+}
+
+void TabelaSockets::crescer() {
+    std::vector<Entrada> antigas;
+    antigas.swap(entradas);
+    entradas.assign(antigas.empty() ? 1024 : antigas.size() * 2, Entrada{});
+    ocupadas = 0;
+    for (const auto &e : antigas)
+        if (e.inode != 0) inserir(e.inode, e.filas);
+}
+
+void TabelaSockets::inserir(unsigned long inode, const FilasSocket &f) {
+    if ((ocupadas + 1) * 4 > entradas.size() * 3) crescer(); // fator de carga máximo de 75%
+    size_t mascara = entradas.size() - 1;
+    for (size_t i = posicao(inode);; i = (i + 1) & mascara) { // sondagem linear
+        if (entradas[i].inode == inode) { entradas[i].filas = f; return; } // mesmo socket em outra tabela
+        if (entradas[i].inode == 0) {
+            entradas[i].inode = inode;
+            entradas[i].filas = f;
+            ++ocupadas;
+            return;
+        }
+    }
+}
+
+const FilasSocket* TabelaSockets::buscar(unsigned long inode) const {
+    if (ocupadas == 0) return nullptr;
+    size_t mascara = entradas.size() - 1;
+    for (size_t i = posicao(inode);; i = (i + 1) & mascara) { // para no primeiro slot vazio
+        if (entradas[i].inode == inode) return &entradas[i].filas;
+        if (entradas[i].inode == 0) return nullptr;
+    }
+}
+
+// ---- Backend texto: /proc/<pid>/net/{tcp,tcp6,udp,udp6} ----
+
+// Lê o arquivo inteiro para um buffer reutilizado entre chamadas (as tabelas podem ter vários MiB)
+static bool lerArquivoInteiro(const char* path, std::vector<char> &buffer, size_t &tamanho) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false; // ex.: kernel sem IPv6
+
+    tamanho = 0;
+    while (true) {
+        if (tamanho == buffer.size())
+            buffer.resize(buffer.empty() ? 65536 : buffer.size() * 2); // cresce apenas quando necessário
+        ssize_t lidos = read(fd, buffer.data() + tamanho, buffer.size() - tamanho);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos <= 0) break; // EOF ou erro
+        tamanho += static_cast<size_t>(lidos);
+    }
+    close(fd);
+    return true;
+}
+
+// Faz o parse de uma tabela de /proc/net e registra as filas de cada inode
+static void lerTabelaRede(const char* caminhoTabela, std::vector<char> &buffer, TabelaSockets &tabela) {
+    size_t tamanho = 0;
+    if (!lerArquivoInteiro(caminhoTabela, buffer, tamanho)) return; // se não abrir, ignora a tabela
+
+    std::string_view conteudo(buffer.data(), tamanho);
+    proximaLinha(conteudo); // descarta cabeçalho (primeira linha)
+
+    while (!conteudo.empty()) { // cada linha descreve um socket
+        std::string_view linha = proximaLinha(conteudo);
+
+        // Campos: sl local_address rem_address st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode
+        pularTokens(linha, 4);
+        std::string_view filas = proximoToken(linha); // "tx:rx" em hexadecimal
+        pularTokens(linha, 4);
+        unsigned long inode = 0;
+        if (!lerNumero(linha, inode) || inode == 0) continue; // sem inode válido (ex.: TIME_WAIT)
+
+        size_t separador = filas.find(':');
+        FilasSocket f{};
+        if (separador == std::string_view::npos ||
+            !converterNumero(filas.substr(0, separador), f.tx, 16) ||
+            !converterNumero(filas.substr(separador + 1), f.rx, 16))
+            continue; // linha mal formatada
+
+        tabela.inserir(inode, f); // registra rx/tx para o inode
+    }
+}
+
+bool lerTabelaSocketsTexto(TabelaSockets &tabela, int pid) {
+    static std::vector<char> buffer; // reaproveitado entre amostras
+    static const char* const tabelas[] = { "tcp", "tcp6", "udp", "udp6" }; // TCP/UDP em IPv4 e IPv6
+
+    char caminho[64];
+    for (const char* nome : tabelas) {
+        // /proc/<pid>/net mostra as tabelas do namespace de rede do processo; /proc/net, as do monitor
+        if (pid > 0) snprintf(caminho, sizeof(caminho), "/proc/%d/net/%s", pid, nome);
+        else snprintf(caminho, sizeof(caminho), "/proc/net/%s", nome);
+        lerTabelaRede(caminho, buffer, tabela);
+    }
+    return true;
+}
+
+// ---- Backend netlink: NETLINK_SOCK_DIAG / inet_diag ----
+
+// Socket netlink aberto uma única vez e reutilizado em todas as consultas
+static int socketDiag() {
+    static int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    return fd;
+}
+
+// Faz um dump de todos os sockets de uma família/protocolo e registra rqueue/wqueue por inode.
+// O socket é reaproveitado entre dumps: um dump anterior interrompido (recv com erro) pode ter deixado
+// mensagens na fila, então cada pedido leva um nlmsg_seq próprio e mensagens de outro seq são descartadas
+static bool dumpSockDiag(int fd, uint8_t familia, uint8_t protocolo, TabelaSockets &tabela) {
+    static uint32_t ultimaSequencia = 0; // os dumps rodam sob a trava da CacheSockets, como o buffer abaixo
+    const uint32_t sequencia = ++ultimaSequencia;
+
+    struct {
+        nlmsghdr cabecalho;
+        inet_diag_req_v2 pedido;
+    } mensagem{};
+
+    mensagem.cabecalho.nlmsg_len = sizeof(mensagem);
+    mensagem.cabecalho.nlmsg_seq = sequencia;
+    mensagem.cabecalho.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    mensagem.cabecalho.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    mensagem.pedido.sdiag_family = familia;
+    mensagem.pedido.sdiag_protocol = protocolo;
+    mensagem.pedido.idiag_states = ~0u; // todos os estados, como nas tabelas de /proc/net
+
+    sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(fd, &mensagem, sizeof(mensagem), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0)
+        return false;
+
+    alignas(nlmsghdr) static char buffer[64 * 1024]; // cada recv traz dezenas de sockets
+    while (true) {
+        ssize_t recebidos = recv(fd, buffer, sizeof(buffer), 0);
+        if (recebidos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        int restante = static_cast<int>(recebidos);
+        for (nlmsghdr* h = reinterpret_cast<nlmsghdr*>(buffer); NLMSG_OK(h, restante); h = NLMSG_NEXT(h, restante)) {
+            if (h->nlmsg_seq != sequencia) continue; // resto de um dump anterior
+            if (h->nlmsg_type == NLMSG_DONE) return true; // fim do dump
+            if (h->nlmsg_type == NLMSG_ERROR) {
+                // Também encerra o dump (ex.: protocolo não suportado): o kernel não manda NLMSG_DONE depois dele
+                const nlmsgerr* erro = static_cast<const nlmsgerr*>(NLMSG_DATA(h));
+                return erro->error == 0;
+            }
+
+            const inet_diag_msg* diag = static_cast<const inet_diag_msg*>(NLMSG_DATA(h));
+            if (diag->idiag_inode == 0) continue; // sockets sem inode (TIME_WAIT)
+
+            FilasSocket f{};
+            f.rx = diag->idiag_rqueue;
+            // Em LISTEN o wqueue traz o backlog máximo; /proc/net/tcp mostra tx_queue 0
+            f.tx = (protocolo == IPPROTO_TCP && diag->idiag_state == TCP_LISTEN) ? 0 : diag->idiag_wqueue;
+            tabela.inserir(diag->idiag_inode, f);
+        }
+    }
+}
+
+bool lerTabelaSocketsDiag(TabelaSockets &tabela) {
+    int fd = socketDiag();
+    if (fd < 0) return false; // kernel sem sock_diag
+
+    // TCP é obrigatório; UDP/IPv6 podem não existir no kernel, então falhas neles são ignoradas
+    if (!dumpSockDiag(fd, AF_INET, IPPROTO_TCP, tabela)) return false;
+    dumpSockDiag(fd, AF_INET6, IPPROTO_TCP, tabela);
+    dumpSockDiag(fd, AF_INET, IPPROTO_UDP, tabela);
+    dumpSockDiag(fd, AF_INET6, IPPROTO_UDP, tabela);
+    return true;
+}
+
+// ---- Cache de tabelas por namespace de rede ----
+
+// Inode do namespace de rede do processo (0 se não foi possível ler, ex.: processo encerrou)
+static unsigned long netnsDoProcesso(int pid) {
+    char caminho[64];
+    if (pid > 0) snprintf(caminho, sizeof(caminho), "/proc/%d/ns/net", pid);
+    else snprintf(caminho, sizeof(caminho), "/proc/self/ns/net");
+    struct stat info;
+    if (stat(caminho, &info) != 0) return 0;
+    return static_cast<unsigned long>(info.st_ino);
+}
+
+CacheSockets& CacheSockets::padrao() {
+    static CacheSockets cache;
+    return cache;
+}
+
+void CacheSockets::novoTick() {
+    std::lock_guard<std::mutex> lock(trava);
+    ++tickAtual;
+}
+
+void CacheSockets::definirTTL(std::chrono::milliseconds novoTTL) {
+    std::lock_guard<std::mutex> lock(trava);
+    ttl = novoTTL;
+}
+
+void CacheSockets::invalidar() {
+    std::lock_guard<std::mutex> lock(trava);
+    for (auto &[netns, entrada] : porNetns) entrada.valida = false;
+}
+
+// Monta a tabela do namespace: sock_diag só para o namespace do monitor, texto para os demais ou como fallback
+bool CacheSockets::atualizar(int pid, unsigned long netns, TabelaSockets &tabela) {
+    if (netnsProprio == 0) netnsProprio = netnsDoProcesso(0);
+
+    tabela.limpar();
+    if (backendAtual == BackendRede::SockDiag && netns == netnsProprio && lerTabelaSocketsDiag(tabela))
+        return true;
+    tabela.limpar();
+    return lerTabelaSocketsTexto(tabela, netns == netnsProprio ? 0 : pid);
+}
+
+const TabelaSockets* CacheSockets::obter(int pid) {
+    unsigned long netns = netnsDoProcesso(pid);
+    if (netns == 0) return nullptr;
+
+    std::lock_guard<std::mutex> lock(trava);
+    EntradaNetns &entrada = porNetns[netns];
+    auto agora = std::chrono::steady_clock::now();
+    bool atual = entrada.valida &&
+        (entrada.tick == tickAtual || (ttl.count() > 0 && agora - entrada.atualizadoEm < ttl));
+    if (!atual) { // primeira consulta do namespace neste tick (ou TTL expirado)
+        entrada.valida = atualizar(pid, netns, entrada.tabela);
+        entrada.tick = tickAtual;
+        entrada.atualizadoEm = agora;
+    }
+    return &entrada.tabela;
+}
+
+// ---- Coletor ----
+
+// Extrai o inode de um alvo "socket:[inode]"; 0 se o fd não é socket
+static unsigned long inodeDoLink(std::string_view alvoLink) {
+    if (alvoLink.size() < 10 || alvoLink.rfind("socket:[", 0) != 0 || alvoLink.back() != ']') return 0;
+    unsigned long numeroInode = 0;
+    if (!converterNumero(alvoLink.substr(8, alvoLink.size() - 9), numeroInode)) return 0;
+    return numeroInode;
+}
+
+// Registro devolvido pelo getdents64 (o glibc só expõe a syscall em versões recentes)
+struct DirentLinux64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+RastreadorFds& RastreadorFds::padrao() {
+    static RastreadorFds rastreador;
+    return rastreador;
+}
+
+RastreadorFds::~RastreadorFds() {
+    for (auto &[pid, estado] : estados)
+        if (estado.dirfd >= 0) close(estado.dirfd);
+}
+
+void RastreadorFds::liberar(int pid) {
+    auto it = estados.find(pid);
+    if (it == estados.end()) return;
+    if (it->second.dirfd >= 0) close(it->second.dirfd);
+    estados.erase(it);
+}
+
+void RastreadorFds::definirResync(unsigned amostras) {
+    intervaloResync = amostras;
+}
+
+bool RastreadorFds::listarSockets(int pid, std::vector<unsigned long> &inodes) {
+    readlinksUltimaAmostra = 0;
+    EstadoPid &estado = estados[pid];
+    if (estado.dirfd < 0) { // primeira amostra do PID: abre o diretório uma única vez
+        char caminho[64];
+        snprintf(caminho, sizeof(caminho), "/proc/%d/fd", pid);
+        estado.dirfd = open(caminho, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (estado.dirfd < 0) { // processo não existe ou sem permissão
+            estados.erase(pid);
+            return false;
+        }
+    }
+
+    // Ressincronização periódica: esquece os d_ino para forçar a releitura de todos os links
+    ++estado.varredura;
+    bool resync = intervaloResync > 0 && estado.varredura % intervaloResync == 0;
+
+    if (bufferDirent.empty()) bufferDirent.resize(32 * 1024);
+    if (lseek(estado.dirfd, 0, SEEK_SET) < 0) { liberar(pid); return false; } // volta ao início do diretório
+
+    while (true) {
+        long lidos = syscall(SYS_getdents64, estado.dirfd, bufferDirent.data(), bufferDirent.size());
+        if (lidos < 0) { liberar(pid); return false; } // processo encerrou
+        if (lidos == 0) break; // fim do diretório
+
+        for (long pos = 0; pos < lidos;) {
+            const DirentLinux64* d = reinterpret_cast<const DirentLinux64*>(bufferDirent.data() + pos);
+            pos += d->d_reclen;
+
+            int fd = 0;
+            if (!converterNumero(std::string_view(d->d_name), fd) || fd < 0) continue; // "." e ".."
+            if (static_cast<size_t>(fd) >= estado.fds.size())
+                estado.fds.resize(static_cast<size_t>(fd) + 1 + estado.fds.size() / 2); // cresce com folga
+
+            EntradaFd &entrada = estado.fds[fd];
+            // A classificação (socket ou não) vale enquanto o fd continuar aberto com o mesmo d_ino. O d_ino
+            // acompanha o número do fd, não o arquivo: um socket reaproveitado é pego pelo revalidar() e o
+            // resto (fd que deixou de ser ou passou a ser socket) pela ressincronização periódica
+            if (resync || entrada.dIno != d->d_ino) {
+                char alvo[64];
+                ssize_t n = readlinkat(estado.dirfd, d->d_name, alvo, sizeof(alvo));
+                ++readlinksUltimaAmostra;
+                entrada.socket = n > 0 ? inodeDoLink(std::string_view(alvo, static_cast<size_t>(n))) : 0;
+                entrada.dIno = d->d_ino;
+                entrada.foraDaTabela = false;
+            }
+            entrada.visto = estado.varredura;
+            if (entrada.socket != 0) inodes.push_back(entrada.socket);
+        }
+    }
+
+    // fds que não apareceram nesta varredura foram fechados
+    for (auto &entrada : estado.fds)
+        if (entrada.visto != estado.varredura) entrada = EntradaFd{};
+
+    return true;
+}
+
+void RastreadorFds::revalidar(int pid, const TabelaSockets &tabela, std::vector<unsigned long> &inodes) {
+    auto it = estados.find(pid);
+    if (it == estados.end()) return;
+    EstadoPid &estado = it->second;
+
+    bool relidos = false;
+    for (size_t fd = 0; fd < estado.fds.size(); ++fd) {
+        EntradaFd &entrada = estado.fds[fd];
+        if (entrada.visto != estado.varredura || entrada.socket == 0 || entrada.foraDaTabela) continue;
+        if (tabela.buscar(entrada.socket)) continue;
+
+        // Socket fora da tabela: fechado e o número do fd reaproveitado, ou um socket que a tabela não cobre
+        // (Unix, netlink). Relido uma vez; se continuar fora, fica marcado até a próxima ressincronização
+        char nome[24];
+        snprintf(nome, sizeof(nome), "%zu", fd);
+        char alvo[64];
+        ssize_t n = readlinkat(estado.dirfd, nome, alvo, sizeof(alvo));
+        ++readlinksUltimaAmostra;
+        entrada.socket = n > 0 ? inodeDoLink(std::string_view(alvo, static_cast<size_t>(n))) : 0;
+        entrada.foraDaTabela = entrada.socket != 0 && !tabela.buscar(entrada.socket);
+        relidos = true;
+    }
+    if (!relidos) return;
+
+    inodes.clear();
+    for (const auto &entrada : estado.fds)
+        if (entrada.visto == estado.varredura && entrada.socket != 0) inodes.push_back(entrada.socket);
+}
+
+void listarInodesSockets(int pid, std::vector<unsigned long> &inodes) {
+    const std::string caminhoDiretorioFd = "/proc/" + std::to_string(pid) + "/fd"; // path para os file descriptors do processo
+    std::error_code codigoErro; // erros de permissão/processo encerrado não lançam exceção
+    for (auto &entradaFd : std::filesystem::directory_iterator(caminhoDiretorioFd, std::filesystem::directory_options::skip_permission_denied, codigoErro)) { // itera FDs ignorando erros de permissão
+        auto linkSimbolico = std::filesystem::read_symlink(entradaFd.path(), codigoErro); // lê o symlink do FD (ex.: "socket:[12345]" ou "pipe:[5678]")
+        if (codigoErro) continue; // se falhou ao ler o link, pula este FD
+        std::string_view alvoLink = linkSimbolico.native();
+
+        // Filtra apenas entradas no formato "socket:[inode]"
+        if (unsigned long numeroInode = inodeDoLink(alvoLink))
+            inodes.push_back(numeroInode); // adiciona inode à lista
+    }
+}
+
+bool coletorNetwork(const ProcessoMonitorado &processo, StatusProcesso &status, RastreadorFds &rastreador) { // entrada: processo aberto e estrutura onde vai gravar métricas
+    if (!processo.valido()) return false;
+    status.PID = processo.pid();
+    status.bytesRxfila = 0; // zera contador de bytes em fila de recepção
+    status.bytesTxfila = 0; // zera contador de bytes em fila de transmissão
+    status.conexoesAtivas = 0; // zera contador de sockets encontrados
+
+    thread_local std::vector<unsigned long> listaInodesSockets; // inodes de sockets do processo (capacidade reaproveitada, um por worker)
+    listaInodesSockets.clear();
+    rastreador.listarSockets(status.PID, listaInodesSockets); // sockets já conhecidos vêm do cache do rastreador
+    if (listaInodesSockets.empty()) return true; // se não há sockets, retorna rapidamente
+
+    // Tabela inode -> (rx, tx) do namespace de rede do processo, compartilhada por todos os PIDs do tick
+    const TabelaSockets* tabelaInodeParaFilas = CacheSockets::padrao().obter(status.PID);
+    if (tabelaInodeParaFilas) // relê os fds cujo socket em cache não está na tabela (fd pode ter sido reutilizado)
+        rastreador.revalidar(status.PID, *tabelaInodeParaFilas, listaInodesSockets);
+
+    status.conexoesAtivas = static_cast<unsigned int>(listaInodesSockets.size()); // grava quantos sockets foram detectados no processo
+    if (!tabelaInodeParaFilas) return true; // processo encerrou entre a listagem e a consulta
+
+    for (unsigned long inodeAtual : listaInodesSockets) { // para cada inode que pertence ao processo
+        const FilasSocket* filas = tabelaInodeParaFilas->buscar(inodeAtual); // busca estatísticas desse inode na tabela de rede
+        if (filas) { // se encontrado (é socket de rede)
+            status.bytesRxfila += filas->rx; // acumula bytes em fila de recepção
+            status.bytesTxfila += filas->tx; // acumula bytes em fila de transmissão
+        }
+    }
+
+    return true; // coleta concluída com sucesso
+}
+
+// ---- Experimento nº7: texto x sock_diag e cache por namespace ----
+
+void benchmarkRede() {
+    const int repeticoes = 50;
+    const int pidsPorTick = 20; // frota simulada: vários PIDs amostrados no mesmo tick
+
+    std::cout << "\n\033[1;33m======= Experimento nº7 - Backends de rede (texto x sock_diag) =======\033[0m\n";
+
+    // Mede o tempo médio (ms) de montar a tabela completa de sockets com um backend
+    auto medir = [&](auto leitor, size_t &sockets) {
+        TabelaSockets tabela;
+        auto inicio = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeticoes; ++i) {
+            tabela.limpar();
+            if (!leitor(tabela)) return -1.0; // backend indisponível
+        }
+        auto fim = std::chrono::steady_clock::now();
+        sockets = tabela.tamanho();
+        return std::chrono::duration<double, std::milli>(fim - inicio).count() / repeticoes;
+    };
+
+    size_t socketsTexto = 0, socketsDiag = 0;
+    double msTexto = medir([](TabelaSockets &t) { return lerTabelaSocketsTexto(t); }, socketsTexto);
+    double msDiag = medir([](TabelaSockets &t) { return lerTabelaSocketsDiag(t); }, socketsDiag);
+
+    std::cout << " Média de " << repeticoes << " leituras da tabela completa de sockets do host\n\n";
+    std::cout << " " << std::left << std::setw(22) << "Backend" << std::right << std::setw(12) << "sockets" << std::setw(16) << "ms/amostra\n";
+    std::cout << " " << std::string(49, '-') << "\n";
+    std::cout << " " << std::left << std::setw(22) << nomeBackendRede(BackendRede::TextoProc)
+        << std::right << std::setw(12) << socketsTexto << std::setw(15) << std::fixed << std::setprecision(3) << msTexto << "\n";
+    if (msDiag < 0)
+        std::cout << " " << std::left << std::setw(22) << nomeBackendRede(BackendRede::SockDiag) << "  indisponível neste kernel\n";
+    else {
+        std::cout << " " << std::left << std::setw(22) << nomeBackendRede(BackendRede::SockDiag)
+            << std::right << std::setw(12) << socketsDiag << std::setw(15) << msDiag << "\n";
+        if (msDiag > 0)
+            std::cout << "\n Ganho do sock_diag: " << std::setprecision(1) << msTexto / msDiag << "x\n";
+    }
+
+    // Frota de PIDs: sem cache cada PID remonta a tabela; com cache ela é montada uma vez por tick
+    StatusProcesso status{};
+    ProcessoMonitorado proprio(getpid());
+    CacheSockets &cache = CacheSockets::padrao();
+
+    auto inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeticoes; ++i)
+        for (int p = 0; p < pidsPorTick; ++p) {
+            cache.novoTick(); // cada PID vê um tick novo: equivale à versão sem cache
+            coletorNetwork(proprio, status);
+        }
+    double msSemCache = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count() / repeticoes;
+
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeticoes; ++i) {
+        cache.novoTick(); // um tick para todos os PIDs
+        for (int p = 0; p < pidsPorTick; ++p)
+            coletorNetwork(proprio, status);
+    }
+    double msComCache = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count() / repeticoes;
+
+    std::cout << "\n Coleta de rede de " << pidsPorTick << " PIDs por tick (backend atual: " << nomeBackendRede(backendRedeAtual()) << ")\n";
+    std::cout << " " << std::left << std::setw(22) << "sem cache" << std::right << std::setw(27) << std::setprecision(3) << msSemCache << " ms/tick\n";
+    std::cout << " " << std::left << std::setw(22) << "cache por netns" << std::right << std::setw(27) << msComCache << " ms/tick\n";
+
+    // Listagem dos sockets do próprio monitor com muitos fds abertos (simula um banco de dados)
+    const int fdsExtras = 5000;
+    std::vector<int> abertos;
+    for (int i = 0; i < fdsExtras; ++i) {
+        int fd = (i % 10 == 0) ? socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0) : open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) break; // limite de fds (ulimit -n) atingido
+        abertos.push_back(fd);
+    }
+
+    std::vector<unsigned long> inodes;
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeticoes; ++i) {
+        inodes.clear();
+        listarInodesSockets(getpid(), inodes);
+    }
+    double msCompleta = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count() / repeticoes;
+    size_t socketsCompleta = inodes.size();
+
+    // Caminho do coletorNetwork: listagem e revalidação contra a tabela, com a ressincronização padrão (a cada 64)
+    RastreadorFds rastreador;
+    const TabelaSockets* tabela = cache.obter(getpid());
+    inodes.clear();
+    rastreador.listarSockets(getpid(), inodes); // primeira amostra lê todos os links
+    if (tabela) rastreador.revalidar(getpid(), *tabela, inodes);
+    size_t readlinksIncremental = 0;
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeticoes; ++i) {
+        inodes.clear();
+        rastreador.listarSockets(getpid(), inodes);
+        if (tabela) rastreador.revalidar(getpid(), *tabela, inodes);
+        readlinksIncremental += rastreador.ultimosReadlinks();
+    }
+    double msIncremental = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count() / repeticoes;
+
+    for (int fd : abertos) close(fd);
+
+    std::cout << "\n Listagem de sockets em /proc/<pid>/fd com " << abertos.size() << " fds extras (" << socketsCompleta << " sockets)\n";
+    std::cout << " " << std::left << std::setw(22) << "readlink em todo fd" << std::right << std::setw(27) << msCompleta << " ms/amostra\n";
+    std::cout << " " << std::left << std::setw(22) << "getdents64 + cache" << std::right << std::setw(27) << msIncremental << " ms/amostra ("
+        << std::setprecision(1) << static_cast<double>(readlinksIncremental) / repeticoes << " readlinkat em média)\n";
+}
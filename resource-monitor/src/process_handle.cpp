@@ -0,0 +1,116 @@
+#include <iostream>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "pidfd.h"
+#include "procfs.h"
+
+// pidfd_open via syscall: o wrapper da glibc só existe a partir da 2.36
+static int abrirPidfd(int pid) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0)); // o pidfd já nasce com O_CLOEXEC
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+// Lê /proc/<pid>/stat uma vez (abre, lê e fecha) e extrai os campos
+static bool lerStatUnico(int pid, CamposStat &campos) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/stat", pid);
+    int fd = open(caminho, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buffer[1024]; // stat tem ~300 bytes; o comm ocupa no máximo 16
+    ssize_t lidos = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    return lidos > 0 && parseStat(std::string_view(buffer, static_cast<size_t>(lidos)), campos);
+}
+
+ProcessoMonitorado::~ProcessoMonitorado() {
+    fechar();
+}
+
+ProcessoMonitorado::ProcessoMonitorado(ProcessoMonitorado &&outro) noexcept
+    : id(outro.id), fd(outro.fd), starttime(outro.starttime) {
+    outro.id = -1;
+    outro.fd = -1;
+}
+
+ProcessoMonitorado& ProcessoMonitorado::operator=(ProcessoMonitorado &&outro) noexcept {
+    if (this != &outro) {
+        fechar();
+        id = outro.id;
+        fd = outro.fd;
+        starttime = outro.starttime;
+        outro.id = -1;
+        outro.fd = -1;
+    }
+    return *this;
+}
+
+void ProcessoMonitorado::fechar() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    id = -1;
+    starttime = 0;
+}
+
+bool ProcessoMonitorado::abrir(int pid, bool avisar) {
+    fechar();
+    if (pid <= 0) {
+        if (avisar) std::cerr << "Erro: PID inválido (" << pid << ").\n";
+        return false;
+    }
+
+    // pidfd primeiro: a partir daqui o processo não pode ser trocado por outro com o mesmo PID
+    int novo = abrirPidfd(pid);
+    if (novo < 0 && errno == ESRCH) {
+        if (avisar) std::cerr << "Erro: processo " << pid << " inexistente.\n";
+        return false;
+    }
+    // ENOSYS (kernel < 5.3) ou EMFILE: segue sem pidfd, com kill(pid, 0) para detectar a saída
+
+    CamposStat campos{};
+    std::string caminhoStatus = "/proc/" + std::to_string(pid) + "/status";
+    if (!lerStatUnico(pid, campos) || access(caminhoStatus.c_str(), R_OK) != 0) {
+        bool existe = kill(pid, 0) == 0 || errno == EPERM;
+        if (avisar) {
+            if (existe) std::cerr << "Erro: sem permissão para acessar processo " << pid << ".\n";
+            else std::cerr << "Erro: processo " << pid << " inexistente.\n";
+        }
+        if (novo >= 0) close(novo);
+        return false;
+    }
+
+    id = pid;
+    fd = novo;
+    starttime = campos.starttime;
+
+    // O stat foi lido pelo caminho: se o processo encerrou antes da leitura, o starttime pode ser de outro
+    if (encerrou()) {
+        if (avisar) std::cerr << "Erro: processo " << pid << " inexistente.\n";
+        fechar();
+        return false;
+    }
+    return true;
+}
+
+bool ProcessoMonitorado::mesmaIdentidade(const CamposStat &stat) const {
+    return valido() && stat.starttime == starttime;
+}
+
+bool ProcessoMonitorado::encerrou() const {
+    if (!valido()) return true;
+    if (fd >= 0) {
+        pollfd descritor{ fd, POLLIN, 0 };
+        return poll(&descritor, 1, 0) > 0; // POLLIN: o processo saiu (zumbi ou já coletado)
+    }
+    return kill(id, 0) != 0 && errno == ESRCH;
+}
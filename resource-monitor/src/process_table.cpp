@@ -0,0 +1,223 @@
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include "processos.h"
+#include "parse.h"
+
+// comm de /proc/<pid>/comm sem o '\n'; vazio se o processo já encerrou
+static std::string lerComm(int pid) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/comm", pid);
+    int fd = open(caminho, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return {};
+    char comm[32];
+    ssize_t lidos = read(fd, comm, sizeof(comm));
+    close(fd);
+    if (lidos <= 0) return {};
+    std::string_view nome(comm, static_cast<size_t>(lidos));
+    if (nome.back() == '\n') nome.remove_suffix(1);
+    return std::string(nome);
+}
+
+TabelaProcessos& TabelaProcessos::padrao() {
+    static TabelaProcessos tabela;
+    return tabela;
+}
+
+TabelaProcessos::TabelaProcessos() {
+    fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd >= 0) {
+        sockaddr_nl local{};
+        local.nl_family = AF_NETLINK;
+        local.nl_groups = CN_IDX_PROC; // grupo multicast dos eventos de processo
+        // Buffer maior para absorver rajadas (ex.: make -j): transbordar custa uma varredura completa
+        int tamanho = 4 * 1024 * 1024;
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &tamanho, sizeof(tamanho)) < 0)
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &tamanho, sizeof(tamanho));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0 || !assinar(true)) {
+            std::cerr << "Aviso: proc connector indisponível (" << std::strerror(errno) << "), varrendo /proc a cada consulta\n";
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    if (fd < 0) return; // listar() varre /proc em cada consulta
+
+    // Inscrito antes da varredura: um processo criado durante ela chega também como evento
+    varrer();
+
+    fdParar = eventfd(0, EFD_CLOEXEC);
+    if (fdParar < 0) { // sem como parar a thread: trabalha sem o conector
+        assinar(false);
+        close(fd);
+        fd = -1;
+        return;
+    }
+    thread = std::thread(&TabelaProcessos::executar, this);
+}
+
+TabelaProcessos::~TabelaProcessos() {
+    if (thread.joinable()) {
+        uint64_t um = 1;
+        if (write(fdParar, &um, sizeof(um)) < 0) {} // acorda o poll() da thread
+        thread.join();
+    }
+    if (fdParar >= 0) close(fdParar);
+    if (fd >= 0) {
+        assinar(false);
+        close(fd);
+    }
+}
+
+// Envia PROC_CN_MCAST_LISTEN/IGNORE: o kernel só gera eventos enquanto houver ouvintes
+bool TabelaProcessos::assinar(bool ativar) {
+    alignas(nlmsghdr) char mensagem[NLMSG_SPACE(sizeof(cn_msg) + sizeof(uint32_t))]{};
+    nlmsghdr *cabecalho = reinterpret_cast<nlmsghdr*>(mensagem);
+    cabecalho->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(uint32_t));
+    cabecalho->nlmsg_type = NLMSG_DONE;
+    cabecalho->nlmsg_pid = 0;
+
+    cn_msg *conector = static_cast<cn_msg*>(NLMSG_DATA(cabecalho));
+    conector->id.idx = CN_IDX_PROC;
+    conector->id.val = CN_VAL_PROC;
+    conector->len = sizeof(uint32_t);
+    uint32_t operacao = ativar ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    std::memcpy(conector->data, &operacao, sizeof(operacao));
+
+    return send(fd, mensagem, cabecalho->nlmsg_len, 0) >= 0;
+}
+
+void TabelaProcessos::varrer() {
+    // Monta a tabela nova fora da trava; as consultas continuam vendo a anterior até a troca
+    std::map<int, std::string> nova;
+    DIR *dir = opendir("/proc");
+    if (!dir) {
+        std::cerr << "Erro ao abrir /proc: " << std::strerror(errno) << "\n";
+        return;
+    }
+    while (dirent *entrada = readdir(dir)) {
+        int pid = 0;
+        if (!converterNumero(std::string_view(entrada->d_name), pid)) continue;
+        std::string nome = lerComm(pid);
+        if (!nome.empty()) nova.emplace(pid, std::move(nome)); // vazio: encerrou durante a varredura
+    }
+    closedir(dir);
+
+    std::lock_guard<std::mutex> guarda(trava);
+    processos.swap(nova);
+    totalVarreduras.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TabelaProcessos::aplicar(const proc_event &evento) {
+    switch (evento.what) {
+    case proc_event::PROC_EVENT_FORK: {
+        const auto &f = evento.event_data.fork;
+        if (f.child_pid != f.child_tgid) return; // nova thread, não novo processo
+        std::lock_guard<std::mutex> guarda(trava);
+        auto pai = processos.find(f.parent_tgid);
+        // O filho herda o comm do pai; só lê /proc se o pai não está na tabela
+        if (pai != processos.end()) processos[f.child_tgid] = pai->second;
+        else if (std::string nome = lerComm(f.child_tgid); !nome.empty()) processos[f.child_tgid] = std::move(nome);
+        break;
+    }
+    case proc_event::PROC_EVENT_EXEC: {
+        // O evento não traz o nome novo; exec em outra thread também troca o processo inteiro (TGID)
+        std::string nome = lerComm(evento.event_data.exec.process_tgid);
+        std::lock_guard<std::mutex> guarda(trava);
+        if (nome.empty()) processos.erase(evento.event_data.exec.process_tgid); // já encerrou
+        else processos[evento.event_data.exec.process_tgid] = std::move(nome);
+        break;
+    }
+    case proc_event::PROC_EVENT_COMM: {
+        const auto &c = evento.event_data.comm;
+        if (c.process_pid != c.process_tgid) return; // nome de uma thread; /proc/<pid>/comm é o do líder
+        std::string nome(c.comm, strnlen(c.comm, sizeof(c.comm)));
+        std::lock_guard<std::mutex> guarda(trava);
+        processos[c.process_tgid] = std::move(nome);
+        break;
+    }
+    case proc_event::PROC_EVENT_EXIT: {
+        const auto &e = evento.event_data.exit;
+        if (e.process_pid != e.process_tgid) return; // saída de uma thread
+        std::lock_guard<std::mutex> guarda(trava);
+        processos.erase(e.process_tgid);
+        break;
+    }
+    default:
+        return; // uid/gid/sid/ptrace/coredump: não mudam a tabela
+    }
+    totalEventos.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TabelaProcessos::executar() {
+    alignas(nlmsghdr) char buffer[16 * 1024]; // cada datagrama traz um evento (~76 bytes)
+    pollfd descritores[2] = { { fd, POLLIN, 0 }, { fdParar, POLLIN, 0 } };
+
+    while (true) {
+        if (poll(descritores, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Erro no poll() da tabela de processos: " << std::strerror(errno) << "\n";
+            return;
+        }
+        if (descritores[1].revents) return; // destrutor pediu para parar
+
+        // Esvazia o socket sem bloquear
+        while (true) {
+            ssize_t recebidos = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (recebidos < 0) {
+                if (errno == EINTR) continue;
+                if (errno == ENOBUFS) { // eventos perdidos: só uma varredura completa deixa a tabela certa
+                    totalEstouros.fetch_add(1, std::memory_order_relaxed);
+                    varrer();
+                    continue;
+                }
+                break; // EAGAIN: socket vazio
+            }
+
+            int restante = static_cast<int>(recebidos);
+            for (const nlmsghdr *mensagem = reinterpret_cast<const nlmsghdr*>(buffer); NLMSG_OK(mensagem, restante);
+                 mensagem = NLMSG_NEXT(mensagem, restante)) {
+                if (mensagem->nlmsg_type == NLMSG_ERROR || mensagem->nlmsg_type == NLMSG_NOOP) continue;
+                const cn_msg *conector = static_cast<const cn_msg*>(NLMSG_DATA(mensagem));
+                if (conector->id.idx != CN_IDX_PROC || conector->id.val != CN_VAL_PROC) continue;
+                if (conector->len < sizeof(proc_event) - sizeof(proc_event::event_data)) continue; // truncado
+                proc_event evento{};
+                std::memcpy(&evento, conector->data, std::min<size_t>(conector->len, sizeof(evento)));
+                aplicar(evento);
+            }
+        }
+    }
+}
+
+std::vector<EntradaProcesso> TabelaProcessos::listar() {
+    if (fd < 0) varrer(); // sem conector, a tabela só vale no instante da varredura
+
+    std::vector<EntradaProcesso> lista;
+    std::lock_guard<std::mutex> guarda(trava);
+    lista.reserve(processos.size());
+    for (const auto &[pid, nome] : processos)
+        lista.push_back({ pid, nome });
+    return lista;
+}
+
+std::vector<int> TabelaProcessos::pids() {
+    if (fd < 0) varrer();
+
+    std::vector<int> lista;
+    std::lock_guard<std::mutex> guarda(trava);
+    lista.reserve(processos.size());
+    for (const auto &par : processos)
+        lista.push_back(par.first);
+    return lista;
+}
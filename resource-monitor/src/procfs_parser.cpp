@@ -0,0 +1,293 @@
+#include "procfs.h"
+#include "parse.h"
+#include "agendador.h"
+#include <iostream>
+#include <ctime>
+#include <unistd.h>
+
+// Chaves de /proc/<pid>/status usadas pelo monitor (índices usados no switch de parseStatus)
+static const TabelaChaves<6> CHAVES_STATUS({
+    "Threads", "voluntary_ctxt_switches", "nonvoluntary_ctxt_switches", "VmSize", "VmRSS", "VmSwap"
+});
+
+// Chaves de /proc/<pid>/io
+static const TabelaChaves<6> CHAVES_IO({
+    "rchar", "wchar", "syscr", "syscw", "read_bytes", "write_bytes"
+});
+
+// Chaves de smaps_rollup usadas pelo ColetorSmaps
+static const TabelaChaves<11> CHAVES_SMAPS({
+    "Rss", "Pss", "Pss_Anon", "Pss_File", "Pss_Shmem", "Shared_Clean", "Shared_Dirty",
+    "Private_Clean", "Private_Dirty", "Swap", "SwapPss"
+});
+
+// Chaves de cpu.stat do cgroup v2
+static const TabelaChaves<6> CHAVES_CPU_STAT({
+    "usage_usec", "user_usec", "system_usec", "nr_periods", "nr_throttled", "throttled_usec"
+});
+
+// Chaves de cada par chave=valor de io.stat do cgroup v2
+static const TabelaChaves<6> CHAVES_IO_STAT({
+    "rbytes", "wbytes", "rios", "wios", "dbytes", "dios"
+});
+
+// Procura a chave de uma linha "Chave:<espaços>valor ..." na tabela e, só se ela interessar,
+// converte o valor. Retorna o índice da chave ou -1 (linha ignorada sem converter nada).
+template <size_t N>
+static int buscarChaveValor(const TabelaChaves<N> &tabela, std::string_view linha, unsigned long &valor) {
+    size_t doisPontos = linha.find(':');
+    if (doisPontos == std::string_view::npos) return -1;
+    int indice = tabela.buscar(linha.substr(0, doisPontos));
+    if (indice < 0) return -1;
+    linha.remove_prefix(doisPontos + 1);
+    return lerNumero(linha, valor) ? indice : -1;
+}
+
+bool parseStat(std::string_view conteudo, CamposStat &campos) {
+    // Procura a posição do último parêntese, que fecha o nome do processo (o nome pode ter espaços)
+    auto aposParenteses = conteudo.rfind(')');
+    if (aposParenteses == std::string_view::npos) return false; // conteúdo inválido
+    conteudo.remove_prefix(aposParenteses + 1);
+
+    // Pula os 7 campos entre o nome e minflt (state, ppid, pgrp, session, tty_nr, tpgid, flags)
+    pularTokens(conteudo, 7);
+
+    bool ok = lerNumero(conteudo, campos.minflt); // campo 10
+    pularTokens(conteudo, 1);                     // cminflt, não usado
+    ok = ok && lerNumero(conteudo, campos.majflt); // campo 12
+    pularTokens(conteudo, 1);                     // cmajflt, não usado
+    ok = ok && lerNumero(conteudo, campos.utime);  // campo 14
+    ok = ok && lerNumero(conteudo, campos.stime);  // campo 15
+    pularTokens(conteudo, 6);                      // cutime, cstime, priority, nice, num_threads, itrealvalue
+    ok = ok && lerNumero(conteudo, campos.starttime); // campo 22
+
+    return ok; // false se a linha terminou antes de starttime
+}
+
+bool parseSchedstat(std::string_view conteudo, CamposSchedstat &campos) {
+    // Uma única linha com três números: tempo em CPU (ns), espera na fila (ns) e nº de fatias
+    bool ok = lerNumero(conteudo, campos.cpuNs);
+    ok = ok && lerNumero(conteudo, campos.esperaNs);
+    ok = ok && lerNumero(conteudo, campos.fatias);
+    return ok;
+}
+
+void parseStatus(std::string_view conteudo, StatusProcesso &medicao) {
+    // Percorre as linhas e extrai informações de interesse (CPU e memória em uma só passada)
+    while (!conteudo.empty()) {
+        unsigned long valor = 0;
+        switch (buscarChaveValor(CHAVES_STATUS, proximaLinha(conteudo), valor)) {
+            case 0: medicao.threads = static_cast<unsigned int>(valor); break;
+            case 1: medicao.contextSwitchfree = static_cast<unsigned int>(valor); break;
+            case 2: medicao.contextSwitchforced = static_cast<unsigned int>(valor); break;
+            case 3: medicao.vmSize = valor; break;
+            case 4: medicao.vmRss = valor; break;
+            case 5: medicao.vmSwap = valor; break;
+            default: break; // chave que o monitor não usa (ex.: Name, State, VmPeak)
+        }
+    }
+}
+
+void parseSmapsRollup(std::string_view conteudo, MemoriaDetalhada &memoria) {
+    memoria = MemoriaDetalhada{};
+    // A primeira linha é o intervalo de endereços "[rollup]", ignorado pela busca de chaves
+    while (!conteudo.empty()) {
+        unsigned long valor = 0;
+        switch (buscarChaveValor(CHAVES_SMAPS, proximaLinha(conteudo), valor)) {
+            case 0: memoria.rss = valor; break;
+            case 1: memoria.pss = valor; break;
+            case 2: memoria.pssAnonima = valor; break;  // Pss_Anon/File/Shmem existem desde o kernel 5.7
+            case 3: memoria.pssArquivo = valor; break;
+            case 4: memoria.pssShmem = valor; break;
+            case 5: case 6: memoria.compartilhada += valor; break; // Shared_Clean + Shared_Dirty
+            case 7: case 8: memoria.uss += valor; break;           // Private_Clean + Private_Dirty
+            case 9: memoria.swap = valor; break;
+            case 10: memoria.swapPss = valor; break;
+            default: break; // Referenced, Anonymous, Locked, ...
+        }
+    }
+}
+
+void parseIO(std::string_view conteudo, StatusProcesso &medicao) {
+    while (!conteudo.empty()) { // percorre linha por linha
+        unsigned long valor = 0;
+        switch (buscarChaveValor(CHAVES_IO, proximaLinha(conteudo), valor)) {
+            case 0: medicao.rchar = valor; break;          // bytes lidos pelo processo (aplicação)
+            case 1: medicao.wchar = valor; break;          // bytes escritos pelo processo (aplicação)
+            case 2: medicao.syscallLeitura = valor; break; // syscalls de leitura
+            case 3: medicao.syscallEscrita = valor; break; // syscalls de escrita
+            case 4: medicao.bytesLidos = valor; break;     // bytes lidos do disco
+            case 5: medicao.bytesEscritos = valor; break;  // bytes escritos no disco
+            default: break; // cancelled_write_bytes
+        }
+    }
+}
+
+void parseCpuStat(std::string_view conteudo, CpuStatCgroup &cpu) {
+    while (!conteudo.empty()) {
+        std::string_view linha = proximaLinha(conteudo);
+        std::string_view chave = proximoToken(linha); // formato: "chave valor"
+        uint64_t valor = 0;
+        if (!lerNumero(linha, valor)) continue;
+
+        switch (CHAVES_CPU_STAT.buscar(chave)) {
+            case 0: cpu.usageUsec = valor; break;
+            case 1: cpu.userUsec = valor; break;
+            case 2: cpu.systemUsec = valor; break;
+            case 3: cpu.nrPeriods = valor; break;
+            case 4: cpu.nrThrottled = valor; break;
+            case 5: cpu.throttledUsec = valor; break;
+            default: break; // ex.: nr_bursts, burst_usec
+        }
+    }
+}
+
+size_t parseIoStat(std::string_view conteudo, BlkIOStats *saida, size_t capacidade) {
+    size_t total = 0;
+    while (!conteudo.empty() && total < capacidade) {
+        std::string_view linha = proximaLinha(conteudo);
+        std::string_view dispositivo = proximoToken(linha); // "major:minor" ou "Default"
+        if (dispositivo.empty()) continue;
+
+        BlkIOStats s{};
+        size_t doisPontos = dispositivo.find(':');
+        if (doisPontos != std::string_view::npos) {
+            // Converte as partes antes e depois dos dois pontos em major e minor
+            if (!converterNumero(dispositivo.substr(0, doisPontos), s.major) ||
+                !converterNumero(dispositivo.substr(doisPontos + 1), s.minor))
+                continue; // dispositivo inválido, ignora a linha
+        }
+        // Caso contrário é "Default": agregação de dispositivos (major = minor = 0)
+
+        // Lê todos os campos no formato chave=valor
+        for (std::string_view par = proximoToken(linha); !par.empty(); par = proximoToken(linha)) {
+            size_t igual = par.find('=');
+            uint64_t valor = 0;
+            if (igual == std::string_view::npos || !converterNumero(par.substr(igual + 1), valor))
+                continue; // token inválido
+
+            switch (CHAVES_IO_STAT.buscar(par.substr(0, igual))) {
+                case 0: s.rbytes = valor; break;
+                case 1: s.wbytes = valor; break;
+                case 2: s.rios = valor; break;
+                case 3: s.wios = valor; break;
+                case 4: s.dbytes = valor; break;
+                case 5: s.dios = valor; break;
+                default: break;
+            }
+        }
+        saida[total++] = s;
+    }
+    return total; // número de dispositivos preenchidos
+}
+
+bool lerTemposStat(int pid, SessaoColeta &sessao, unsigned long &utime, unsigned long &stime) {
+    std::string_view conteudo;
+    CamposStat campos{};
+    // Processo encerrado ou linha incompleta: devolve falha sem alterar a saída
+    if (!sessao.ler(pid, ArquivoProc::Stat, conteudo) || !parseStat(conteudo, campos))
+        return false;
+
+    utime = campos.utime;
+    stime = campos.stime;
+    return true;
+}
+
+bool lerTempoCPU(int pid, SessaoColeta &sessao, TempoCPU &tempo, const CamposStat *stat) {
+    tempo = TempoCPU{};
+
+    // schedstat traz a espera na fila; o tempo em CPU dele é só da thread principal
+    std::string_view conteudo;
+    CamposSchedstat sched{};
+    bool temSched = sessao.ler(pid, ArquivoProc::Schedstat, conteudo) && parseSchedstat(conteudo, sched);
+    tempo.esperaNs = sched.esperaNs;
+
+    // O relógio de CPU do processo pode ser lido para qualquer PID visível, sem abrir arquivos,
+    // e soma todas as threads (sum_exec_runtime do grupo) em ns
+    clockid_t relogio;
+    timespec ts{};
+    if (clock_getcpuclockid(pid, &relogio) == 0 && clock_gettime(relogio, &ts) == 0) {
+        tempo.cpuNs = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        tempo.fonte = FonteCPU::RelogioProcesso;
+        return true;
+    }
+    if (temSched) {
+        tempo.cpuNs = sched.cpuNs;
+        tempo.fonte = FonteCPU::Schedstat;
+        return true;
+    }
+
+    // Fallback: ticks de stat convertidos para ns
+    unsigned long utime = 0, stime = 0;
+    if (stat) {
+        utime = stat->utime;
+        stime = stat->stime;
+    }
+    else if (!lerTemposStat(pid, sessao, utime, stime)) {
+        return false;
+    }
+    static const uint64_t nsPorTick = 1000000000ULL / static_cast<uint64_t>(sysconf(_SC_CLK_TCK));
+    tempo.cpuNs = (static_cast<uint64_t>(utime) + stime) * nsPorTick;
+    tempo.fonte = FonteCPU::Ticks;
+    return true;
+}
+
+bool coletorSnapshot(const ProcessoMonitorado &processo, StatusProcesso &medicao, SessaoColeta &sessao, TemposColeta *tempos,
+                     bool tempoCPUExterno) {
+    // Existência e permissão já foram conferidas ao abrir o processo; nenhuma syscall extra por amostra
+    if (!processo.valido()) return false;
+    int pid = processo.pid(); // PID do processo monitorado
+    medicao.PID = pid;
+
+    // Cada arquivo é lido uma única vez; os campos de CPU e memória saem da mesma leitura
+    medicao.instanteNs = instanteMonotonicoNs(); // instante da amostra, antes das leituras
+    uint64_t marca = medicao.instanteNs;
+    auto medirParte = [&](uint64_t &destino) { // tempo desde a parte anterior
+        uint64_t agora = instanteMonotonicoNs();
+        destino = agora - marca;
+        marca = agora;
+    };
+    std::string_view conteudoStat, conteudoStatus, conteudoIO;
+    CamposStat campos{};
+    if (!sessao.ler(pid, ArquivoProc::Stat, conteudoStat) || !parseStat(conteudoStat, campos)) {
+        std::cerr << "Erro: não foi possível ler /proc/" << pid << "/stat\n";
+        std::cerr << "O processo encerrou ou sem permissões\n\n";
+        return false;
+    }
+    if (!processo.mesmaIdentidade(campos)) { // starttime diferente: o PID agora é de outro processo
+        std::cerr << "Erro: o processo " << pid << " encerrou e o PID foi reutilizado.\n";
+        return false;
+    }
+
+    if (!tempoCPUExterno) { // com o TASKSTATS, utime/stime/tempoCPU/esperaCPU já vieram da consulta netlink
+        // Converte de ticks para segundos e salva no struct
+        const double tickSegundo = static_cast<double>(sysconf(_SC_CLK_TCK));
+        medicao.utime = static_cast<double>(campos.utime) / tickSegundo;
+        medicao.stime = static_cast<double>(campos.stime) / tickSegundo;
+        TempoCPU tempo;
+        lerTempoCPU(pid, sessao, tempo, &campos); // nunca falha com stat já lido
+        medicao.tempoCPU = static_cast<double>(tempo.cpuNs) / 1e9;
+        medicao.esperaCPU = static_cast<double>(tempo.esperaNs) / 1e9;
+    }
+    medicao.minfault = campos.minflt;
+    medicao.mjrfault = campos.majflt;
+    if (tempos) medirParte(tempos->cpuNs);
+
+    if (!sessao.ler(pid, ArquivoProc::Status, conteudoStatus)) {
+        std::cerr << "Erro: não foi possível ler /proc/" << pid << "/status\n";
+        std::cerr << "O processo encerrou ou sem permissões\n\n";
+        return false;
+    }
+    parseStatus(conteudoStatus, medicao);
+    if (tempos) medirParte(tempos->memoriaNs);
+
+    if (!sessao.ler(pid, ArquivoProc::IO, conteudoIO)) {
+        std::cerr << "Erro: não foi possível ler /proc/" << pid << "/io\n";
+        std::cerr << "O processo encerrou ou sem permissões\n\n";
+        return false;
+    }
+    parseIO(conteudoIO, medicao);
+    if (tempos) medirParte(tempos->ioNs);
+
+    return true; // snapshot completo de stat/status/io
+}
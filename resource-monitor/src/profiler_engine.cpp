@@ -0,0 +1,333 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "motor.h"
+#include "processos.h"
+#include "parse.h"
+#include "serie.h"
+
+namespace fs = std::filesystem;
+
+void calcularMedicao(const StatusProcesso &anterior, const StatusProcesso &atual, long nucleosOnline, calculoMedicao &resultado) {
+    resultado = calculoMedicao{};
+    double intervalo = static_cast<double>(atual.instanteNs - anterior.instanteNs) / 1e9;
+    if (intervalo <= 0) return; // mesma amostra (ou relógio não preenchido): sem taxa
+
+    double usoCPU = (atual.tempoCPU - anterior.tempoCPU) / intervalo * 100;
+    resultado.usoCPU = usoCPU;
+    resultado.usoCPUGlobal = usoCPU / static_cast<double>(std::max(1L, nucleosOnline));
+    resultado.taxaLeituraDisco = static_cast<double>(atual.bytesLidos - anterior.bytesLidos) / intervalo / 1024;
+    resultado.taxaLeituraTotal = static_cast<double>(atual.rchar - anterior.rchar) / intervalo / 1024;
+    resultado.taxaEscritaDisco = static_cast<double>(atual.bytesEscritos - anterior.bytesEscritos) / intervalo / 1024;
+    resultado.taxaEscritaTotal = static_cast<double>(atual.wchar - anterior.wchar) / intervalo / 1024;
+}
+
+// Cada alvo mantém até 6 descritores abertos (stat, status, io, schedstat, o diretório fd e o pidfd):
+// com milhares de alvos o limite padrão de 1024 acaba, então o limite flexível sobe até o rígido
+static void elevarLimiteDescritores() {
+    rlimit limite{};
+    if (getrlimit(RLIMIT_NOFILE, &limite) != 0 || limite.rlim_cur >= limite.rlim_max) return;
+    limite.rlim_cur = limite.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limite);
+}
+
+// ---- MotorProfiler ----
+
+MotorProfiler::MotorProfiler(size_t numTrabalhadores) {
+    if (numTrabalhadores == 0) numTrabalhadores = static_cast<size_t>(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+    elevarLimiteDescritores();
+
+    // Todos os workers existem antes de qualquer thread começar
+    for (size_t i = 0; i < numTrabalhadores; ++i)
+        trabalhadores.push_back(std::make_unique<Trabalhador>());
+    for (auto &t : trabalhadores)
+        t->thread = std::thread(&MotorProfiler::executarTrabalhador, this, std::ref(*t));
+}
+
+MotorProfiler::~MotorProfiler() {
+    {
+        std::lock_guard<std::mutex> lock(trava);
+        encerrar = true;
+    }
+    cvInicio.notify_all();
+    for (auto &t : trabalhadores) t->thread.join();
+}
+
+void MotorProfiler::alvosPorPIDs(std::vector<int> pids) {
+    criterio = CriterioAlvos::ListaPIDs;
+    pidsInformados = std::move(pids);
+    selecaoPendente = true;
+}
+
+void MotorProfiler::alvosPorNome(const std::string &nome) {
+    criterio = CriterioAlvos::Nome;
+    filtro = nome;
+    selecaoPendente = true;
+}
+
+void MotorProfiler::alvosPorCgroup(const std::string &cgroup) {
+    criterio = CriterioAlvos::Cgroup;
+    filtro = cgroup;
+    selecaoPendente = true;
+}
+
+void MotorProfiler::definirReavaliacao(unsigned n) {
+    reavaliarACada = n;
+}
+
+void MotorProfiler::definirAnel(AnelAmostras *anel) {
+    anelAmostras = anel;
+}
+
+void MotorProfiler::definirHistorico(HistoricoMetricas *historico) {
+    historicoMetricas = historico;
+}
+
+void MotorProfiler::definirInstantaneo(InstantaneoCompartilhado *tabela) {
+    tabelaInstantaneo = tabela;
+}
+
+void MotorProfiler::definirColetaRede(bool ativa) {
+    coletarRede = ativa;
+}
+
+size_t MotorProfiler::alvosAtivos() const {
+    return static_cast<size_t>(std::count_if(tabela.begin(), tabela.end(), [](const AlvoProfiler &a) { return a.ativo; }));
+}
+
+// Lê os PIDs de um arquivo cgroup.procs (um por linha)
+static void lerCgroupProcs(const fs::path &arquivo, std::vector<int> &pids) {
+    int fd = open(arquivo.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    std::string conteudo;
+    char buf[4096];
+    ssize_t lidos;
+    while ((lidos = read(fd, buf, sizeof(buf))) > 0) conteudo.append(buf, static_cast<size_t>(lidos));
+    close(fd);
+
+    std::string_view resto(conteudo);
+    while (!resto.empty()) {
+        int pid = 0;
+        if (converterNumero(proximaLinha(resto), pid) && pid > 0) pids.push_back(pid);
+    }
+}
+
+std::vector<int> MotorProfiler::resolverAlvos() const {
+    std::vector<int> pids;
+
+    if (criterio == CriterioAlvos::ListaPIDs) {
+        pids = pidsInformados;
+    }
+    else if (criterio == CriterioAlvos::Nome) {
+        // Compara o comm de cada processo da tabela (sem o próprio monitor); /proc não é varrido a cada reavaliação
+        const int proprio = getpid();
+        for (const auto &p : TabelaProcessos::padrao().listar())
+            if (p.pid != proprio && p.nome.find(filtro) != std::string::npos) pids.push_back(p.pid);
+    }
+    else {
+        // cgroup.procs do cgroup e de todos os descendentes
+        fs::path base = filtro.rfind("/sys/fs/cgroup", 0) == 0 ? fs::path(filtro) : fs::path("/sys/fs/cgroup") / fs::path(filtro).relative_path();
+        std::error_code erro;
+        lerCgroupProcs(base / "cgroup.procs", pids);
+        for (fs::recursive_directory_iterator it(base, fs::directory_options::skip_permission_denied, erro), fim; !erro && it != fim; it.increment(erro))
+            if (it->is_directory(erro)) lerCgroupProcs(it->path() / "cgroup.procs", pids);
+    }
+
+    std::sort(pids.begin(), pids.end());
+    pids.erase(std::unique(pids.begin(), pids.end()), pids.end());
+    return pids;
+}
+
+void MotorProfiler::reavaliar() {
+    std::vector<int> pids = resolverAlvos();
+    const uint32_t numTrab = static_cast<uint32_t>(trabalhadores.size());
+
+    // Descarta o estado de um PID que saiu da tabela (chamado com os workers parados)
+    auto liberar = [&](const AlvoProfiler &a) {
+        trabalhadores[a.trabalhador]->sessao.liberar(a.pid);
+        trabalhadores[a.trabalhador]->rastreador.liberar(a.pid);
+    };
+
+    // Mescla as duas listas ordenadas: PIDs que continuam mantêm as amostras e o worker
+    std::vector<AlvoProfiler> nova;
+    nova.reserve(pids.size());
+    size_t i = 0;
+    for (int pid : pids) {
+        while (i < tabela.size() && tabela[i].pid < pid) liberar(tabela[i++]);
+        if (i < tabela.size() && tabela[i].pid == pid && tabela[i].ativo) {
+            nova.push_back(std::move(tabela[i++]));
+            continue;
+        }
+        if (i < tabela.size() && tabela[i].pid == pid) liberar(tabela[i++]); // PID encerrado e reutilizado
+
+        AlvoProfiler alvo{};
+        if (!alvo.processo.abrir(pid, false)) continue; // encerrou desde a seleção (ou sem permissão)
+        alvo.pid = pid;
+        alvo.ativo = true;
+        if (anelAmostras) alvo.anel = ReservaAnel(*anelAmostras, alvo.processo);
+        if (historicoMetricas) alvo.historico = ReservaHistorico(*historicoMetricas, alvo.processo);
+        if (tabelaInstantaneo) alvo.instantaneo = ReservaInstantaneo(*tabelaInstantaneo, alvo.processo);
+        // Hash do PID: a distribuição entre os workers não depende da posição na tabela
+        alvo.trabalhador = static_cast<uint32_t>((static_cast<uint64_t>(pid) * 0x9E3779B97F4A7C15ULL) >> 32) % numTrab;
+        nova.push_back(std::move(alvo));
+    }
+    while (i < tabela.size()) liberar(tabela[i++]);
+    tabela.swap(nova);
+
+    for (auto &t : trabalhadores) t->indices.clear();
+    for (uint32_t indice = 0; indice < tabela.size(); ++indice)
+        trabalhadores[tabela[indice].trabalhador]->indices.push_back(indice);
+}
+
+bool MotorProfiler::amostrar() {
+    bool reavaliarAgora = selecaoPendente ||
+        (criterio != CriterioAlvos::ListaPIDs && reavaliarACada > 0 && ticks % reavaliarACada == 0);
+    if (reavaliarAgora) {
+        reavaliar();
+        selecaoPendente = false;
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    CacheSockets::padrao().novoTick(); // tabela de sockets de cada namespace montada uma vez para todos os alvos
+    nucleosOnline = sysconf(_SC_NPROCESSORS_ONLN); // uma vez por tick; os workers leem depois da trava abaixo
+
+    // Libera os workers e espera todos terminarem a sua parte
+    {
+        std::lock_guard<std::mutex> lock(trava);
+        pendentes = trabalhadores.size();
+        ++geracao;
+    }
+    cvInicio.notify_all();
+    {
+        std::unique_lock<std::mutex> lock(trava);
+        cvFim.wait(lock, [this] { return pendentes == 0; });
+    }
+
+    ultimoTickMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    ++ticks;
+    return alvosAtivos() > 0;
+}
+
+void MotorProfiler::executarTrabalhador(Trabalhador &t) {
+    uint64_t vista = 0; // última geração processada
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(trava);
+            cvInicio.wait(lock, [&] { return encerrar || geracao != vista; });
+            if (encerrar) return;
+            vista = geracao;
+        }
+
+        coletarFatia(t);
+
+        std::lock_guard<std::mutex> lock(trava);
+        if (--pendentes == 0) cvFim.notify_one();
+    }
+}
+
+void MotorProfiler::coletarFatia(Trabalhador &t) {
+    for (uint32_t indice : t.indices) {
+        AlvoProfiler &alvo = tabela[indice];
+        if (!alvo.ativo) continue;
+
+        // Processo encerrado (pidfd legível): desativa sem passar pelos coletores (que reportariam o erro no terminal)
+        if (alvo.processo.encerrou()) {
+            alvo.ativo = false;
+            alvo.processo.fechar();
+            alvo.anel = ReservaAnel(); // o slot pode ir para outro processo; as amostras ficam no arquivo
+            alvo.historico = ReservaHistorico(); // a série continua consultável até ser reaproveitada
+            alvo.instantaneo = ReservaInstantaneo(); // sai da tabela compartilhada: só processos monitorados
+            t.sessao.liberar(alvo.pid);
+            t.rastreador.liberar(alvo.pid);
+            continue;
+        }
+
+        StatusProcesso amostra = alvo.atual;
+        bool ok = coletorSnapshot(alvo.processo, amostra, t.sessao) && (!coletarRede || coletorNetwork(alvo.processo, amostra, t.rastreador));
+        if (!ok) {
+            alvo.ativo = false;
+            alvo.processo.fechar();
+            alvo.anel = ReservaAnel();
+            alvo.historico = ReservaHistorico();
+            alvo.instantaneo = ReservaInstantaneo();
+            t.sessao.liberar(alvo.pid);
+            t.rastreador.liberar(alvo.pid);
+            continue;
+        }
+
+        alvo.anterior = alvo.atual;
+        alvo.atual = amostra;
+        if (++alvo.amostras >= 2) {
+            calcularMedicao(alvo.anterior, alvo.atual, nucleosOnline, alvo.taxas);
+            alvo.historico.adicionar(instanteRealMs(), alvo.atual, alvo.taxas); // sem a 1ª amostra: CPU% zerado distorceria o mínimo
+        }
+        alvo.anel.gravar(alvo.atual, alvo.taxas); // primeira amostra com taxas zeradas, como no CSV
+        alvo.instantaneo.publicar(alvo.atual, alvo.taxas);
+    }
+}
+
+// ---- Experimento nº9: escala do motor ----
+
+void benchmarkMotor() {
+    const int numAlvos = 1000;
+    const int ticksMedidos = 5;
+
+    std::cout << "\n\033[1;33m========= Experimento nº9 - Motor multi-PID (" << numAlvos << " alvos) =========\033[0m\n";
+
+    // Frota de processos ociosos: cada filho só espera o sinal de término
+    std::vector<int> filhos;
+    filhos.reserve(numAlvos);
+    for (int i = 0; i < numAlvos; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "fork falhou depois de " << filhos.size() << " processos: " << std::strerror(errno) << "\n";
+            break;
+        }
+        if (pid == 0) {
+            pause();
+            _exit(0);
+        }
+        filhos.push_back(pid);
+    }
+
+    long nucleos = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    std::vector<size_t> configuracoes = { 1, 2, 4 };
+    if (nucleos > 4) configuracoes.push_back(static_cast<size_t>(nucleos));
+
+    std::cout << " Núcleos online: " << nucleos << " | alvos: " << filhos.size() << " | rede: ativa\n\n";
+    std::cout << " " << std::left << std::setw(10) << "Workers"
+        << std::right << std::setw(14) << "ms/tick" << std::setw(14) << "µs/alvo" << std::setw(18) << "Taxa máx. (Hz)" << "\n";
+
+    for (size_t numTrab : configuracoes) {
+        MotorProfiler motor(numTrab);
+        motor.alvosPorPIDs(filhos);
+        motor.amostrar(); // primeiro tick abre todos os descritores
+
+        double totalMs = 0;
+        for (int i = 0; i < ticksMedidos; ++i) {
+            motor.amostrar();
+            totalMs += motor.duracaoUltimoTickMs();
+        }
+        double msPorTick = totalMs / ticksMedidos;
+        std::cout << " " << std::left << std::setw(10) << numTrab << std::right << std::fixed << std::setprecision(3)
+            << std::setw(14) << msPorTick
+            << std::setw(14) << msPorTick * 1000.0 / static_cast<double>(std::max<size_t>(1, motor.alvosAtivos()))
+            << std::setw(17) << 1000.0 / msPorTick << "\n";
+    }
+    std::cout << std::defaultfloat;
+
+    for (int pid : filhos) kill(pid, SIGKILL);
+    for (int pid : filhos) waitpid(pid, nullptr, 0);
+    std::cout << "\n A taxa máxima é o inverso da duração do tick: acima dela o agendador passa a perder prazos.\n";
+}
@@ -0,0 +1,203 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "pipeline.h"
+#include "motor.h"
+#include "rede.h"
+#include "serie.h"
+
+// Amostras entre releituras do número de núcleos online na derivação (CPU religada ou desligada no meio da execução)
+constexpr uint64_t RECARGA_NUCLEOS = 1000;
+
+PipelinePerfilador::PipelinePerfilador(ProcessoMonitorado &p, double intervaloSegundos, MonitorPSI &psi, size_t capacidadeColeta)
+    : processo(p), monitorPSI(psi), filaColeta(capacidadeColeta), agendador(intervaloSegundos),
+      latencias(std::make_unique<LatenciasColetores>()) {}
+
+PipelinePerfilador::~PipelinePerfilador() {
+    parar();
+}
+
+void PipelinePerfilador::adicionarSaida(std::string nome, size_t capacidade, std::chrono::microseconds esperaMaxima, Consumidor consumir) {
+    if (iniciado) return; // as filas são lidas pela derivação sem trava: a lista não muda com as threads rodando
+    saidas.push_back(std::make_unique<Saida>(std::move(nome), capacidade, esperaMaxima, std::move(consumir)));
+}
+
+void PipelinePerfilador::iniciar() {
+    if (iniciado) return;
+    iniciado = true;
+    encerrar.store(false, std::memory_order_relaxed);
+    fimColeta.store(false, std::memory_order_relaxed);
+    // De trás para frente: cada estágio já tem consumidor quando começa a produzir
+    for (auto &s : saidas) s->thread = std::thread(&PipelinePerfilador::executarSaida, this, std::ref(*s));
+    threadDerivacao = std::thread(&PipelinePerfilador::executarDerivacao, this);
+    threadColetor = std::thread(&PipelinePerfilador::executarColetor, this);
+}
+
+void PipelinePerfilador::parar() {
+    if (!iniciado) return;
+    encerrar.store(true, std::memory_order_relaxed); // o coletor vê no próximo prazo e envia o Fim
+    threadColetor.join();
+    threadDerivacao.join(); // repassa o Fim para todas as saídas
+    for (auto &s : saidas) s->thread.join();
+    iniciado = false;
+}
+
+void PipelinePerfilador::enviarFim(FilaSPSC<ItemPipeline> &fila, const ItemPipeline &fim) {
+    while (!fila.tentarInserir(fim)) fila.esperarEspaco();
+}
+
+void PipelinePerfilador::entregar(Saida &saida, const ItemPipeline &item) {
+    if (saida.fila.tentarInserir(item)) return;
+    if (saida.esperaMaxima.count() > 0) {
+        // Backpressure limitada: dá à saída até 'esperaMaxima' para liberar espaço
+        saida.esperas.fetch_add(1, std::memory_order_relaxed);
+        auto limite = std::chrono::steady_clock::now() + saida.esperaMaxima;
+        while (std::chrono::steady_clock::now() < limite) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            if (saida.fila.tentarInserir(item)) return;
+        }
+    }
+    saida.descartados.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PipelinePerfilador::executarColetor() {
+    SessaoColeta sessao;       // /proc/<PID>/{stat,status,io,schedstat} abertos só nesta thread
+    RastreadorFds rastreador;  // /proc/<PID>/fd
+    bool comAtrasos = ColetorTaskstats::padrao().disponivel(); // sem TASKSTATS, o tempo em CPU vem de /proc
+    uint64_t sequencia = 0;
+    MotivoFim motivo = MotivoFim::Parado;
+    ItemPipeline item;
+
+    agendador.reiniciar();
+    while (!encerrar.load(std::memory_order_relaxed)) {
+        CacheSockets::padrao().novoTick(); // tabela de sockets do namespace remontada uma vez por tick
+
+        item = ItemPipeline{};
+        item.medicao.PID = processo.pid();
+        // TASKSTATS primeiro: tempo em CPU e espera somados por todas as threads, mais os atrasos, em uma
+        // única consulta que substitui schedstat e o relógio do processo. Se falhar (ex.: EPERM), desativa
+        // e a amostra (e as seguintes) usa só /proc
+        if (comAtrasos) {
+            uint64_t inicio = instanteMonotonicoNs();
+            comAtrasos = coletorTaskstats(item.medicao, item.atrasos);
+            latencias->registrar(ColetorMedido::Taskstats, instanteMonotonicoNs() - inicio);
+        }
+        TemposColeta tempos{};
+        if (!coletorSnapshot(processo, item.medicao, sessao, &tempos, comAtrasos)) {
+            motivo = MotivoFim::FalhaColeta;
+            break;
+        }
+        uint64_t marca = instanteMonotonicoNs();
+        if (!coletorNetwork(processo, item.medicao, rastreador)) {
+            motivo = MotivoFim::FalhaColeta;
+            break;
+        }
+        uint64_t fimRede = instanteMonotonicoNs();
+        latencias->registrar(ColetorMedido::CPU, tempos.cpuNs);
+        latencias->registrar(ColetorMedido::Memoria, tempos.memoriaNs);
+        latencias->registrar(ColetorMedido::IO, tempos.ioNs);
+        latencias->registrar(ColetorMedido::Rede, fimRede - marca);
+        item.comAtrasos = comAtrasos;
+        item.sequencia = sequencia++;
+        item.instanteMs = instanteRealMs();
+        item.cpuColetorNs = tempoCPUThreadNs();
+        item.prazosPerdidos = agendador.prazosPerdidos();
+
+        // Nunca espera a derivação: com a fila cheia a amostra é perdida (e contada), a próxima sai no prazo
+        if (!filaColeta.tentarInserir(item)) descartadasColeta.fetch_add(1, std::memory_order_relaxed);
+        coletadas.fetch_add(1, std::memory_order_relaxed);
+
+        // Até o próximo prazo, acorda com os gatilhos de PSI (travamentos entre duas amostras) e com o pidfd
+        EventoPSI evento;
+        bool saiu = false;
+        while (monitorPSI.esperarEvento(agendador.proximoPrazo(), evento, processo.descritor())) {
+            if (evento.gatilho < 0) { // pidfd legível: o processo monitorado saiu
+                saiu = true;
+                break;
+            }
+            ItemPipeline aviso;
+            aviso.tipo = ItemPipeline::Tipo::Travamento;
+            aviso.removido = evento.removido;
+            aviso.pressao = evento.pressao;
+            std::snprintf(aviso.rotulo, sizeof(aviso.rotulo), "%s", evento.rotulo.c_str());
+            if (!filaColeta.tentarInserir(aviso)) descartadasColeta.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (saiu) {
+            motivo = MotivoFim::ProcessoEncerrou;
+            break;
+        }
+        agendador.esperar(); // bloqueia no timerfd até o prazo (o poll pode voltar até 1 ms antes)
+    }
+
+    ItemPipeline fim;
+    fim.tipo = ItemPipeline::Tipo::Fim;
+    fim.motivo = motivo;
+    enviarFim(filaColeta, fim);
+    fimColeta.store(true, std::memory_order_release);
+}
+
+void PipelinePerfilador::executarDerivacao() {
+    ItemPipeline item;
+    StatusProcesso anterior{};
+    bool temAnterior = false;
+    // Relido só a cada RECARGA_NUCLEOS amostras: sysconf lê /sys e não deve rodar por amostra
+    long nucleosOnline = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t amostras = 0;
+    while (true) {
+        if (!filaColeta.tentarRetirar(item)) {
+            filaColeta.esperarDados();
+            continue;
+        }
+        if (item.tipo == ItemPipeline::Tipo::Fim) {
+            for (auto &s : saidas) enviarFim(s->fila, item);
+            return;
+        }
+        if (item.tipo == ItemPipeline::Tipo::Amostra) {
+            // Taxas pelo intervalo medido entre as duas coletas; a primeira amostra sai com taxas zeradas
+            if (++amostras % RECARGA_NUCLEOS == 0) nucleosOnline = sysconf(_SC_NPROCESSORS_ONLN);
+            if (temAnterior) calcularMedicao(anterior, item.medicao, nucleosOnline, item.calculado);
+            anterior = item.medicao;
+            temAnterior = true;
+        }
+        for (auto &s : saidas) entregar(*s, item);
+    }
+}
+
+void PipelinePerfilador::executarSaida(Saida &saida) {
+    ItemPipeline item;
+    while (true) {
+        if (!saida.fila.tentarRetirar(item)) {
+            saida.fila.esperarDados();
+            continue;
+        }
+        saida.consumir(item);
+        if (item.tipo == ItemPipeline::Tipo::Fim) return;
+        saida.processados.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::vector<EstatisticasEstagio> PipelinePerfilador::estatisticas() const {
+    std::vector<EstatisticasEstagio> lista;
+    lista.push_back({ "coleta", coletadas.load(std::memory_order_relaxed),
+                      descartadasColeta.load(std::memory_order_relaxed), 0, filaColeta.capacidade() });
+    for (const auto &s : saidas)
+        lista.push_back({ s->nome, s->processados.load(std::memory_order_relaxed),
+                          s->descartados.load(std::memory_order_relaxed), s->esperas.load(std::memory_order_relaxed),
+                          s->fila.capacidade() });
+    return lista;
+}
+
+void PipelinePerfilador::imprimirResumo() {
+    agendador.imprimirResumo(); // prazos perdidos e jitter do despertar durante o monitoramento
+    printf(
+        "| Estágio (fila)           | Itens      | Descartes  | Esperas    |\n"
+        "------------------------------------------------------------------\n");
+    for (const EstatisticasEstagio &e : estatisticas()) {
+        std::string rotulo = e.nome + " (" + std::to_string(e.capacidade) + ")";
+        printf("| %-24s | %-10lu | %-10lu | %-10lu |\n", rotulo.c_str(), static_cast<unsigned long>(e.processados),
+            static_cast<unsigned long>(e.descartados), static_cast<unsigned long>(e.esperas));
+    }
+    printf("==================================================================\n\n");
+    latencias->imprimir(); // qual coletor produz os picos de latência da amostra
+}
@@ -0,0 +1,167 @@
+#include <iostream>
+#include <charconv>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include "parse.h"
+#include "psi.h"
+
+const char* nomeRecursoPSI(RecursoPSI recurso) {
+    static const char* const nomes[] = { "cpu", "memory", "io" };
+    return nomes[static_cast<int>(recurso)];
+}
+
+// Lê "chave=valor" e converte o valor (avg* em ponto flutuante, total inteiro)
+static bool lerCampoPSI(std::string_view &linha, double &valor) {
+    std::string_view token = proximoToken(linha);
+    size_t igual = token.find('=');
+    if (igual == std::string_view::npos) return false;
+    auto [ptr, erro] = std::from_chars(token.data() + igual + 1, token.data() + token.size(), valor);
+    (void)ptr;
+    return erro == std::errc();
+}
+
+bool parsePressao(std::string_view conteudo, PressaoPSI &pressao) {
+    pressao = PressaoPSI{};
+    bool achou = false;
+    while (!conteudo.empty()) {
+        std::string_view linha = proximaLinha(conteudo);
+        std::string_view tipo = proximoToken(linha); // "some" ou "full"
+        LinhaPSI *destino = tipo == "some" ? &pressao.some : tipo == "full" ? &pressao.full : nullptr;
+        if (!destino) continue;
+
+        double total = 0;
+        bool ok = lerCampoPSI(linha, destino->avg10) && lerCampoPSI(linha, destino->avg60) &&
+            lerCampoPSI(linha, destino->avg300) && lerCampoPSI(linha, total);
+        destino->totalUs = static_cast<uint64_t>(total);
+        achou = achou || ok;
+    }
+    return achou;
+}
+
+// Lê um arquivo de pressão inteiro (são sempre menores que 256 bytes)
+static bool lerArquivoPressao(int fd, PressaoPSI &pressao) {
+    char buf[256];
+    ssize_t lidos = pread(fd, buf, sizeof(buf), 0);
+    if (lidos <= 0) return false;
+    return parsePressao(std::string_view(buf, static_cast<size_t>(lidos)), pressao);
+}
+
+bool lerPressaoSistema(RecursoPSI recurso, PressaoPSI &pressao) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/pressure/%s", nomeRecursoPSI(recurso));
+    int fd = open(caminho, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false; // kernel sem PSI (CONFIG_PSI ou psi=0)
+    bool ok = lerArquivoPressao(fd, pressao);
+    close(fd);
+    return ok;
+}
+
+std::string cgroupDoProcesso(int pid) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/cgroup", pid);
+    int fd = open(caminho, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return "";
+    char buf[4096];
+    ssize_t lidos = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (lidos <= 0) return "";
+
+    // No cgroup v2 a linha é "0::/caminho"; no v1 há várias hierarquias e nenhuma é usada
+    std::string_view conteudo(buf, static_cast<size_t>(lidos));
+    while (!conteudo.empty()) {
+        std::string_view linha = proximaLinha(conteudo);
+        if (linha.rfind("0::", 0) == 0) return std::string(linha.substr(3));
+    }
+    return "";
+}
+
+// ---- MonitorPSI ----
+
+MonitorPSI::~MonitorPSI() {
+    removerTodos();
+}
+
+void MonitorPSI::removerTodos() {
+    for (auto &g : gatilhos) close(g.fd); // fechar o descritor remove o gatilho no kernel
+    gatilhos.clear();
+    descritores.clear();
+}
+
+int MonitorPSI::adicionarGatilho(const std::string &arquivo, bool full, uint32_t limiarUs, uint32_t janelaUs) {
+    int fd = open(arquivo.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "PSI: não foi possível abrir " << arquivo << ": " << std::strerror(errno) << "\n";
+        return -1;
+    }
+
+    // O kernel espera "<some|full> <limiar us> <janela us>" com o terminador nulo
+    char gatilho[64];
+    int tamanho = snprintf(gatilho, sizeof(gatilho), "%s %u %u", full ? "full" : "some", limiarUs, janelaUs);
+    bool aceito = write(fd, gatilho, static_cast<size_t>(tamanho) + 1) >= 0;
+
+    // Sem CAP_SYS_RESOURCE a janela precisa ser múltipla de 2 s: tenta de novo com a janela arredondada
+    // para cima e o limiar na mesma proporção (150 ms/1 s vira 300 ms/2 s)
+    const uint32_t JANELA_SEM_PRIVILEGIO = 2000000;
+    if (!aceito && errno == EINVAL && janelaUs % JANELA_SEM_PRIVILEGIO != 0) {
+        uint32_t novaJanela = (janelaUs / JANELA_SEM_PRIVILEGIO + 1) * JANELA_SEM_PRIVILEGIO;
+        limiarUs = static_cast<uint32_t>(static_cast<uint64_t>(limiarUs) * novaJanela / janelaUs);
+        janelaUs = novaJanela;
+        tamanho = snprintf(gatilho, sizeof(gatilho), "%s %u %u", full ? "full" : "some", limiarUs, janelaUs);
+        aceito = write(fd, gatilho, static_cast<size_t>(tamanho) + 1) >= 0;
+    }
+    if (!aceito) {
+        std::cerr << "PSI: gatilho \"" << gatilho << "\" recusado em " << arquivo << ": " << std::strerror(errno) << "\n";
+        close(fd);
+        return -1;
+    }
+
+    char rotulo[160];
+    snprintf(rotulo, sizeof(rotulo), "%s %u ms/%u ms em %s", full ? "full" : "some", limiarUs / 1000, janelaUs / 1000, arquivo.c_str());
+    gatilhos.push_back({ fd, rotulo });
+    descritores.push_back({ fd, POLLPRI, 0 });
+    return static_cast<int>(gatilhos.size()) - 1;
+}
+
+bool MonitorPSI::esperarEvento(std::chrono::steady_clock::time_point limite, EventoPSI &evento, int extra) {
+    descritores.push_back({ extra, POLLIN, 0 }); // último slot; fd negativo é ignorado pelo poll()
+    bool disparou = aguardarDisparo(limite, evento);
+    descritores.pop_back();
+    return disparou;
+}
+
+bool MonitorPSI::aguardarDisparo(std::chrono::steady_clock::time_point limite, EventoPSI &evento) {
+    while (true) {
+        auto restante = std::chrono::duration_cast<std::chrono::milliseconds>(limite - std::chrono::steady_clock::now());
+        if (restante.count() <= 0) return false; // prazo encerrado sem disparo
+
+        // Sem gatilhos o poll() apenas dorme até o prazo
+        int prontos = poll(descritores.data(), descritores.size(), static_cast<int>(restante.count()));
+        if (prontos < 0 && errno == EINTR) continue;
+        if (prontos < 0) std::this_thread::sleep_until(limite); // erro inesperado: mantém o intervalo do chamador
+        if (prontos <= 0) return false;
+
+        if (descritores.back().revents) { // descritor extra do chamador
+            evento.gatilho = -1;
+            evento.rotulo.clear();
+            evento.removido = false;
+            evento.pressao = PressaoPSI{};
+            return true;
+        }
+        for (size_t i = 0; i < gatilhos.size(); ++i) {
+            short eventos = descritores[i].revents;
+            if (!eventos) continue;
+            evento.gatilho = static_cast<int>(i);
+            evento.rotulo = gatilhos[i].rotulo;
+            evento.removido = eventos & POLLERR; // cgroup removido: o gatilho não dispara mais
+            evento.pressao = PressaoPSI{};
+            if (evento.removido) descritores[i].fd = -1; // poll() ignora descritores negativos
+            else lerArquivoPressao(gatilhos[i].fd, evento.pressao);
+            descritores[i].revents = 0;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "sketch.h"
+
+static const double GAMMA = (1 + SketchQuantis::ALFA) / (1 - SketchQuantis::ALFA);
+static const double INVERSO_LOG_GAMMA = 1.0 / std::log(GAMMA);
+
+void SketchQuantis::limpar() {
+    std::fill(contagens, contagens + NUM_BUCKETS, 0);
+    total = 0;
+    menor = std::numeric_limits<double>::max();
+    maior = 0;
+    soma = 0;
+}
+
+void SketchQuantis::adicionar(double valor) {
+    uint32_t indice = 0;
+    if (valor > 1) {
+        double i = std::ceil(std::log(valor) * INVERSO_LOG_GAMMA);
+        indice = i >= NUM_BUCKETS - 1 ? NUM_BUCKETS - 1 : static_cast<uint32_t>(i);
+    }
+    ++contagens[indice];
+    ++total;
+    menor = std::min(menor, valor);
+    maior = std::max(maior, valor);
+    soma += valor;
+}
+
+void SketchQuantis::mesclar(const SketchQuantis &outro) {
+    if (outro.total == 0) return;
+    for (uint32_t i = 0; i < NUM_BUCKETS; ++i) contagens[i] += outro.contagens[i];
+    total += outro.total;
+    menor = std::min(menor, outro.menor);
+    maior = std::max(maior, outro.maior);
+    soma += outro.soma;
+}
+
+double SketchQuantis::quantil(double q) const {
+    if (total == 0) return 0;
+    if (q <= 0) return menor;
+    if (q >= 1) return maior;
+
+    // Posição (0-based) da amostra pedida; o valor do bucket é o ponto de erro relativo mínimo do intervalo
+    uint64_t posicao = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+    uint64_t acumulado = 0;
+    for (uint32_t i = 0; i < NUM_BUCKETS; ++i) {
+        acumulado += contagens[i];
+        if (acumulado > posicao) {
+            double valor = 2 * std::pow(GAMMA, static_cast<double>(i)) / (GAMMA + 1);
+            return std::clamp(valor, menor, maior); // os extremos são exatos
+        }
+    }
+    return maior;
+}
+
+size_t SketchQuantis::serializar(uint8_t *destino, size_t capacidade) const {
+    CabecalhoSketch cabecalho{};
+    cabecalho.contagem = total;
+    cabecalho.minimo = minimo();
+    cabecalho.maximo = maximo();
+    cabecalho.soma = soma;
+
+    size_t usado = sizeof(cabecalho);
+    if (capacidade < usado) return 0;
+    for (uint32_t i = 0; i < NUM_BUCKETS; ++i) {
+        if (contagens[i] == 0) continue;
+        if (usado + sizeof(BucketSketch) > capacidade) return 0;
+        BucketSketch bucket{ i, static_cast<uint32_t>(std::min<uint64_t>(contagens[i], UINT32_MAX)) };
+        std::memcpy(destino + usado, &bucket, sizeof(bucket));
+        usado += sizeof(bucket);
+        ++cabecalho.buckets;
+    }
+    std::memcpy(destino, &cabecalho, sizeof(cabecalho)); // por último: 'buckets' só é conhecido no fim
+    return usado;
+}
+
+bool SketchQuantis::desserializar(const uint8_t *origem, size_t tamanho) {
+    CabecalhoSketch cabecalho;
+    if (tamanho < sizeof(cabecalho)) return false;
+    std::memcpy(&cabecalho, origem, sizeof(cabecalho));
+    if (tamanho != sizeof(cabecalho) + static_cast<size_t>(cabecalho.buckets) * sizeof(BucketSketch)) return false;
+
+    limpar();
+    uint64_t somaBuckets = 0;
+    for (uint32_t b = 0; b < cabecalho.buckets; ++b) {
+        BucketSketch bucket;
+        std::memcpy(&bucket, origem + sizeof(cabecalho) + b * sizeof(BucketSketch), sizeof(bucket));
+        if (bucket.indice >= NUM_BUCKETS) {
+            limpar();
+            return false;
+        }
+        contagens[bucket.indice] += bucket.contagem;
+        somaBuckets += bucket.contagem;
+    }
+    if (somaBuckets != cabecalho.contagem) { // contagem truncada ou mensagem corrompida
+        limpar();
+        return false;
+    }
+    total = cabecalho.contagem;
+    if (total) {
+        menor = cabecalho.minimo;
+        maior = cabecalho.maximo;
+    }
+    soma = cabecalho.soma;
+    return true;
+}
@@ -0,0 +1,383 @@
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "anel.h"
+
+static constexpr uint32_t MAGICA_ANEL = 0x47524d52; // "RMRG"
+static constexpr uint16_t VERSAO_ANEL = 1;
+static constexpr uint64_t NUMERO_INVALIDO = ~0ULL;
+static constexpr int TENTATIVAS_LEITURA = 1000;
+
+static_assert(sizeof(CabecalhoAnel) == 64 && sizeof(SlotAnel) == 64, "cabeçalho e slots ocupam uma linha de cache");
+static_assert(sizeof(RegistroAnel) == 224, "layout do registro do anel mudou");
+// O anel é compartilhado entre processos: os atômicos precisam ser livres de trava (uma instrução na memória mapeada)
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "atômicos do anel precisam ser lock-free");
+
+static int64_t agoraMs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts); // vDSO: sem syscall
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static size_t tamanhoArquivo(uint32_t maxProcessos, uint32_t registrosPorProcesso) {
+    return sizeof(CabecalhoAnel) + sizeof(SlotAnel) * maxProcessos +
+           sizeof(RegistroAnel) * static_cast<size_t>(maxProcessos) * registrosPorProcesso;
+}
+
+void paraRegistroAnel(const StatusProcesso &m, const calculoMedicao &c, RegistroAnel &r) {
+    r.pid = m.PID;
+    r.threads = m.threads;
+    r.contextSwitchfree = m.contextSwitchfree;
+    r.contextSwitchforced = m.contextSwitchforced;
+    r.conexoesAtivas = m.conexoesAtivas;
+    r.reservado = 0;
+    r.utime = m.utime;
+    r.stime = m.stime;
+    r.tempoCPU = m.tempoCPU;
+    r.esperaCPU = m.esperaCPU;
+    r.vmSize = m.vmSize;
+    r.vmRss = m.vmRss;
+    r.vmSwap = m.vmSwap;
+    r.minfault = m.minfault;
+    r.mjrfault = m.mjrfault;
+    r.bytesLidos = m.bytesLidos;
+    r.bytesEscritos = m.bytesEscritos;
+    r.syscallLeitura = m.syscallLeitura;
+    r.syscallEscrita = m.syscallEscrita;
+    r.rchar = m.rchar;
+    r.wchar = m.wchar;
+    r.bytesRxfila = m.bytesRxfila;
+    r.bytesTxfila = m.bytesTxfila;
+    r.usoCPU = c.usoCPU;
+    r.usoCPUGlobal = c.usoCPUGlobal;
+    r.taxaLeituraDisco = c.taxaLeituraDisco;
+    r.taxaLeituraTotal = c.taxaLeituraTotal;
+    r.taxaEscritaDisco = c.taxaEscritaDisco;
+    r.taxaEscritaTotal = c.taxaEscritaTotal;
+}
+
+void deRegistroAnel(const RegistroAnel &r, StatusProcesso &m, calculoMedicao &c) {
+    m = StatusProcesso{};
+    m.PID = r.pid;
+    m.threads = r.threads;
+    m.contextSwitchfree = r.contextSwitchfree;
+    m.contextSwitchforced = r.contextSwitchforced;
+    m.conexoesAtivas = r.conexoesAtivas;
+    m.utime = r.utime;
+    m.stime = r.stime;
+    m.tempoCPU = r.tempoCPU;
+    m.esperaCPU = r.esperaCPU;
+    m.vmSize = r.vmSize;
+    m.vmRss = r.vmRss;
+    m.vmSwap = r.vmSwap;
+    m.minfault = r.minfault;
+    m.mjrfault = r.mjrfault;
+    m.bytesLidos = r.bytesLidos;
+    m.bytesEscritos = r.bytesEscritos;
+    m.syscallLeitura = r.syscallLeitura;
+    m.syscallEscrita = r.syscallEscrita;
+    m.rchar = r.rchar;
+    m.wchar = r.wchar;
+    m.bytesRxfila = r.bytesRxfila;
+    m.bytesTxfila = r.bytesTxfila;
+    c.usoCPU = r.usoCPU;
+    c.usoCPUGlobal = r.usoCPUGlobal;
+    c.taxaLeituraDisco = r.taxaLeituraDisco;
+    c.taxaLeituraTotal = r.taxaLeituraTotal;
+    c.taxaEscritaDisco = r.taxaEscritaDisco;
+    c.taxaEscritaTotal = r.taxaEscritaTotal;
+}
+
+// ---- AnelAmostras ----
+
+AnelAmostras& AnelAmostras::padrao() {
+    static AnelAmostras anel("docs/recentes.anel", 1024, 256); // ~56 MiB esparsos; só as páginas usadas ocupam disco
+    return anel;
+}
+
+AnelAmostras::AnelAmostras(std::string arquivo, uint32_t maxProcessos, uint32_t registrosPorProcesso)
+    : caminho(std::move(arquivo)) {
+    if (maxProcessos == 0) maxProcessos = 1;
+    if (registrosPorProcesso == 0) registrosPorProcesso = 1;
+
+    fd = open(caminho.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Aviso: não foi possível abrir " << caminho << " (" << std::strerror(errno) << "), anel de amostras desativado\n";
+        return;
+    }
+    // Um escritor por arquivo: dois monitores no mesmo anel corromperiam os slots um do outro
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        std::cerr << "Aviso: " << caminho << " já está em uso por outro monitor, anel de amostras desativado\n";
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    size_t tamanho = tamanhoArquivo(maxProcessos, registrosPorProcesso);
+    struct stat info{};
+    bool reaproveitar = false;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == tamanho) {
+        CabecalhoAnel antigo{};
+        reaproveitar = pread(fd, &antigo, sizeof(antigo), 0) == static_cast<ssize_t>(sizeof(antigo)) &&
+                       antigo.magica == MAGICA_ANEL && antigo.versao == VERSAO_ANEL &&
+                       antigo.tamanhoRegistro == sizeof(RegistroAnel) && antigo.maxProcessos == maxProcessos &&
+                       antigo.registrosPorProcesso == registrosPorProcesso;
+    }
+    // Arquivo novo (ou de outra geometria): zerado pelo ftruncate, sem escrever as páginas
+    if (!reaproveitar && (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(tamanho)) != 0)) {
+        std::cerr << "Aviso: não foi possível dimensionar " << caminho << " (" << std::strerror(errno) << "), anel de amostras desativado\n";
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    void *p = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Aviso: mmap de " << caminho << " falhou (" << std::strerror(errno) << "), anel de amostras desativado\n";
+        close(fd);
+        fd = -1;
+        return;
+    }
+    mapa = p;
+    tamanhoMapa = tamanho;
+    cabecalho = static_cast<CabecalhoAnel*>(p);
+    slots = reinterpret_cast<SlotAnel*>(static_cast<char*>(p) + sizeof(CabecalhoAnel));
+    registros = reinterpret_cast<RegistroAnel*>(slots + maxProcessos);
+    emUso.assign(maxProcessos, false);
+
+    if (reaproveitar) {
+        // O monitor anterior pode ter morrido no meio de uma gravação: a sequência volta a ser par, e o registro
+        // interrompido fica com NUMERO_INVALIDO (ou com o número antigo), que o leitor já descarta
+        for (uint32_t i = 0; i < maxProcessos; ++i) {
+            uint32_t s = slots[i].sequencia.load(std::memory_order_relaxed);
+            if (s & 1) slots[i].sequencia.store(s + 1, std::memory_order_release);
+        }
+        return;
+    }
+
+    cabecalho->versao = VERSAO_ANEL;
+    cabecalho->tamanhoRegistro = sizeof(RegistroAnel);
+    cabecalho->maxProcessos = maxProcessos;
+    cabecalho->registrosPorProcesso = registrosPorProcesso;
+    cabecalho->criadoMs = agoraMs();
+    std::atomic_thread_fence(std::memory_order_release);
+    cabecalho->magica = MAGICA_ANEL; // por último: um leitor não aceita um cabeçalho pela metade
+}
+
+AnelAmostras::~AnelAmostras() {
+    if (mapa) munmap(mapa, tamanhoMapa); // sem msync: o page cache grava as páginas sozinho
+    if (fd >= 0) close(fd);              // libera o flock
+}
+
+int AnelAmostras::reservar(int pid, uint64_t starttime) {
+    if (!mapa) return -1;
+    std::lock_guard<std::mutex> lock(trava);
+    const uint32_t total = cabecalho->maxProcessos;
+    int livre = -1, maisAntigo = -1, mesmo = -1;
+    for (uint32_t i = 0; i < total; ++i) {
+        if (emUso[i]) continue;
+        if (slots[i].pid == pid && slots[i].starttime == starttime) {
+            mesmo = static_cast<int>(i);
+            break;
+        }
+        if (slots[i].pid == 0) {
+            if (livre < 0) livre = static_cast<int>(i);
+        }
+        else if (maisAntigo < 0 || slots[i].atualizadoMs < slots[maisAntigo].atualizadoMs) {
+            maisAntigo = static_cast<int>(i);
+        }
+    }
+
+    int slot = mesmo >= 0 ? mesmo : livre >= 0 ? livre : maisAntigo;
+    if (slot < 0) return -1;
+    emUso[slot] = true;
+    if (slot == mesmo) return slot; // mesmo processo de uma execução anterior: continua o anel dele
+
+    SlotAnel &s = slots[slot];
+    uint32_t seq = s.sequencia.load(std::memory_order_relaxed);
+    s.sequencia.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.pid = pid;
+    s.starttime = starttime;
+    s.escritos.store(0, std::memory_order_relaxed);
+    s.atualizadoMs = agoraMs();
+    s.sequencia.store(seq + 2, std::memory_order_release);
+    return slot;
+}
+
+void AnelAmostras::liberar(int slot) {
+    if (!mapa || slot < 0 || static_cast<uint32_t>(slot) >= cabecalho->maxProcessos) return;
+    std::lock_guard<std::mutex> lock(trava);
+    emUso[slot] = false;
+}
+
+void AnelAmostras::gravar(int slot, const StatusProcesso &medicao, const calculoMedicao &calculado) {
+    if (!mapa || slot < 0 || static_cast<uint32_t>(slot) >= cabecalho->maxProcessos) return;
+    SlotAnel &s = slots[slot];
+    const uint32_t porProcesso = cabecalho->registrosPorProcesso;
+    uint64_t numero = s.escritos.load(std::memory_order_relaxed);
+    RegistroAnel &destino = registros[static_cast<size_t>(slot) * porProcesso + numero % porProcesso];
+
+    RegistroAnel novo;
+    paraRegistroAnel(medicao, calculado, novo);
+    novo.instanteMs = agoraMs();
+
+    // Seqlock: ímpar durante a escrita. O número do registro é invalidado antes dos dados e gravado depois,
+    // então um registro interrompido por um crash (sequência ímpar no arquivo) nunca parece válido
+    uint32_t seq = s.sequencia.load(std::memory_order_relaxed);
+    s.sequencia.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref<uint64_t>(destino.numero).store(NUMERO_INVALIDO, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(reinterpret_cast<char*>(&destino) + sizeof(uint64_t), reinterpret_cast<const char*>(&novo) + sizeof(uint64_t),
+                sizeof(RegistroAnel) - sizeof(uint64_t));
+    std::atomic_ref<uint64_t>(destino.numero).store(numero, std::memory_order_release);
+    s.escritos.store(numero + 1, std::memory_order_relaxed);
+    s.atualizadoMs = novo.instanteMs;
+    s.sequencia.store(seq + 2, std::memory_order_release);
+}
+
+// ---- ReservaAnel ----
+
+ReservaAnel::ReservaAnel(AnelAmostras &a, const ProcessoMonitorado &processo)
+    : anel(&a), slot(a.reservar(processo.pid(), processo.inicio())) {}
+
+ReservaAnel::~ReservaAnel() {
+    if (slot >= 0) anel->liberar(slot);
+}
+
+ReservaAnel::ReservaAnel(ReservaAnel &&outra) noexcept : anel(outra.anel), slot(outra.slot) {
+    outra.slot = -1;
+}
+
+ReservaAnel& ReservaAnel::operator=(ReservaAnel &&outra) noexcept {
+    if (this != &outra) {
+        if (slot >= 0) anel->liberar(slot);
+        anel = outra.anel;
+        slot = outra.slot;
+        outra.slot = -1;
+    }
+    return *this;
+}
+
+// ---- LeitorAnel ----
+
+LeitorAnel::~LeitorAnel() {
+    fechar();
+}
+
+void LeitorAnel::fechar() {
+    if (mapa) munmap(const_cast<void*>(mapa), tamanhoMapa);
+    if (fd >= 0) close(fd);
+    mapa = nullptr;
+    fd = -1;
+    cabecalho = nullptr;
+    slots = nullptr;
+    registros = nullptr;
+}
+
+bool LeitorAnel::abrir(const std::string &caminho) {
+    fechar();
+    fd = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Erro ao abrir " << caminho << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat info{};
+    CabecalhoAnel c{};
+    if (fstat(fd, &info) != 0 || pread(fd, &c, sizeof(c), 0) != static_cast<ssize_t>(sizeof(c)) ||
+        c.magica != MAGICA_ANEL || c.versao != VERSAO_ANEL || c.tamanhoRegistro != sizeof(RegistroAnel) ||
+        static_cast<size_t>(info.st_size) != tamanhoArquivo(c.maxProcessos, c.registrosPorProcesso)) {
+        std::cerr << "Erro: " << caminho << " não é um anel de amostras válido.\n";
+        fechar();
+        return false;
+    }
+
+    size_t tamanho = static_cast<size_t>(info.st_size);
+    void *p = mmap(nullptr, tamanho, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Erro: mmap de " << caminho << " falhou: " << std::strerror(errno) << "\n";
+        fechar();
+        return false;
+    }
+    mapa = p;
+    tamanhoMapa = tamanho;
+    cabecalho = static_cast<const CabecalhoAnel*>(p);
+    slots = reinterpret_cast<const SlotAnel*>(static_cast<const char*>(p) + sizeof(CabecalhoAnel));
+    registros = reinterpret_cast<const RegistroAnel*>(slots + c.maxProcessos);
+    return true;
+}
+
+bool LeitorAnel::escritorAtivo() const {
+    if (fd < 0) return false;
+    if (flock(fd, LOCK_SH | LOCK_NB) != 0) return errno == EWOULDBLOCK; // o escritor segura LOCK_EX
+    flock(fd, LOCK_UN);
+    return false;
+}
+
+std::vector<ResumoSlotAnel> LeitorAnel::processos() const {
+    std::vector<ResumoSlotAnel> lista;
+    if (!mapa) return lista;
+    std::vector<RegistroAnel> vazio;
+    for (uint32_t i = 0; i < cabecalho->maxProcessos; ++i) {
+        if (slots[i].pid == 0) continue; // nunca usado (leitura sem seqlock: só um filtro rápido)
+        ResumoSlotAnel resumo{};
+        if (lerUltimos(i, 0, vazio, &resumo) && resumo.pid != 0) lista.push_back(resumo);
+    }
+    std::sort(lista.begin(), lista.end(),
+        [](const ResumoSlotAnel &a, const ResumoSlotAnel &b) { return a.atualizadoMs > b.atualizadoMs; });
+    return lista;
+}
+
+bool LeitorAnel::lerUltimos(uint32_t slot, size_t maximo, std::vector<RegistroAnel> &saida, ResumoSlotAnel *resumo) const {
+    saida.clear();
+    if (!mapa || slot >= cabecalho->maxProcessos) return false;
+    const SlotAnel &s = slots[slot];
+    const uint32_t porProcesso = cabecalho->registrosPorProcesso;
+    const RegistroAnel *anel = registros + static_cast<size_t>(slot) * porProcesso;
+    bool semEscritor = false; // decidido uma vez, só se a sequência estiver ímpar
+
+    for (int tentativa = 0; tentativa < TENTATIVAS_LEITURA; ++tentativa) {
+        uint32_t antes = s.sequencia.load(std::memory_order_acquire);
+        if ((antes & 1) && !semEscritor) {
+            // Ímpar: gravação em andamento, ou um escritor que morreu no meio dela (aí a sequência não muda mais)
+            if (!escritorAtivo()) semEscritor = true;
+            else {
+                sched_yield();
+                continue;
+            }
+        }
+
+        ResumoSlotAnel copia{ slot, s.pid, s.starttime, s.escritos.load(std::memory_order_relaxed), s.atualizadoMs };
+        uint64_t quantidade = std::min<uint64_t>({ copia.escritos, porProcesso, maximo });
+        saida.resize(quantidade);
+        for (uint64_t k = 0; k < quantidade; ++k) {
+            uint64_t numero = copia.escritos - quantidade + k;
+            std::memcpy(&saida[k], &anel[numero % porProcesso], sizeof(RegistroAnel));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!semEscritor && s.sequencia.load(std::memory_order_relaxed) != antes) continue; // o escritor mexeu: de novo
+
+        // Registros que não têm o número esperado foram interrompidos por um crash: ficam de fora
+        size_t validos = 0;
+        for (uint64_t k = 0; k < quantidade; ++k) {
+            if (saida[k].numero != copia.escritos - quantidade + k) continue;
+            saida[validos++] = saida[k];
+        }
+        saida.resize(validos);
+        if (resumo) *resumo = copia;
+        return true;
+    }
+    saida.clear();
+    return false;
+}
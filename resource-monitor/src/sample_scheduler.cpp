@@ -0,0 +1,130 @@
+#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "agendador.h"
+
+static timespec paraTimespec(uint64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ULL);
+    return ts;
+}
+
+uint64_t instanteMonotonicoNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts); // vDSO: sem syscall
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+AgendadorAmostras::AgendadorAmostras(double intervaloSegundos) {
+    // Ajusta antes da conversão: um double negativo, NaN ou grande demais convertido para uint64_t é indefinido
+    double ns = intervaloSegundos * 1e9;
+    if (!(ns >= static_cast<double>(PERIODO_MINIMO_NS))) { // também pega NaN
+        std::cerr << "Aviso: intervalo de " << intervaloSegundos << " s ajustado para o mínimo de "
+            << PERIODO_MINIMO_NS / 1000000 << " ms\n";
+        periodo = PERIODO_MINIMO_NS;
+    }
+    else if (ns > static_cast<double>(PERIODO_MAXIMO_NS)) {
+        std::cerr << "Aviso: intervalo de " << intervaloSegundos << " s ajustado para o máximo de "
+            << PERIODO_MAXIMO_NS / 1000000000ULL << " s\n";
+        periodo = PERIODO_MAXIMO_NS;
+    }
+    else {
+        periodo = static_cast<uint64_t>(ns);
+    }
+    fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (fd < 0) // sem timerfd, esperar() dorme com clock_nanosleep até o mesmo prazo absoluto
+        std::cerr << "Aviso: timerfd indisponível (" << std::strerror(errno) << "), usando clock_nanosleep\n";
+    reiniciar();
+}
+
+AgendadorAmostras::~AgendadorAmostras() {
+    if (fd >= 0) close(fd);
+}
+
+void AgendadorAmostras::reiniciar() {
+    inicio = instanteMonotonicoNs();
+    expiracoes = 0;
+    if (fd < 0) return;
+
+    // Primeiro disparo em inicio + período (absoluto) e depois a cada período, sem depender de quando o read() acontece
+    itimerspec prazo{};
+    prazo.it_value = paraTimespec(inicio + periodo);
+    prazo.it_interval = paraTimespec(periodo);
+    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &prazo, nullptr) < 0) {
+        std::cerr << "Aviso: timerfd_settime falhou: " << std::strerror(errno) << "\n";
+        close(fd);
+        fd = -1;
+    }
+}
+
+std::chrono::steady_clock::time_point AgendadorAmostras::proximoPrazo() const {
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(inicio + (expiracoes + 1) * periodo));
+}
+
+uint64_t AgendadorAmostras::esperar() {
+    uint64_t vencidos = 0; // prazos vencidos desde a última espera
+    if (fd >= 0) {
+        // read() bloqueia até o próximo disparo e devolve quantos prazos venceram desde o último read()
+        while (read(fd, &vencidos, sizeof(vencidos)) < 0) {
+            if (errno != EINTR) { vencidos = 0; break; }
+        }
+    }
+    if (vencidos == 0) { // sem timerfd (ou erro na leitura): mesma grade com clock_nanosleep
+        uint64_t agora = instanteMonotonicoNs();
+        uint64_t proximo = inicio + (expiracoes + 1) * periodo;
+        if (agora < proximo) {
+            timespec ts = paraTimespec(proximo);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+            vencidos = 1;
+        }
+        else {
+            vencidos = (agora - inicio) / periodo - expiracoes; // prazos que passaram durante a volta
+        }
+    }
+
+    uint64_t despertar = instanteMonotonicoNs();
+    expiracoes += vencidos;
+    perdidos += vencidos - 1; // mais de um vencido: as amostras desses prazos não aconteceram
+
+    // Jitter: quanto o despertar atrasou em relação ao último prazo vencido
+    uint64_t prazo = inicio + expiracoes * periodo;
+    uint64_t jitter = despertar > prazo ? despertar - prazo : 0;
+    uint64_t jitterUs = jitter / 1000;
+    size_t faixa = std::min<size_t>(static_cast<size_t>(std::bit_width(jitterUs)), FAIXAS_JITTER - 1);
+    ++histograma[faixa];
+    ++amostras;
+    jitterSoma += jitter;
+    jitterMax = std::max(jitterMax, jitter);
+    return despertar;
+}
+
+void AgendadorAmostras::imprimirResumo() const {
+    printf(
+        "| Agendamento das amostras |            |\n"
+        "-----------------------------------------\n"
+        "| Período (ms)             | %-10.3f |\n"
+        "| Despertares              | %-10lu |\n"
+        "| Prazos perdidos          | %-10lu |\n"
+        "| Jitter médio (µs)        | %-10.1f |\n"
+        "| Jitter máximo (µs)       | %-10.1f |\n"
+        "-----------------------------------------\n"
+        "| Jitter (µs)              | Amostras   |\n",
+        static_cast<double>(periodo) / 1e6, static_cast<unsigned long>(amostras),
+        static_cast<unsigned long>(perdidos), jitterMedioUs(), static_cast<double>(jitterMax) / 1e3);
+    for (size_t i = 0; i < FAIXAS_JITTER; ++i) {
+        if (!histograma[i]) continue; // só as faixas com amostras
+        unsigned long de = i ? 1UL << (i - 1) : 0;
+        if (i == FAIXAS_JITTER - 1)
+            printf("| >= %-21lu | %-10lu |\n", de, static_cast<unsigned long>(histograma[i]));
+        else
+            printf("| %-9lu a %-12lu | %-10lu |\n", de, (1UL << i) - 1, static_cast<unsigned long>(histograma[i]));
+    }
+    printf("=========================================\n\n");
+}
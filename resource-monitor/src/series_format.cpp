@@ -0,0 +1,648 @@
+#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "serie.h"
+#include "csv.h"
+
+static constexpr uint32_t MAGICA_SERIE = 0x53544d52;  // "RMTS"
+static constexpr uint32_t MAGICA_BLOCO = 0x31424d52;  // "RMB1"
+static constexpr uint32_t MAGICA_INDICE = 0x49544d52; // "RMTI"
+static constexpr uint16_t VERSAO_SERIE = 1;
+
+static_assert(sizeof(CabecalhoSerie) == 16, "layout do cabeçalho do arquivo mudou");
+static_assert(sizeof(CabecalhoBlocoSerie) == 40, "layout do cabeçalho de bloco mudou");
+static_assert(sizeof(EntradaIndiceSerie) == 32, "layout do índice mudou");
+static_assert(sizeof(RodapeSerie) == 16, "layout do rodapé mudou");
+
+// ---- Colunas ----
+// A ordem aqui é o formato: mudar a ordem ou a quantidade exige outra VERSAO_SERIE
+
+static constexpr int COLUNAS_INTEIRAS = 17; // contadores e gauges inteiros: delta em varint zigzag
+static constexpr int COLUNAS_TEMPO = 4;     // tempos de CPU (s) gravados como ns inteiros: delta em varint zigzag
+static constexpr int COLUNAS_TAXA = 6;      // calculoMedicao: XOR de doubles
+static constexpr uint16_t TOTAL_COLUNAS = 1 + COLUNAS_INTEIRAS + COLUNAS_TEMPO + COLUNAS_TAXA; // + instante
+
+static uint64_t inteiro(const StatusProcesso &m, int coluna) {
+    switch (coluna) {
+    case 0: return m.threads;
+    case 1: return m.contextSwitchfree;
+    case 2: return m.contextSwitchforced;
+    case 3: return m.vmSize;
+    case 4: return m.vmRss;
+    case 5: return m.vmSwap;
+    case 6: return m.minfault;
+    case 7: return m.mjrfault;
+    case 8: return m.bytesLidos;
+    case 9: return m.bytesEscritos;
+    case 10: return m.syscallLeitura;
+    case 11: return m.syscallEscrita;
+    case 12: return m.rchar;
+    case 13: return m.wchar;
+    case 14: return m.bytesRxfila;
+    case 15: return m.bytesTxfila;
+    default: return m.conexoesAtivas;
+    }
+}
+
+static void definirInteiro(StatusProcesso &m, int coluna, uint64_t v) {
+    switch (coluna) {
+    case 0: m.threads = static_cast<unsigned int>(v); break;
+    case 1: m.contextSwitchfree = static_cast<unsigned int>(v); break;
+    case 2: m.contextSwitchforced = static_cast<unsigned int>(v); break;
+    case 3: m.vmSize = v; break;
+    case 4: m.vmRss = v; break;
+    case 5: m.vmSwap = v; break;
+    case 6: m.minfault = v; break;
+    case 7: m.mjrfault = v; break;
+    case 8: m.bytesLidos = v; break;
+    case 9: m.bytesEscritos = v; break;
+    case 10: m.syscallLeitura = v; break;
+    case 11: m.syscallEscrita = v; break;
+    case 12: m.rchar = v; break;
+    case 13: m.wchar = v; break;
+    case 14: m.bytesRxfila = v; break;
+    case 15: m.bytesTxfila = v; break;
+    default: m.conexoesAtivas = static_cast<unsigned int>(v); break;
+    }
+}
+
+static double& tempo(StatusProcesso &m, int coluna) {
+    switch (coluna) {
+    case 0: return m.utime;
+    case 1: return m.stime;
+    case 2: return m.tempoCPU;
+    default: return m.esperaCPU;
+    }
+}
+
+static double& taxa(calculoMedicao &c, int coluna) {
+    switch (coluna) {
+    case 0: return c.usoCPU;
+    case 1: return c.usoCPUGlobal;
+    case 2: return c.taxaLeituraDisco;
+    case 3: return c.taxaLeituraTotal;
+    case 4: return c.taxaEscritaDisco;
+    default: return c.taxaEscritaTotal;
+    }
+}
+
+// Segundos -> ns inteiros. Os tempos vêm de ticks/CLK_TCK ou ns/1e9, então ns/1e9 na volta dá o mesmo double
+static int64_t paraNs(double segundos) {
+    return std::llround(segundos * 1e9);
+}
+
+// ---- Codificação ----
+
+static uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t desfazerZigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// Diferença e soma módulo 2^64: instantes e tempos extremos (ex.: INT64_MIN e INT64_MAX no mesmo bloco)
+// estouram o int64_t, e o decodificador desfaz a conta com a mesma aritmética
+static int64_t subtrair(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+static int64_t somar(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+// LEB128: 7 bits por byte, bit alto = continua
+static void escreverVarint(std::vector<uint8_t> &saida, uint64_t v) {
+    while (v >= 0x80) {
+        saida.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    saida.push_back(static_cast<uint8_t>(v));
+}
+
+static bool lerVarint(const uint8_t *&p, const uint8_t *fim, uint64_t &v) {
+    v = 0;
+    for (int deslocamento = 0; deslocamento < 64; deslocamento += 7) {
+        if (p >= fim) return false;
+        uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << deslocamento;
+        if (!(byte & 0x80)) return true;
+    }
+    return false; // mais de 10 bytes: dado corrompido
+}
+
+// Escrita de bits do mais significativo para o menos, usada pelas colunas XOR
+class EscritaBits {
+public:
+    explicit EscritaBits(std::vector<uint8_t> &destino) : saida(destino) {}
+
+    void escrever(uint64_t valor, int bits) {
+        while (bits > 0) {
+            int k = std::min(8 - usados, bits);
+            uint8_t parte = static_cast<uint8_t>((valor >> (bits - k)) & ((1u << k) - 1));
+            atual = static_cast<uint8_t>((atual << k) | parte);
+            usados += k;
+            bits -= k;
+            if (usados == 8) {
+                saida.push_back(atual);
+                atual = 0;
+                usados = 0;
+            }
+        }
+    }
+
+    void alinhar() { // completa o último byte com zeros: cada coluna começa em um byte novo
+        if (usados) escrever(0, 8 - usados);
+    }
+
+private:
+    std::vector<uint8_t> &saida;
+    uint8_t atual = 0;
+    int usados = 0;
+};
+
+class LeituraBits {
+public:
+    LeituraBits(const uint8_t *inicio, const uint8_t *fim) : p(inicio), limite(fim) {}
+
+    uint64_t ler(int bits) {
+        uint64_t v = 0;
+        while (bits > 0) {
+            if (p >= limite) {
+                erro = true;
+                return 0;
+            }
+            int disponiveis = 8 - consumidos;
+            int k = std::min(disponiveis, bits);
+            v = (v << k) | ((*p >> (disponiveis - k)) & ((1u << k) - 1));
+            consumidos += k;
+            bits -= k;
+            if (consumidos == 8) {
+                consumidos = 0;
+                ++p;
+            }
+        }
+        return v;
+    }
+
+    const uint8_t* alinhar() {
+        if (consumidos) {
+            consumidos = 0;
+            ++p;
+        }
+        return p;
+    }
+
+    bool erro = false;
+
+private:
+    const uint8_t *p;
+    const uint8_t *limite;
+    int consumidos = 0;
+};
+
+// Coluna de doubles no esquema do Gorilla (Facebook): o primeiro valor inteiro, depois o XOR com o anterior.
+//   '0'                         -> igual ao anterior
+//   '10' + bits significativos  -> cabe na janela de zeros à esquerda/direita do XOR anterior
+//   '11' + 5 bits de zeros à esquerda + 6 bits de tamanho + bits significativos
+// Taxas que repetem (0 de I/O, CPU ociosa) custam 1 bit por amostra.
+static void codificarXOR(std::vector<uint8_t> &saida, std::vector<AmostraSerie> &amostras, int coluna) {
+    EscritaBits bits(saida);
+    uint64_t anterior = std::bit_cast<uint64_t>(taxa(amostras[0].calculado, coluna));
+    bits.escrever(anterior, 64);
+    int zerosEsquerda = -1, zerosDireita = 0; // janela do último XOR; -1 = nenhuma ainda
+    for (size_t i = 1; i < amostras.size(); ++i) {
+        uint64_t valor = std::bit_cast<uint64_t>(taxa(amostras[i].calculado, coluna));
+        uint64_t x = valor ^ anterior;
+        anterior = valor;
+        if (x == 0) {
+            bits.escrever(0, 1);
+            continue;
+        }
+        int esquerda = std::min(std::countl_zero(x), 31); // cabe em 5 bits
+        int direita = std::countr_zero(x);
+        if (zerosEsquerda >= 0 && esquerda >= zerosEsquerda && direita >= zerosDireita) {
+            bits.escrever(0b10, 2);
+            bits.escrever(x >> zerosDireita, 64 - zerosEsquerda - zerosDireita);
+        }
+        else {
+            int significativos = 64 - esquerda - direita; // 1..64, gravado como 0..63
+            bits.escrever(0b11, 2);
+            bits.escrever(static_cast<uint64_t>(esquerda), 5);
+            bits.escrever(static_cast<uint64_t>(significativos - 1), 6);
+            bits.escrever(x >> direita, significativos);
+            zerosEsquerda = esquerda;
+            zerosDireita = direita;
+        }
+    }
+    bits.alinhar();
+}
+
+static bool decodificarXOR(const uint8_t *&p, const uint8_t *fim, std::vector<AmostraSerie> &amostras, int coluna) {
+    LeituraBits bits(p, fim);
+    uint64_t anterior = bits.ler(64);
+    taxa(amostras[0].calculado, coluna) = std::bit_cast<double>(anterior);
+    int zerosEsquerda = -1, zerosDireita = 0;
+    for (size_t i = 1; i < amostras.size() && !bits.erro; ++i) {
+        if (bits.ler(1)) {
+            if (bits.ler(1)) { // '11': janela nova
+                zerosEsquerda = static_cast<int>(bits.ler(5));
+                int significativos = static_cast<int>(bits.ler(6)) + 1;
+                zerosDireita = 64 - zerosEsquerda - significativos;
+                if (zerosDireita < 0) return false;
+            }
+            else if (zerosEsquerda < 0) {
+                return false; // '10' sem janela anterior
+            }
+            anterior ^= bits.ler(64 - zerosEsquerda - zerosDireita) << zerosDireita;
+        }
+        taxa(amostras[i].calculado, coluna) = std::bit_cast<double>(anterior);
+    }
+    p = bits.alinhar();
+    return !bits.erro;
+}
+
+// FNV-1a de 32 bits: detecta blocos truncados ou sobrescritos pela metade
+static uint32_t verificacao(const uint8_t *dados, size_t tamanho) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < tamanho; ++i) {
+        h ^= dados[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Escreve o buffer inteiro em 'offset' (pwrite pode escrever menos que o pedido)
+static bool escreverEm(int fd, const void *dados, size_t tamanho, uint64_t offset) {
+    const char *p = static_cast<const char*>(dados);
+    while (tamanho > 0) {
+        ssize_t n = pwrite(fd, p, tamanho, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        tamanho -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+static bool lerEm(int fd, void *dados, size_t tamanho, uint64_t offset) {
+    char *p = static_cast<char*>(dados);
+    while (tamanho > 0) {
+        ssize_t n = pread(fd, p, tamanho, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        tamanho -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+int64_t instanteRealMs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts); // vDSO: sem syscall
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ---- EscritorSerie ----
+
+EscritorSerie::EscritorSerie(std::string arquivo, uint32_t amostrasPorBloco)
+    : caminho(std::move(arquivo)), porBloco(amostrasPorBloco ? amostrasPorBloco : 1) {
+    fd = open(caminho.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Aviso: não foi possível abrir " << caminho << " (" << std::strerror(errno) << "), série binária desativada\n";
+        return;
+    }
+    pendentes.reserve(porBloco);
+
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        // Continua o arquivo: blocos antigos ficam, o índice antigo (ou o resto de um bloco interrompido) sai
+        LeitorSerie leitor;
+        if (!leitor.abrir(caminho)) {
+            std::cerr << "Aviso: " << caminho << " não é uma série válida, série binária desativada\n";
+            close(fd);
+            fd = -1;
+            return;
+        }
+        indice = leitor.blocos();
+        tamanho = leitor.fimDados();
+        for (const EntradaIndiceSerie &e : indice) totalAmostras += e.amostras;
+        if (ftruncate(fd, static_cast<off_t>(tamanho)) != 0)
+            std::cerr << "Aviso: não foi possível truncar o índice de " << caminho << ": " << std::strerror(errno) << "\n";
+        return;
+    }
+
+    CabecalhoSerie cabecalho{ MAGICA_SERIE, VERSAO_SERIE, TOTAL_COLUNAS, porBloco, 0 };
+    if (!escreverEm(fd, &cabecalho, sizeof(cabecalho), 0)) {
+        std::cerr << "Erro ao escrever " << caminho << ": " << std::strerror(errno) << "\n";
+        close(fd);
+        fd = -1;
+        return;
+    }
+    tamanho = sizeof(cabecalho);
+}
+
+EscritorSerie::~EscritorSerie() {
+    fechar();
+}
+
+bool EscritorSerie::adicionar(int64_t instanteMs, const StatusProcesso &medicao, const calculoMedicao &calculado) {
+    if (fd < 0) return false;
+    pendentes.push_back({ instanteMs, medicao, calculado });
+    ++totalAmostras;
+    if (pendentes.size() >= porBloco) return gravarBloco();
+    return true;
+}
+
+bool EscritorSerie::gravarBloco() {
+    if (fd < 0 || pendentes.empty()) return true;
+    const size_t n = pendentes.size();
+
+    // Cabeçalho reservado no início do buffer e preenchido depois que o tamanho dos dados é conhecido
+    codificado.assign(sizeof(CabecalhoBlocoSerie), 0);
+
+    // Instantes: delta da segunda amostra, depois delta-of-delta
+    int64_t deltaAnterior = 0;
+    for (size_t i = 1; i < n; ++i) {
+        int64_t delta = subtrair(pendentes[i].instanteMs, pendentes[i - 1].instanteMs);
+        escreverVarint(codificado, zigzag(i == 1 ? delta : subtrair(delta, deltaAnterior)));
+        deltaAnterior = delta;
+    }
+    // Contadores: delta para a amostra anterior (a primeira do bloco parte de 0, o bloco se decodifica sozinho)
+    for (int c = 0; c < COLUNAS_INTEIRAS; ++c) {
+        uint64_t anterior = 0;
+        for (const AmostraSerie &a : pendentes) {
+            uint64_t v = inteiro(a.medicao, c);
+            escreverVarint(codificado, zigzag(static_cast<int64_t>(v - anterior)));
+            anterior = v;
+        }
+    }
+    for (int c = 0; c < COLUNAS_TEMPO; ++c) {
+        int64_t anterior = 0;
+        for (AmostraSerie &a : pendentes) {
+            int64_t v = paraNs(tempo(a.medicao, c));
+            escreverVarint(codificado, zigzag(subtrair(v, anterior)));
+            anterior = v;
+        }
+    }
+    for (int c = 0; c < COLUNAS_TAXA; ++c) codificarXOR(codificado, pendentes, c);
+
+    CabecalhoBlocoSerie bloco{};
+    bloco.magica = MAGICA_BLOCO;
+    bloco.pid = pendentes[0].medicao.PID;
+    bloco.amostras = static_cast<uint32_t>(n);
+    bloco.bytes = static_cast<uint32_t>(codificado.size() - sizeof(bloco));
+    bloco.primeiroMs = pendentes.front().instanteMs;
+    bloco.ultimoMs = pendentes.back().instanteMs;
+    bloco.verificacao = verificacao(codificado.data() + sizeof(bloco), bloco.bytes);
+    std::memcpy(codificado.data(), &bloco, sizeof(bloco));
+
+    pendentes.clear();
+    if (!escreverEm(fd, codificado.data(), codificado.size(), tamanho)) {
+        std::cerr << "Erro ao escrever " << caminho << ": " << std::strerror(errno) << " (bloco de " << n << " amostras perdido)\n";
+        totalAmostras -= n;
+        return false;
+    }
+    indice.push_back({ bloco.primeiroMs, bloco.ultimoMs, tamanho, bloco.amostras, static_cast<uint32_t>(codificado.size()) });
+    tamanho += codificado.size();
+    return true;
+}
+
+bool EscritorSerie::fechar() {
+    if (fd < 0) return true;
+    bool ok = gravarBloco();
+
+    // Índice + rodapé logo depois do último bloco; reabrir o arquivo para continuar remove os dois
+    RodapeSerie rodape{ tamanho, static_cast<uint32_t>(indice.size()), MAGICA_INDICE };
+    size_t bytesIndice = indice.size() * sizeof(EntradaIndiceSerie);
+    ok = escreverEm(fd, indice.data(), bytesIndice, tamanho) &&
+         escreverEm(fd, &rodape, sizeof(rodape), tamanho + bytesIndice) && ok;
+    if (!ok) std::cerr << "Erro ao gravar o índice de " << caminho << ": " << std::strerror(errno) << "\n";
+    close(fd);
+    fd = -1;
+    return ok;
+}
+
+void EscritorSerie::imprimirResumo() {
+    gravarBloco(); // o bloco parcial vai para o disco: o arquivo pode ser lido (índice reconstruído) enquanto isso
+    double porAmostra = totalAmostras ? static_cast<double>(tamanho) / static_cast<double>(totalAmostras) : 0.0;
+    printf(
+        "| Série binária (.rmts)    |            |\n"
+        "-----------------------------------------\n"
+        "| Amostras gravadas        | %-10lu |\n"
+        "| Blocos                   | %-10lu |\n"
+        "| Bytes por amostra        | %-10.1f |\n"
+        "=========================================\n"
+        "Arquivo: %s (%lu bytes)\n\n",
+        static_cast<unsigned long>(totalAmostras), static_cast<unsigned long>(indice.size()), porAmostra,
+        caminho.c_str(), static_cast<unsigned long>(tamanho));
+}
+
+// ---- LeitorSerie ----
+
+LeitorSerie::~LeitorSerie() {
+    fechar();
+}
+
+void LeitorSerie::fechar() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    indice.clear();
+    fim = 0;
+    reconstruido = false;
+}
+
+bool LeitorSerie::abrir(const std::string &caminho) {
+    fechar();
+    fd = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Erro ao abrir " << caminho << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || !lerEm(fd, &cabecalho, sizeof(cabecalho), 0) ||
+        cabecalho.magica != MAGICA_SERIE) {
+        std::cerr << "Erro: " << caminho << " não é uma série binária (.rmts).\n";
+        fechar();
+        return false;
+    }
+    if (cabecalho.versao != VERSAO_SERIE || cabecalho.colunas != TOTAL_COLUNAS) {
+        std::cerr << "Erro: " << caminho << " usa a versão " << cabecalho.versao << " do formato (suportada: "
+                  << VERSAO_SERIE << ").\n";
+        fechar();
+        return false;
+    }
+
+    uint64_t tamanhoArquivo = static_cast<uint64_t>(info.st_size);
+    if (!lerIndice(tamanhoArquivo)) reconstruirIndice(tamanhoArquivo);
+    return true;
+}
+
+bool LeitorSerie::lerIndice(uint64_t tamanhoArquivo) {
+    if (tamanhoArquivo < sizeof(CabecalhoSerie) + sizeof(RodapeSerie)) return false;
+    RodapeSerie rodape{};
+    if (!lerEm(fd, &rodape, sizeof(rodape), tamanhoArquivo - sizeof(rodape)) || rodape.magica != MAGICA_INDICE)
+        return false;
+    uint64_t bytesIndice = static_cast<uint64_t>(rodape.blocos) * sizeof(EntradaIndiceSerie);
+    if (rodape.offsetIndice < sizeof(CabecalhoSerie) ||
+        rodape.offsetIndice + bytesIndice + sizeof(rodape) != tamanhoArquivo)
+        return false;
+
+    indice.resize(rodape.blocos);
+    if (!lerEm(fd, indice.data(), bytesIndice, rodape.offsetIndice)) {
+        indice.clear();
+        return false;
+    }
+    for (const EntradaIndiceSerie &e : indice) {
+        if (e.offset < sizeof(CabecalhoSerie) || e.offset + e.bytes > rodape.offsetIndice) {
+            indice.clear();
+            return false;
+        }
+    }
+    fim = rodape.offsetIndice;
+    return true;
+}
+
+void LeitorSerie::reconstruirIndice(uint64_t tamanhoArquivo) {
+    // Sem rodapé (escritor ainda aberto ou interrompido): percorre os blocos até o primeiro incompleto
+    reconstruido = true;
+    indice.clear();
+    uint64_t pos = sizeof(CabecalhoSerie);
+    CabecalhoBlocoSerie bloco{};
+    while (pos + sizeof(bloco) <= tamanhoArquivo && lerEm(fd, &bloco, sizeof(bloco), pos)) {
+        if (bloco.magica != MAGICA_BLOCO || bloco.amostras == 0 || pos + sizeof(bloco) + bloco.bytes > tamanhoArquivo)
+            break;
+        dados.resize(bloco.bytes);
+        if (!lerEm(fd, dados.data(), bloco.bytes, pos + sizeof(bloco)) ||
+            verificacao(dados.data(), bloco.bytes) != bloco.verificacao)
+            break;
+        uint32_t bytes = static_cast<uint32_t>(sizeof(bloco) + bloco.bytes);
+        indice.push_back({ bloco.primeiroMs, bloco.ultimoMs, pos, bloco.amostras, bytes });
+        pos += bytes;
+    }
+    fim = pos;
+}
+
+uint64_t LeitorSerie::totalAmostras() const {
+    uint64_t total = 0;
+    for (const EntradaIndiceSerie &e : indice) total += e.amostras;
+    return total;
+}
+
+size_t LeitorSerie::buscar(int64_t instanteMs) const {
+    // Os blocos são gravados em ordem de tempo: busca binária pelo último instante
+    auto it = std::lower_bound(indice.begin(), indice.end(), instanteMs,
+        [](const EntradaIndiceSerie &e, int64_t instante) { return e.ultimoMs < instante; });
+    return static_cast<size_t>(it - indice.begin());
+}
+
+bool LeitorSerie::lerBloco(size_t i, std::vector<AmostraSerie> &amostras) {
+    if (fd < 0 || i >= indice.size()) return false;
+    const EntradaIndiceSerie &e = indice[i];
+    dados.resize(e.bytes);
+    CabecalhoBlocoSerie bloco{};
+    if (e.bytes < sizeof(bloco) || !lerEm(fd, dados.data(), e.bytes, e.offset)) return false;
+    std::memcpy(&bloco, dados.data(), sizeof(bloco));
+    const uint8_t *p = dados.data() + sizeof(bloco);
+    const uint8_t *fimBloco = dados.data() + dados.size();
+    if (bloco.magica != MAGICA_BLOCO || bloco.amostras != e.amostras || bloco.amostras == 0 ||
+        sizeof(bloco) + bloco.bytes != e.bytes || verificacao(p, bloco.bytes) != bloco.verificacao)
+        return false;
+
+    const size_t n = bloco.amostras;
+    amostras.assign(n, AmostraSerie{});
+    for (AmostraSerie &a : amostras) a.medicao.PID = bloco.pid;
+
+    uint64_t v;
+    amostras[0].instanteMs = bloco.primeiroMs;
+    int64_t deltaAnterior = 0;
+    for (size_t k = 1; k < n; ++k) {
+        if (!lerVarint(p, fimBloco, v)) return false;
+        int64_t delta = k == 1 ? desfazerZigzag(v) : somar(deltaAnterior, desfazerZigzag(v));
+        amostras[k].instanteMs = somar(amostras[k - 1].instanteMs, delta);
+        deltaAnterior = delta;
+    }
+    if (amostras[n - 1].instanteMs != bloco.ultimoMs) return false;
+
+    for (int c = 0; c < COLUNAS_INTEIRAS; ++c) {
+        uint64_t anterior = 0;
+        for (AmostraSerie &a : amostras) {
+            if (!lerVarint(p, fimBloco, v)) return false;
+            anterior += static_cast<uint64_t>(desfazerZigzag(v));
+            definirInteiro(a.medicao, c, anterior);
+        }
+    }
+    for (int c = 0; c < COLUNAS_TEMPO; ++c) {
+        int64_t anterior = 0;
+        for (AmostraSerie &a : amostras) {
+            if (!lerVarint(p, fimBloco, v)) return false;
+            anterior = somar(anterior, desfazerZigzag(v));
+            tempo(a.medicao, c) = static_cast<double>(anterior) / 1e9;
+        }
+    }
+    for (int c = 0; c < COLUNAS_TAXA; ++c)
+        if (!decodificarXOR(p, fimBloco, amostras, c)) return false;
+    return p == fimBloco;
+}
+
+// ---- Conversão para CSV ----
+
+bool converterSerieParaCSV(const std::string &entrada, const std::string &saida) {
+    LeitorSerie leitor;
+    if (!leitor.abrir(entrada)) return false;
+
+    // Mesmo formato do perfilador, mas sem descarte: a conversão pode esperar o disco
+    ConfigEscritorCSV config = configuracaoCSV();
+    config.bloquearQuandoCheia = true;
+    config.rotacaoBytes = 0;
+    config.fsync = PoliticaFsync::Nunca;
+    unlink(saida.c_str()); // o EscritorCSV acrescenta: uma conversão repetida não duplica linhas
+    EscritorCSV csv(saida, config);
+    if (!csv.valido()) return false;
+
+    std::vector<AmostraSerie> amostras;
+    size_t corrompidos = 0;
+    for (size_t i = 0; i < leitor.blocos().size(); ++i) {
+        if (!leitor.lerBloco(i, amostras)) {
+            std::cerr << "Aviso: bloco " << i << " de " << entrada << " corrompido, ignorado\n";
+            ++corrompidos;
+            continue;
+        }
+        for (const AmostraSerie &a : amostras)
+            csv.registrar(a.medicao, a.calculado, static_cast<std::time_t>(a.instanteMs / 1000));
+    }
+    csv.descarregar();
+
+    struct stat infoEntrada{}, infoSaida{};
+    stat(entrada.c_str(), &infoEntrada);
+    stat(saida.c_str(), &infoSaida);
+    double razao = infoEntrada.st_size ? static_cast<double>(infoSaida.st_size) / static_cast<double>(infoEntrada.st_size) : 0.0;
+    printf(
+        "| Conversão .rmts -> CSV   |            |\n"
+        "-----------------------------------------\n"
+        "| Blocos                   | %-10lu |\n"
+        "| Blocos corrompidos       | %-10lu |\n"
+        "| Amostras                 | %-10lu |\n"
+        "| Bytes .rmts              | %-10ld |\n"
+        "| Bytes CSV                | %-10ld |\n"
+        "| CSV / .rmts              | %-9.1fx |\n"
+        "=========================================\n"
+        "%s%s\n\n",
+        static_cast<unsigned long>(leitor.blocos().size()), static_cast<unsigned long>(corrompidos),
+        static_cast<unsigned long>(csv.linhasEscritas()), static_cast<long>(infoEntrada.st_size),
+        static_cast<long>(infoSaida.st_size), razao, saida.c_str(),
+        leitor.indiceReconstruido() ? " (índice reconstruído: o arquivo não foi fechado)" : "");
+    return true;
+}
@@ -0,0 +1,97 @@
+#include "sessao.h"
+#include <string>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Nome de cada arquivo dentro de /proc/<pid>, na mesma ordem do enum ArquivoProc
+static const char* const NOMES_ARQUIVOS[] = { "stat", "status", "io", "smaps_rollup", "schedstat" };
+
+// Construtor: reserva os buffers uma única vez (status é o maior arquivo, ~1.5 KiB)
+SessaoColeta::SessaoColeta() {
+    for (auto& buffer : buffers)
+        buffer.resize(4096);
+}
+
+// Destrutor: fecha todos os descritores que ainda estão abertos
+SessaoColeta::~SessaoColeta() {
+    liberarTodos();
+}
+
+// Sessão compartilhada pelas chamadas que não informam uma sessão explicitamente
+SessaoColeta& SessaoColeta::padrao() {
+    static SessaoColeta sessao;
+    return sessao;
+}
+
+int SessaoColeta::abrir(int pid, ArquivoProc arquivo) {
+    // Monta o caminho apenas na abertura; as leituras seguintes usam só o fd
+    std::string path = "/proc/" + std::to_string(pid) + "/" + NOMES_ARQUIVOS[static_cast<int>(arquivo)];
+    return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+bool SessaoColeta::lerDescritor(int fd, std::vector<char>& buffer, size_t& tamanho) {
+    while (true) {
+        // Relê o arquivo inteiro a partir do início; procfs regenera o conteúdo a cada leitura no offset 0
+        ssize_t lidos = pread(fd, buffer.data(), buffer.size(), 0);
+        if (lidos < 0) {
+            if (errno == EINTR) continue; // interrompido por sinal, tenta de novo
+            return false;                 // ESRCH: o processo encerrou
+        }
+
+        // Se o buffer encheu, o arquivo pode ser maior: dobra o buffer e relê
+        if (static_cast<size_t>(lidos) == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+            continue;
+        }
+
+        tamanho = static_cast<size_t>(lidos);
+        return true;
+    }
+}
+
+bool SessaoColeta::ler(int pid, ArquivoProc arquivo, std::string_view& conteudo) {
+    const int indice = static_cast<int>(arquivo);
+    std::vector<char>& buffer = buffers[indice];
+    size_t tamanho = 0;
+
+    Descritores& descritores = abertos[pid]; // cria a entrada na primeira coleta do PID
+    int& fd = descritores.fd[indice];
+
+    // Caminho rápido: arquivo já aberto, basta reler
+    if (fd >= 0 && lerDescritor(fd, buffer, tamanho)) {
+        conteudo = std::string_view(buffer.data(), tamanho);
+        return true;
+    }
+
+    // Leitura falhou (processo sumiu) ou arquivo ainda não aberto: fecha e tenta reabrir uma vez
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    fd = abrir(pid, arquivo);
+    if (fd < 0 || !lerDescritor(fd, buffer, tamanho)) {
+        liberar(pid); // processo inexistente ou sem permissão: descarta todos os fds do PID
+        return false;
+    }
+
+    conteudo = std::string_view(buffer.data(), tamanho);
+    return true;
+}
+
+void SessaoColeta::liberar(int pid) {
+    auto it = abertos.find(pid);
+    if (it == abertos.end()) return; // PID sem descritores abertos
+
+    for (int fd : it->second.fd)
+        if (fd >= 0) close(fd);
+    abertos.erase(it);
+}
+
+void SessaoColeta::liberarTodos() {
+    for (auto& [pid, descritores] : abertos)
+        for (int fd : descritores.fd)
+            if (fd >= 0) close(fd);
+    abertos.clear();
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "instantaneo.h"
+
+// Biblioteca de leitura da tabela compartilhada. Não depende de nenhum outro arquivo do monitor:
+// as ferramentas de tools/ ligam só este objeto.
+
+static constexpr int TENTATIVAS_LEITURA = 1000;
+static constexpr int TENTATIVAS_SEM_CEDER = 64; // o escritor fica ímpar só durante um memcpy de 256 bytes
+
+LeitorInstantaneo::~LeitorInstantaneo() {
+    fechar();
+}
+
+void LeitorInstantaneo::fechar() {
+    if (mapa) munmap(const_cast<void*>(mapa), tamanhoMapa);
+    if (fd >= 0) close(fd);
+    mapa = nullptr;
+    fd = -1;
+    cabecalho = nullptr;
+    slots = nullptr;
+}
+
+bool LeitorInstantaneo::abrir(const std::string &nome) {
+    fechar();
+    fd = shm_open(nome.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Erro ao abrir o segmento " << nome << ": " << std::strerror(errno)
+                  << (errno == ENOENT ? " (nenhum monitor publicando)" : "") << "\n";
+        return false;
+    }
+    struct stat info{};
+    CabecalhoInstantaneo c{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(c) ||
+        pread(fd, &c, sizeof(c), 0) != static_cast<ssize_t>(sizeof(c)) ||
+        c.magica != MAGICA_INSTANTANEO || c.versao != VERSAO_INSTANTANEO || c.tamanhoSlot != sizeof(SlotInstantaneo) ||
+        static_cast<size_t>(info.st_size) != sizeof(CabecalhoInstantaneo) + sizeof(SlotInstantaneo) * c.maxProcessos) {
+        std::cerr << "Erro: " << nome << " não é uma tabela compartilhada válida (ou ainda está sendo criada).\n";
+        fechar();
+        return false;
+    }
+
+    size_t tamanho = static_cast<size_t>(info.st_size);
+    void *p = mmap(nullptr, tamanho, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Erro: mmap de " << nome << " falhou: " << std::strerror(errno) << "\n";
+        fechar();
+        return false;
+    }
+    mapa = p;
+    tamanhoMapa = tamanho;
+    cabecalho = static_cast<const CabecalhoInstantaneo*>(p);
+    slots = reinterpret_cast<const SlotInstantaneo*>(static_cast<const char*>(p) + sizeof(CabecalhoInstantaneo));
+    return true;
+}
+
+bool LeitorInstantaneo::escritorAtivo() const {
+    if (fd < 0) return false;
+    if (flock(fd, LOCK_SH | LOCK_NB) != 0) return errno == EWOULDBLOCK; // o escritor segura LOCK_EX
+    flock(fd, LOCK_UN);
+    return false;
+}
+
+bool LeitorInstantaneo::ler(uint32_t slot, AmostraInstantaneo &saida) const {
+    if (!mapa || slot >= cabecalho->maxProcessos) return false;
+    const SlotInstantaneo &s = slots[slot];
+
+    for (int tentativa = 0; tentativa < TENTATIVAS_LEITURA; ++tentativa) {
+        uint32_t antes = s.sequencia.load(std::memory_order_acquire);
+        if (antes & 1) {
+            // Ímpar: publicação em andamento. Se não terminar logo, o escritor pode ter morrido no meio dela
+            if (tentativa >= TENTATIVAS_SEM_CEDER) {
+                if (!escritorAtivo()) return false;
+                sched_yield();
+            }
+            continue;
+        }
+
+        AmostraInstantaneo copia;
+        copia.slot = slot;
+        copia.pid = s.pid;
+        copia.starttime = s.starttime;
+        copia.amostras = s.amostras;
+        copia.atualizadoMs = s.atualizadoMs;
+        std::memcpy(&copia.registro, &s.registro, sizeof(RegistroAnel));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.sequencia.load(std::memory_order_relaxed) != antes) continue; // o escritor mexeu: de novo
+
+        if (copia.pid == 0 || copia.amostras == 0) return false; // livre, ou reservado e ainda sem amostra
+        saida = copia;
+        return true;
+    }
+    return false;
+}
+
+bool LeitorInstantaneo::lerPID(int pid, AmostraInstantaneo &saida) const {
+    if (!mapa) return false;
+    bool achou = false;
+    AmostraInstantaneo copia;
+    for (uint32_t i = 0; i < cabecalho->maxProcessos; ++i) {
+        if (slots[i].pid != pid) continue; // filtro rápido sem seqlock; ler() confere
+        if (ler(i, copia) && copia.pid == pid && (!achou || copia.atualizadoMs > saida.atualizadoMs)) {
+            saida = copia;
+            achou = true;
+        }
+    }
+    return achou;
+}
+
+size_t LeitorInstantaneo::lerTodos(std::vector<AmostraInstantaneo> &saida) const {
+    saida.clear();
+    if (!mapa) return 0;
+    AmostraInstantaneo copia;
+    for (uint32_t i = 0; i < cabecalho->maxProcessos; ++i) {
+        if (slots[i].pid == 0) continue;
+        if (ler(i, copia)) saida.push_back(copia);
+    }
+    return saida.size();
+}
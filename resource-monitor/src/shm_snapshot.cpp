@@ -0,0 +1,185 @@
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "instantaneo.h"
+#include "serie.h"
+
+static_assert(sizeof(CabecalhoInstantaneo) == 64, "cabeçalho ocupa uma linha de cache");
+static_assert(sizeof(SlotInstantaneo) == 256, "layout do slot do segmento compartilhado mudou");
+// O segmento é compartilhado entre processos: a sequência precisa ser livre de trava (uma instrução na memória mapeada)
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock do segmento precisa ser lock-free");
+
+InstantaneoCompartilhado& InstantaneoCompartilhado::padrao() {
+    static InstantaneoCompartilhado tabela(NOME_INSTANTANEO, 1024); // 256 KiB em /dev/shm
+    return tabela;
+}
+
+// O nome do segmento ainda leva ao objeto aberto em 'fd' (mesmo inode em /dev/shm)
+static bool nomeApontaPara(const std::string &nome, int fd) {
+    struct stat proprio, atual;
+    if (fstat(fd, &proprio) != 0) return false;
+    int outro = shm_open(nome.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (outro < 0) return false; // removido por outro monitor
+    bool mesmo = fstat(outro, &atual) == 0 && atual.st_dev == proprio.st_dev && atual.st_ino == proprio.st_ino;
+    close(outro);
+    return mesmo;
+}
+
+InstantaneoCompartilhado::InstantaneoCompartilhado(std::string nomeSegmento, uint32_t maxProcessos)
+    : nome(std::move(nomeSegmento)) {
+    if (maxProcessos == 0) maxProcessos = 1;
+
+    // Criação e flock não são atômicos: entre os dois, outro monitor que encontre o segmento sem trava o trata
+    // como órfão, remove e cria o seu. Por isso, depois do flock, confere que o nome ainda leva ao segmento
+    // criado; se não leva, recomeça (e encontra o segmento do outro monitor, já travado). Com a trava e o nome
+    // confirmados, ninguém mais consegue remover o segmento.
+    for (int tentativa = 0; fd < 0 && tentativa < 8; ++tentativa) {
+        int criado = shm_open(nome.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (criado < 0) {
+            if (errno != EEXIST) break;
+            // Segmento de uma execução que não encerrou direito: descartado se ninguém mais publica nele.
+            // Leitores que ainda o mapeiam ficam com a cópia congelada e veem escritorAtivo() falso
+            int antigo = shm_open(nome.c_str(), O_RDONLY | O_CLOEXEC, 0);
+            if (antigo < 0) continue; // removido enquanto isso: tenta criar de novo
+            if (flock(antigo, LOCK_EX | LOCK_NB) != 0) {
+                std::cerr << "Aviso: o segmento " << nome << " já está em uso por outro monitor, tabela compartilhada desativada\n";
+                close(antigo);
+                return;
+            }
+            // Com a trava, o nome só deixa de levar ao antigo se outro o remover antes: confere para não
+            // remover o segmento novo que um monitor acabou de criar no lugar
+            if (nomeApontaPara(nome, antigo)) shm_unlink(nome.c_str());
+            close(antigo);
+            continue;
+        }
+        // O flock marca o escritor vivo: é o que os leitores consultam em escritorAtivo()
+        if (flock(criado, LOCK_EX | LOCK_NB) != 0 || !nomeApontaPara(nome, criado)) {
+            close(criado); // outro monitor tomou o nome entre o shm_open e o flock
+            continue;
+        }
+        fd = criado;
+    }
+    if (fd < 0) {
+        std::cerr << "Aviso: não foi possível criar o segmento " << nome << " (" << std::strerror(errno) << "), tabela compartilhada desativada\n";
+        return;
+    }
+
+    size_t tamanho = sizeof(CabecalhoInstantaneo) + sizeof(SlotInstantaneo) * maxProcessos;
+    if (ftruncate(fd, static_cast<off_t>(tamanho)) != 0) {
+        std::cerr << "Aviso: não foi possível preparar o segmento " << nome << " (" << std::strerror(errno) << "), tabela compartilhada desativada\n";
+        close(fd);
+        fd = -1;
+        shm_unlink(nome.c_str());
+        return;
+    }
+
+    void *p = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Aviso: mmap de " << nome << " falhou (" << std::strerror(errno) << "), tabela compartilhada desativada\n";
+        close(fd);
+        fd = -1;
+        shm_unlink(nome.c_str());
+        return;
+    }
+    mapa = p;
+    tamanhoMapa = tamanho;
+    cabecalho = static_cast<CabecalhoInstantaneo*>(p);
+    slots = reinterpret_cast<SlotInstantaneo*>(static_cast<char*>(p) + sizeof(CabecalhoInstantaneo));
+    emUso.assign(maxProcessos, false);
+
+    // O ftruncate entregou tudo zerado: slots livres com sequência par
+    cabecalho->versao = VERSAO_INSTANTANEO;
+    cabecalho->tamanhoSlot = sizeof(SlotInstantaneo);
+    cabecalho->maxProcessos = maxProcessos;
+    cabecalho->pidEscritor = static_cast<int32_t>(getpid());
+    cabecalho->criadoMs = instanteRealMs();
+    std::atomic_thread_fence(std::memory_order_release);
+    cabecalho->magica = MAGICA_INSTANTANEO; // por último: um leitor não aceita um cabeçalho pela metade
+}
+
+InstantaneoCompartilhado::~InstantaneoCompartilhado() {
+    if (!mapa) return;
+    munmap(mapa, tamanhoMapa);
+    shm_unlink(nome.c_str()); // amostras de um monitor encerrado não são "atuais"
+    close(fd);                // libera o flock
+}
+
+int InstantaneoCompartilhado::reservar(int pid, uint64_t starttime) {
+    if (!mapa) return -1;
+    std::lock_guard<std::mutex> lock(trava);
+    for (uint32_t i = 0; i < cabecalho->maxProcessos; ++i) {
+        if (emUso[i]) continue;
+        emUso[i] = true;
+        SlotInstantaneo &s = slots[i];
+        uint32_t seq = s.sequencia.load(std::memory_order_relaxed);
+        s.sequencia.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.pid = pid;
+        s.starttime = starttime;
+        s.amostras = 0; // o registro anterior do slot não vale para este processo
+        s.atualizadoMs = instanteRealMs();
+        s.sequencia.store(seq + 2, std::memory_order_release);
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void InstantaneoCompartilhado::liberar(int slot) {
+    if (!mapa || slot < 0 || static_cast<uint32_t>(slot) >= cabecalho->maxProcessos) return;
+    std::lock_guard<std::mutex> lock(trava);
+    SlotInstantaneo &s = slots[slot];
+    uint32_t seq = s.sequencia.load(std::memory_order_relaxed);
+    s.sequencia.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.pid = 0;
+    s.amostras = 0;
+    s.sequencia.store(seq + 2, std::memory_order_release);
+    emUso[slot] = false;
+}
+
+void InstantaneoCompartilhado::publicar(int slot, const StatusProcesso &medicao, const calculoMedicao &calculado) {
+    if (!mapa || slot < 0 || static_cast<uint32_t>(slot) >= cabecalho->maxProcessos) return;
+    SlotInstantaneo &s = slots[slot];
+
+    // Monta o registro fora do segmento: a janela ímpar do seqlock fica só com o memcpy
+    RegistroAnel novo;
+    paraRegistroAnel(medicao, calculado, novo);
+    novo.numero = s.amostras;
+    novo.instanteMs = instanteRealMs();
+
+    uint32_t seq = s.sequencia.load(std::memory_order_relaxed);
+    s.sequencia.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&s.registro, &novo, sizeof(RegistroAnel));
+    s.amostras = novo.numero + 1;
+    s.atualizadoMs = novo.instanteMs;
+    s.sequencia.store(seq + 2, std::memory_order_release);
+}
+
+// ---- ReservaInstantaneo ----
+
+ReservaInstantaneo::ReservaInstantaneo(InstantaneoCompartilhado &t, const ProcessoMonitorado &processo)
+    : tabela(&t), slot(t.reservar(processo.pid(), processo.inicio())) {}
+
+ReservaInstantaneo::~ReservaInstantaneo() {
+    if (slot >= 0) tabela->liberar(slot);
+}
+
+ReservaInstantaneo::ReservaInstantaneo(ReservaInstantaneo &&outra) noexcept : tabela(outra.tabela), slot(outra.slot) {
+    outra.slot = -1;
+}
+
+ReservaInstantaneo& ReservaInstantaneo::operator=(ReservaInstantaneo &&outra) noexcept {
+    if (this != &outra) {
+        if (slot >= 0) tabela->liberar(slot);
+        tabela = outra.tabela;
+        slot = outra.slot;
+        outra.slot = -1;
+    }
+    return *this;
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <string_view>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "parse.h"
+#include "cpu_sistema.h"
+
+// Ordem das colunas em /proc/stat (guest/guest_nice já estão incluídos em user/nice)
+enum EstadoCPU { User, Nice, System, Idle, Iowait, Irq, Softirq, Steal };
+
+ColetorCPUSistema::ColetorCPUSistema() {
+    fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    buffer.resize(16 * 1024); // a linha "intr" cresce com o nº de interrupções; o buffer dobra se precisar
+}
+
+ColetorCPUSistema::~ColetorCPUSistema() {
+    if (fd >= 0) close(fd);
+}
+
+// Delta de um contador convertido para double; contadores que voltaram (CPU religada) viram 0.
+// O delta de um intervalo (em ticks) cabe em 32 bits, e int32 -> double tem instrução vetorial em SSE2/AVX
+static inline double delta(uint64_t atual, uint64_t anterior) {
+    int32_t d = static_cast<int32_t>(atual - anterior);
+    d &= ~(d >> 31); // zera deltas negativos sem desvio (mantém o laço vetorizável)
+    return static_cast<double>(d);
+}
+
+bool ColetorCPUSistema::coletar() {
+    if (fd < 0) return false;
+
+    // Relê o arquivo inteiro a partir do offset 0 (procfs regenera o conteúdo)
+    ssize_t lidos;
+    while (true) {
+        lidos = pread(fd, buffer.data(), buffer.size(), 0);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos < 0) return false;
+        if (static_cast<size_t>(lidos) < buffer.size()) break;
+        buffer.resize(buffer.size() * 2); // buffer cheio: o arquivo pode ser maior
+    }
+
+    std::swap(atual, anterior);
+    totalAnterior = totalAtual;
+    atual.presente.fill(0); // CPU que ficou offline some de /proc/stat e não pode manter os valores antigos
+    std::string_view conteudo(buffer.data(), static_cast<size_t>(lidos));
+
+    while (!conteudo.empty()) {
+        std::string_view linha = proximaLinha(conteudo);
+        if (linha.size() > 3 && linha.compare(0, 3, "cpu") == 0) {
+            std::string_view rotulo = proximoToken(linha); // "cpu" (agregado) ou "cpuN"
+            uint64_t valores[8] = {};
+            for (auto &valor : valores)
+                if (!lerNumero(linha, valor)) break; // kernels antigos não têm steal
+
+            if (rotulo.size() == 3) { // linha agregada de todas as CPUs
+                std::copy(std::begin(valores), std::end(valores), totalAtual.begin());
+                continue;
+            }
+            size_t indice = 0;
+            if (!converterNumero(rotulo.substr(3), indice) || indice >= MAX_CPUS) continue;
+            atual.user[indice] = valores[User];
+            atual.nice[indice] = valores[Nice];
+            atual.system[indice] = valores[System];
+            atual.idle[indice] = valores[Idle];
+            atual.iowait[indice] = valores[Iowait];
+            atual.irq[indice] = valores[Irq];
+            atual.softirq[indice] = valores[Softirq];
+            atual.steal[indice] = valores[Steal];
+            atual.presente[indice] = 1;
+            cpus = std::max(cpus, indice + 1);
+        }
+        else if (linha.compare(0, 14, "procs_running ") == 0) {
+            linha.remove_prefix(14);
+            lerNumero(linha, geral.procsExecutando);
+        }
+    }
+
+    ++coletas;
+    if (temIntervalo()) calcularPercentuais();
+    return true;
+}
+
+void ColetorCPUSistema::calcularPercentuais() {
+    const size_t n = cpus;
+
+    // Struct-of-arrays: cada iteração lê a mesma posição de vetores contíguos e não depende das outras, então
+    // o laço é vetorizável quando o build liga a otimização (-O3; o Makefile compila sem -O)
+    for (size_t i = 0; i < n; ++i) {
+        double dUser = delta(atual.user[i], anterior.user[i]) + delta(atual.nice[i], anterior.nice[i]);
+        double dSystem = delta(atual.system[i], anterior.system[i]);
+        double dIdle = delta(atual.idle[i], anterior.idle[i]);
+        double dIowait = delta(atual.iowait[i], anterior.iowait[i]);
+        double dIrq = delta(atual.irq[i], anterior.irq[i]) + delta(atual.softirq[i], anterior.softirq[i]);
+        double dSteal = delta(atual.steal[i], anterior.steal[i]);
+
+        double total = dUser + dSystem + dIdle + dIowait + dIrq + dSteal;
+        // Sem desvio: núcleo ausente de uma das duas leituras (offline ou recém-religado) fica com 0%
+        double online = static_cast<double>(atual.presente[i] & anterior.presente[i]);
+        double escala = online * 100.0 / (total + (total == 0));
+
+        pct.user[i] = dUser * escala;
+        pct.system[i] = dSystem * escala;
+        pct.iowait[i] = dIowait * escala;
+        pct.irq[i] = dIrq * escala;
+        pct.steal[i] = dSteal * escala;
+        pct.ocupado[i] = (total - dIdle - dIowait) * escala;
+    }
+
+    // Redução separada: nº de núcleos saturados e o mais ocupado
+    geral.nucleosSaturados = 0;
+    geral.nucleoMaisOcupado = 0;
+    for (size_t i = 0; i < n; ++i) {
+        geral.nucleosSaturados += pct.ocupado[i] >= LIMIAR_SATURACAO;
+        if (pct.ocupado[i] > pct.ocupado[geral.nucleoMaisOcupado]) geral.nucleoMaisOcupado = i;
+    }
+
+    // Visão da máquina inteira pela linha agregada
+    std::array<double, 8> d{};
+    for (size_t e = 0; e < d.size(); ++e) d[e] = delta(totalAtual[e], totalAnterior[e]);
+    double total = d[User] + d[Nice] + d[System] + d[Idle] + d[Iowait] + d[Irq] + d[Softirq] + d[Steal];
+    double escala = total > 0 ? 100.0 / total : 0.0;
+    geral.user = (d[User] + d[Nice]) * escala;
+    geral.system = d[System] * escala;
+    geral.iowait = d[Iowait] * escala;
+    geral.irq = (d[Irq] + d[Softirq]) * escala;
+    geral.steal = d[Steal] * escala;
+    geral.ocupado = (total - d[Idle] - d[Iowait]) * escala;
+}
+
+void ColetorCPUSistema::nucleosMaisOcupados(size_t k, std::vector<size_t> &indices) const {
+    indices.resize(cpus);
+    for (size_t i = 0; i < cpus; ++i) indices[i] = i;
+    k = std::min(k, indices.size());
+    auto maisOcupado = [this](size_t a, size_t b) { return pct.ocupado[a] > pct.ocupado[b]; };
+    std::partial_sort(indices.begin(), indices.begin() + k, indices.end(), maisOcupado);
+    indices.resize(k);
+}
@@ -0,0 +1,260 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/taskstats.h>
+#include "monitor.h"
+#include "taskstats.h"
+
+// ---- Montagem e leitura de mensagens generic netlink ----
+
+// Pedido genérico: cabeçalhos netlink/genl seguidos de um único atributo
+struct PedidoGenl {
+    nlmsghdr cabecalho;
+    genlmsghdr genl;
+    char atributos[64];
+};
+
+// Anexa um atributo (tipo, valor) ao pedido e atualiza nlmsg_len
+static void adicionarAtributo(PedidoGenl &pedido, uint16_t tipo, const void *dados, uint16_t tamanho) {
+    nlattr *atributo = reinterpret_cast<nlattr*>(reinterpret_cast<char*>(&pedido) + NLMSG_ALIGN(pedido.cabecalho.nlmsg_len));
+    atributo->nla_type = tipo;
+    atributo->nla_len = static_cast<uint16_t>(NLA_HDRLEN + tamanho);
+    std::memcpy(reinterpret_cast<char*>(atributo) + NLA_HDRLEN, dados, tamanho);
+    pedido.cabecalho.nlmsg_len = NLMSG_ALIGN(pedido.cabecalho.nlmsg_len) + NLA_ALIGN(atributo->nla_len);
+}
+
+// Procura o atributo 'tipo' em uma sequência de atributos; retorna nullptr se não existe
+static const nlattr* buscarAtributo(const char *inicio, int tamanho, uint16_t tipo) {
+    while (tamanho >= static_cast<int>(NLA_HDRLEN)) {
+        const nlattr *atributo = reinterpret_cast<const nlattr*>(inicio);
+        if (atributo->nla_len < NLA_HDRLEN || atributo->nla_len > tamanho) return nullptr; // mensagem truncada
+        if ((atributo->nla_type & NLA_TYPE_MASK) == tipo) return atributo;
+        int passo = NLA_ALIGN(atributo->nla_len);
+        inicio += passo;
+        tamanho -= passo;
+    }
+    return nullptr;
+}
+
+static const char* dadosAtributo(const nlattr *atributo) {
+    return reinterpret_cast<const char*>(atributo) + NLA_HDRLEN;
+}
+
+// ---- ColetorTaskstats ----
+
+ColetorTaskstats& ColetorTaskstats::padrao() {
+    static ColetorTaskstats coletor;
+    return coletor;
+}
+
+ColetorTaskstats::~ColetorTaskstats() {
+    if (fd >= 0) close(fd);
+}
+
+bool ColetorTaskstats::disponivel() {
+    if (!tentouAbrir) {
+        tentouAbrir = true;
+        if (!abrir() && fd >= 0) { close(fd); fd = -1; }
+    }
+    return fd >= 0;
+}
+
+// Abre o socket NETLINK_GENERIC e resolve o id da família "TASKSTATS" pelo controlador genl
+bool ColetorTaskstats::abrir() {
+    fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (fd < 0) return false;
+
+    sockaddr_nl local{};
+    local.nl_family = AF_NETLINK;
+    if (bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) return false;
+
+    buffer.resize(16 * 1024);
+
+    PedidoGenl pedido{};
+    pedido.cabecalho.nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    pedido.cabecalho.nlmsg_type = GENL_ID_CTRL;
+    pedido.cabecalho.nlmsg_flags = NLM_F_REQUEST;
+    pedido.cabecalho.nlmsg_seq = ++sequencia;
+    pedido.genl.cmd = CTRL_CMD_GETFAMILY;
+    pedido.genl.version = 1;
+    adicionarAtributo(pedido, CTRL_ATTR_FAMILY_NAME, TASKSTATS_GENL_NAME, sizeof(TASKSTATS_GENL_NAME));
+
+    if (send(fd, &pedido, pedido.cabecalho.nlmsg_len, 0) < 0) return false;
+    ssize_t recebidos = recv(fd, buffer.data(), buffer.size(), 0);
+    if (recebidos < 0) return false;
+
+    const nlmsghdr *resposta = reinterpret_cast<const nlmsghdr*>(buffer.data());
+    if (!NLMSG_OK(resposta, static_cast<int>(recebidos)) || resposta->nlmsg_type == NLMSG_ERROR)
+        return false; // kernel sem TASKSTATS
+
+    const char *atributos = static_cast<const char*>(NLMSG_DATA(resposta)) + GENL_HDRLEN;
+    int tamanho = static_cast<int>(resposta->nlmsg_len) - NLMSG_LENGTH(GENL_HDRLEN);
+    const nlattr *id = buscarAtributo(atributos, tamanho, CTRL_ATTR_FAMILY_ID);
+    if (!id) return false;
+    std::memcpy(&familia, dadosAtributo(id), sizeof(familia));
+    return true;
+}
+
+bool ColetorTaskstats::consultar(uint16_t comando, uint32_t id, taskstats &saida) {
+    if (!disponivel()) return false;
+
+    PedidoGenl pedido{};
+    pedido.cabecalho.nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+    pedido.cabecalho.nlmsg_type = familia;
+    pedido.cabecalho.nlmsg_flags = NLM_F_REQUEST;
+    pedido.cabecalho.nlmsg_seq = ++sequencia;
+    pedido.genl.cmd = TASKSTATS_CMD_GET;
+    pedido.genl.version = TASKSTATS_GENL_VERSION;
+    adicionarAtributo(pedido, comando, &id, sizeof(id));
+
+    if (send(fd, &pedido, pedido.cabecalho.nlmsg_len, 0) < 0) return false;
+
+    const nlmsghdr *resposta;
+    while (true) { // descarta respostas atrasadas de consultas anteriores (ex.: interrompidas)
+        ssize_t recebidos = recv(fd, buffer.data(), buffer.size(), 0);
+        if (recebidos < 0 && errno == EINTR) continue;
+        if (recebidos < 0) return false;
+        resposta = reinterpret_cast<const nlmsghdr*>(buffer.data());
+        if (!NLMSG_OK(resposta, static_cast<int>(recebidos))) return false;
+        if (resposta->nlmsg_seq == sequencia) break;
+    }
+
+    if (resposta->nlmsg_type == NLMSG_ERROR) return false; // ex.: ESRCH (processo encerrou) ou EPERM
+
+    // Resposta: TASKSTATS_TYPE_AGGR_PID/TGID { TASKSTATS_TYPE_PID/TGID, TASKSTATS_TYPE_STATS }
+    const char *atributos = static_cast<const char*>(NLMSG_DATA(resposta)) + GENL_HDRLEN;
+    int tamanho = static_cast<int>(resposta->nlmsg_len) - NLMSG_LENGTH(GENL_HDRLEN);
+    uint16_t agregado = comando == TASKSTATS_CMD_ATTR_PID ? TASKSTATS_TYPE_AGGR_PID : TASKSTATS_TYPE_AGGR_TGID;
+    const nlattr *aninhado = buscarAtributo(atributos, tamanho, agregado);
+    if (!aninhado) return false;
+    const nlattr *estatisticas = buscarAtributo(dadosAtributo(aninhado), aninhado->nla_len - NLA_HDRLEN, TASKSTATS_TYPE_STATS);
+    if (!estatisticas) return false;
+
+    // A struct cresce entre versões do kernel: copia só o que veio e zera o resto
+    size_t tamanhoStats = estatisticas->nla_len - NLA_HDRLEN;
+    std::memset(&saida, 0, sizeof(saida));
+    std::memcpy(&saida, dadosAtributo(estatisticas), std::min(tamanhoStats, sizeof(saida)));
+    return true;
+}
+
+// Copia os campos de delay accounting da struct do kernel
+static void preencherAtrasos(const taskstats &t, AtrasosProcesso &atrasos) {
+    atrasos.cpuTotalNs = t.cpu_run_real_total;
+    atrasos.cpuEsperaNs = t.cpu_delay_total;
+    atrasos.cpuEsperaQtd = t.cpu_count;
+    atrasos.blkioEsperaNs = t.blkio_delay_total;
+    atrasos.blkioEsperaQtd = t.blkio_count;
+    atrasos.swapinEsperaNs = t.swapin_delay_total;
+    atrasos.swapinEsperaQtd = t.swapin_count;
+    atrasos.freepagesEsperaNs = t.freepages_delay_total;
+    atrasos.freepagesEsperaQtd = t.freepages_count;
+}
+
+// Tempo em CPU (ac_utime/ac_stime, em µs) e espera na fila de execução (cpu_delay_total, em ns)
+static void preencherCPU(const taskstats &t, StatusProcesso &medicao) {
+    medicao.utime = static_cast<double>(t.ac_utime) / 1e6; // µs -> s
+    medicao.stime = static_cast<double>(t.ac_stime) / 1e6;
+    medicao.tempoCPU = medicao.utime + medicao.stime;
+    medicao.esperaCPU = static_cast<double>(t.cpu_delay_total) / 1e9;
+}
+
+bool ColetorTaskstats::coletarTarefa(int tid, StatusProcesso &medicao, AtrasosProcesso &atrasos) {
+    taskstats t;
+    if (!consultar(TASKSTATS_CMD_ATTR_PID, static_cast<uint32_t>(tid), t)) return false;
+
+    preencherCPU(t, medicao);
+    medicao.minfault = t.ac_minflt;
+    medicao.mjrfault = t.ac_majflt;
+    medicao.contextSwitchfree = static_cast<unsigned int>(t.nvcsw);
+    medicao.contextSwitchforced = static_cast<unsigned int>(t.nivcsw);
+    medicao.rchar = t.read_char;
+    medicao.wchar = t.write_char;
+    medicao.syscallLeitura = t.read_syscalls;
+    medicao.syscallEscrita = t.write_syscalls;
+    medicao.bytesLidos = t.read_bytes;
+    medicao.bytesEscritos = t.write_bytes;
+    preencherAtrasos(t, atrasos);
+    return true;
+}
+
+bool ColetorTaskstats::coletarGrupo(int tgid, StatusProcesso &medicao, AtrasosProcesso &atrasos) {
+    taskstats t;
+    if (!consultar(TASKSTATS_CMD_ATTR_TGID, static_cast<uint32_t>(tgid), t)) return false;
+
+    // Os context switches somados por todas as threads não substituem os do status, que o resto do
+    // monitor (CSV, séries, exportadores) sempre leu da thread principal
+    preencherCPU(t, medicao);
+    preencherAtrasos(t, atrasos);
+    return true;
+}
+
+bool coletorTaskstats(StatusProcesso &medicao, AtrasosProcesso &atrasos, ColetorTaskstats &coletor) {
+    return coletor.coletarGrupo(medicao.PID, medicao, atrasos);
+}
+
+// ---- Experimento nº8: TASKSTATS x /proc ----
+
+void benchmarkTaskstats() {
+    const int repeticoes = 20000;
+
+    std::cout << "\n\033[1;33m========= Experimento nº8 - TASKSTATS (netlink) x /proc =========\033[0m\n";
+
+    ColetorTaskstats coletor;
+    if (!coletor.disponivel()) {
+        std::cout << " Interface TASKSTATS indisponível (kernel sem CONFIG_TASKSTATS ou sem CAP_NET_ADMIN).\n";
+        std::cout << " Os coletores de texto de /proc seguem sendo usados.\n";
+        return;
+    }
+
+    StatusProcesso medicao{};
+    medicao.PID = getpid();
+    ProcessoMonitorado proprio(medicao.PID);
+    AtrasosProcesso atrasos{};
+    SessaoColeta sessao;
+
+    // Mede o tempo médio (µs) de uma coleta
+    auto medir = [&](auto coleta) {
+        coleta(); // primeira chamada abre arquivos/socket
+        auto inicio = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeticoes; ++i) coleta();
+        auto fim = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(fim - inicio).count() / repeticoes;
+    };
+
+    double usProc = medir([&] { coletorSnapshot(proprio, medicao, sessao); });
+    double usTarefa = medir([&] { coletor.coletarTarefa(medicao.PID, medicao, atrasos); });
+    double usGrupo = medir([&] { coletor.coletarGrupo(medicao.PID, medicao, atrasos); });
+
+    std::cout << " Média de " << repeticoes << " coletas do próprio monitor\n\n";
+    std::cout << " " << std::left << std::setw(36) << "Coleta" << std::right << std::setw(14) << "µs/amostra\n";
+    std::cout << " " << std::string(49, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << " " << std::left << std::setw(36) << "/proc stat+status+io (snapshot)" << std::right << std::setw(12) << usProc << "\n";
+    std::cout << " " << std::left << std::setw(36) << "TASKSTATS por tarefa (PID)" << std::right << std::setw(12) << usTarefa << "\n";
+    std::cout << " " << std::left << std::setw(36) << "TASKSTATS por processo (TGID)" << std::right << std::setw(12) << usGrupo << "\n";
+
+    coletor.coletarGrupo(medicao.PID, medicao, atrasos);
+    std::cout << "\n Atrasos acumulados do monitor (ms):\n";
+    std::cout << "   CPU total: " << atrasos.cpuTotalNs / 1e6
+        << " | espera por CPU: " << atrasos.cpuEsperaNs / 1e6 << " (" << atrasos.cpuEsperaQtd << "x)"
+        << " | blkio: " << atrasos.blkioEsperaNs / 1e6
+        << " | swapin: " << atrasos.swapinEsperaNs / 1e6
+        << " | reclaim: " << atrasos.freepagesEsperaNs / 1e6 << "\n";
+
+    // blkio/swapin/freepages ficam zerados se o delay accounting estiver desligado
+    int fdSysctl = open("/proc/sys/kernel/task_delayacct", O_RDONLY | O_CLOEXEC);
+    if (fdSysctl >= 0) {
+        char valor = '1';
+        if (read(fdSysctl, &valor, 1) == 1 && valor == '0')
+            std::cout << " Delay accounting desligado: ative com 'sysctl kernel.task_delayacct=1' para os atrasos de I/O e memória.\n";
+        close(fdSysctl);
+    }
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <string_view>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include "procfs.h"
+#include "parse.h"
+#include "threads.h"
+
+// Registro devolvido pelo getdents64
+struct DirentTask64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Lê task/<tid>/<arquivo>. Com 'persistente', o fd aberto na primeira leitura é guardado e relido com pread;
+// sem ele (limite de descritores atingido), o arquivo é aberto, lido e fechado a cada tick.
+static ssize_t lerArquivoThread(int dirTask, int tid, const char *arquivo, int &fd, bool persistente, char *buf, size_t cap) {
+    if (fd < 0) {
+        char relativo[48];
+        snprintf(relativo, sizeof(relativo), "%d/%s", tid, arquivo);
+        fd = openat(dirTask, relativo, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return -1; // thread terminou (ou schedstat inexistente sem CONFIG_SCHED_INFO)
+    }
+    ssize_t lidos = pread(fd, buf, cap - 1, 0);
+    if (!persistente || lidos < 0) { close(fd); fd = -1; }
+    return lidos;
+}
+
+ColetorThreads::~ColetorThreads() {
+    liberar();
+}
+
+void ColetorThreads::fecharThread(EstadoThread &estado) {
+    if (estado.fdStat >= 0) close(estado.fdStat);
+    if (estado.fdSchedstat >= 0) close(estado.fdSchedstat);
+    estado.fdStat = estado.fdSchedstat = -1;
+}
+
+void ColetorThreads::liberar() {
+    for (auto &[tid, estado] : estados) fecharThread(estado);
+    estados.clear();
+    persistentes = 0;
+    metricas.clear();
+    if (dirTask >= 0) close(dirTask);
+    dirTask = -1;
+    pidAtual = -1;
+}
+
+bool ColetorThreads::coletar(int pid) {
+    if (pid != pidAtual) { // novo processo: descarta o estado anterior e abre o diretório de threads
+        liberar();
+        char caminho[64];
+        snprintf(caminho, sizeof(caminho), "/proc/%d/task", pid);
+        dirTask = open(caminho, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirTask < 0) return false;
+        pidAtual = pid;
+    }
+
+    auto agora = std::chrono::steady_clock::now();
+    double segundos = std::chrono::duration<double>(agora - ultimaColeta).count(); // intervalo real entre ticks
+    ultimaColeta = agora;
+    static const double ticksPorSegundo = static_cast<double>(sysconf(_SC_CLK_TCK));
+
+    ++varredura;
+    metricas.clear();
+    if (bufferDirent.empty()) bufferDirent.resize(32 * 1024);
+    if (lseek(dirTask, 0, SEEK_SET) < 0) { liberar(); return false; }
+
+    char buf[1024]; // stat de uma thread cabe com folga
+    while (true) {
+        long lidos = syscall(SYS_getdents64, dirTask, bufferDirent.data(), bufferDirent.size());
+        if (lidos < 0) { liberar(); return false; } // processo encerrou
+        if (lidos == 0) break;
+
+        for (long pos = 0; pos < lidos;) {
+            const DirentTask64 *d = reinterpret_cast<const DirentTask64*>(bufferDirent.data() + pos);
+            pos += d->d_reclen;
+
+            int tid = 0;
+            if (!converterNumero(std::string_view(d->d_name), tid)) continue; // "." e ".."
+
+            auto [it, nova] = estados.try_emplace(tid);
+            EstadoThread &estado = it->second;
+            estado.visto = varredura;
+            if (nova) { // mantém os arquivos abertos enquanto houver descritores disponíveis
+                estado.persistente = persistentes < MAX_THREADS_PERSISTENTES;
+                if (estado.persistente) ++persistentes;
+            }
+
+            ssize_t n = lerArquivoThread(dirTask, tid, "stat", estado.fdStat, estado.persistente, buf, sizeof(buf));
+            if (n <= 0) { // thread terminou; se o TID voltar na próxima varredura, é outra thread
+                fecharThread(estado);
+                estado.temAnterior = false;
+                continue;
+            }
+            std::string_view conteudo(buf, static_cast<size_t>(n));
+            CamposStat campos{};
+            if (!parseStat(conteudo, campos)) continue;
+
+            // TID reutilizado entre dois ticks: os contadores guardados são da thread anterior, e o schedstat
+            // aberto pode ser o dela. Recomeça sem delta em vez de subtrair contadores de threads diferentes
+            if (estado.temAnterior && campos.starttime != estado.starttime) {
+                if (estado.fdSchedstat >= 0) close(estado.fdSchedstat);
+                estado.fdSchedstat = -1;
+                estado.temAnterior = false;
+            }
+            estado.starttime = campos.starttime;
+
+            MetricasThread m{};
+            m.tid = tid;
+            // O nome fica entre o primeiro '(' e o último ')'
+            size_t abre = conteudo.find('('), fecha = conteudo.rfind(')');
+            if (abre != std::string_view::npos && fecha > abre) {
+                size_t tamanho = std::min(fecha - abre - 1, sizeof(m.nome) - 1);
+                std::memcpy(m.nome, conteudo.data() + abre + 1, tamanho);
+                m.nome[tamanho] = '\0';
+            }
+
+            uint64_t ticks = campos.utime + campos.stime;
+            CamposSchedstat sched{};
+            n = lerArquivoThread(dirTask, tid, "schedstat", estado.fdSchedstat, estado.persistente, buf, sizeof(buf));
+            bool temSched = n > 0 && parseSchedstat(std::string_view(buf, static_cast<size_t>(n)), sched);
+
+            // Contadores que voltaram (ex.: schedstat lido de outra thread) também não geram delta
+            bool recuou = ticks < estado.ticks ||
+                (temSched && (sched.cpuNs < estado.cpuNs || sched.esperaNs < estado.esperaNs || sched.fatias < estado.fatias));
+            if (estado.temAnterior && !recuou && segundos > 0) {
+                if (temSched) { // ns do escalonador: mais preciso que os ticks
+                    m.usoCPU = static_cast<double>(sched.cpuNs - estado.cpuNs) / (segundos * 1e9) * 100.0;
+                    m.esperaMsPorS = static_cast<double>(sched.esperaNs - estado.esperaNs) / 1e6 / segundos;
+                    m.trocasPorS = static_cast<double>(sched.fatias - estado.fatias) / segundos;
+                }
+                else {
+                    m.usoCPU = static_cast<double>(ticks - estado.ticks) / ticksPorSegundo / segundos * 100.0;
+                }
+            }
+
+            estado.ticks = ticks;
+            if (temSched) {
+                estado.cpuNs = sched.cpuNs;
+                estado.esperaNs = sched.esperaNs;
+                estado.fatias = sched.fatias;
+            }
+            estado.temAnterior = true;
+            metricas.push_back(m);
+        }
+    }
+
+    // Threads que não apareceram nesta varredura terminaram
+    for (auto it = estados.begin(); it != estados.end();) {
+        if (it->second.visto != varredura) {
+            if (it->second.persistente) --persistentes;
+            fecharThread(it->second);
+            it = estados.erase(it);
+        }
+        else ++it;
+    }
+    return true;
+}
+
+const std::vector<MetricasThread>& ColetorThreads::threadsQuentes(size_t k) {
+    quentes = metricas;
+    k = std::min(k, quentes.size());
+    auto maisQuente = [](const MetricasThread &a, const MetricasThread &b) { return a.usoCPU > b.usoCPU; };
+
+    // Seleção parcial: O(n) para separar as K maiores, ordenando só essas K
+    std::nth_element(quentes.begin(), quentes.begin() + k, quentes.end(), maisQuente);
+    quentes.resize(k);
+    std::sort(quentes.begin(), quentes.end(), maisQuente);
+    return quentes;
+}
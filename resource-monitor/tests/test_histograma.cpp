@@ -0,0 +1,117 @@
+// Teste do HistogramaLatencia (log-linear, estilo HDR): abaixo de 128 ns os percentis são exatos; acima,
+// ficam a no máximo meia faixa (1/128 < 0,8%) do percentil exato, em qualquer escala até 2^44 ns.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "histograma.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string &descricao) {
+    if (!condicao) {
+        std::cerr << "FALHA: " << descricao << "\n";
+        ++falhas;
+    }
+}
+
+static const double PERCENTIS[] = { 0, 1, 10, 25, 50, 75, 90, 99, 99.9, 100 };
+
+// Percentil exato com a mesma definição do histograma: nearest-rank, posição ceil(p/100 * n), 1-based
+static uint64_t percentilExato(const std::vector<uint64_t> &ordenados, double p) {
+    uint64_t posicao = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(ordenados.size())));
+    posicao = std::max<uint64_t>(posicao, 1);
+    return ordenados[posicao - 1];
+}
+
+static void conferirErro(const std::string &nome, std::vector<uint64_t> valores) {
+    HistogramaLatencia histograma;
+    for (uint64_t v : valores) histograma.registrar(v);
+    std::sort(valores.begin(), valores.end());
+
+    verificar(histograma.contagem() == valores.size(), nome + ": contagem");
+    verificar(histograma.minimo() == valores.front() && histograma.maximo() == valores.back(), nome + ": extremos exatos");
+    for (double p : PERCENTIS) {
+        uint64_t exato = percentilExato(valores, p);
+        uint64_t estimado = histograma.percentil(p);
+        double diferenca = std::fabs(static_cast<double>(estimado) - static_cast<double>(exato));
+        verificar(diferenca <= static_cast<double>(exato) / 128.0,
+                  nome + ": p" + std::to_string(p) + " estimado " + std::to_string(estimado) + ", exato " + std::to_string(exato));
+    }
+}
+
+int main() {
+    std::mt19937_64 gerador(20240607); // semente fixa: o teste é determinístico
+
+    // Faixa linear: um contador por valor, percentis exatos
+    {
+        std::vector<uint64_t> valores;
+        for (uint64_t v = 0; v < 128; ++v)
+            for (uint64_t k = 0; k <= v % 5; ++k) valores.push_back(v);
+        HistogramaLatencia histograma;
+        for (uint64_t v : valores) histograma.registrar(v);
+        for (double p : PERCENTIS)
+            verificar(histograma.percentil(p) == percentilExato(valores, p), "linear: p" + std::to_string(p) + " não é exato");
+    }
+
+    // Bordas das potências de 2 e das faixas (2^e - 1, 2^e, 2^e + 1) em todas as escalas até 2^44
+    {
+        std::vector<uint64_t> valores;
+        for (uint32_t e = 7; e < 44; ++e)
+            for (uint64_t v : { (1ULL << e) - 1, 1ULL << e, (1ULL << e) + 1, (1ULL << e) + (1ULL << (e - 6)) })
+                valores.push_back(v);
+        conferirErro("bordas", valores);
+        for (uint64_t v : valores) conferirErro("valor isolado " + std::to_string(v), { v, v, v });
+    }
+
+    // Uniforme de 1 µs a 1 s
+    {
+        std::uniform_int_distribution<uint64_t> uniforme(1000, 1000000000);
+        std::vector<uint64_t> valores;
+        for (int i = 0; i < 200000; ++i) valores.push_back(uniforme(gerador));
+        conferirErro("uniforme", valores);
+    }
+
+    // Log-normal (coleta típica de ~20 µs com cauda até dezenas de ms)
+    {
+        std::lognormal_distribution<double> lognormal(std::log(20000.0), 1.5);
+        std::vector<uint64_t> valores;
+        for (int i = 0; i < 200000; ++i) valores.push_back(static_cast<uint64_t>(lognormal(gerador)));
+        conferirErro("log-normal", valores);
+    }
+
+    // Mescla: dois histogramas somados respondem como o do conjunto inteiro
+    {
+        std::exponential_distribution<double> exponencial(1.0 / 300000.0);
+        HistogramaLatencia inteiro, metadeA, metadeB;
+        for (int i = 0; i < 100000; ++i) {
+            uint64_t v = static_cast<uint64_t>(exponencial(gerador));
+            inteiro.registrar(v);
+            (i % 2 ? metadeA : metadeB).registrar(v);
+        }
+        metadeA.mesclar(metadeB);
+        verificar(metadeA.contagem() == inteiro.contagem() && metadeA.minimo() == inteiro.minimo() &&
+                  metadeA.maximo() == inteiro.maximo() && metadeA.media() == inteiro.media(), "mescla: contagem, extremos e média");
+        for (double p : PERCENTIS)
+            verificar(metadeA.percentil(p) == inteiro.percentil(p), "mescla: p" + std::to_string(p) + " diferente");
+    }
+
+    // Vazio e acima do limite (última faixa, limitado ao máximo exato)
+    {
+        HistogramaLatencia histograma;
+        verificar(histograma.percentil(50) == 0 && histograma.minimo() == 0 && histograma.maximo() == 0, "histograma vazio");
+        histograma.registrar(1ULL << 50);
+        verificar(histograma.percentil(50) == 1ULL << 50, "valor acima de 2^44 volta o máximo exato");
+    }
+
+    if (falhas) {
+        std::cerr << "test_histograma: " << falhas << " falha(s)\n";
+        return 1;
+    }
+    std::cout << "test_histograma: ok\n";
+    return 0;
+}
@@ -0,0 +1,132 @@
+// Teste do histórico em memória: com um anel bruto pequeno, confere qual nível responde a cada janela e
+// os valores agregados das janelas de 10 s e 1 min (mínimo, máximo, média, contagem e percentil ponderado).
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "historico.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string &descricao) {
+    if (!condicao) {
+        std::cerr << "FALHA: " << descricao << "\n";
+        ++falhas;
+    }
+}
+
+static bool perto(double a, double b) {
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+// Uma amostra com a CPU e o RSS iguais a 'valor'
+static void adicionar(SerieHistorico &serie, int64_t instanteMs, double valor) {
+    StatusProcesso medicao{};
+    calculoMedicao calculado{};
+    calculado.usoCPU = valor;
+    medicao.vmRss = static_cast<unsigned long>(valor);
+    serie.adicionar(instanteMs, medicao, calculado);
+}
+
+static void conferir(const std::string &nome, const ConsultaHistorico &r, NivelHistorico nivel, uint64_t amostras,
+                     double minimo, double maximo, double media, double percentil) {
+    verificar(r.nivel == nivel, nome + ": nível " + nomeNivelHistorico(r.nivel) + ", esperado " + nomeNivelHistorico(nivel));
+    verificar(r.amostras == amostras, nome + ": " + std::to_string(r.amostras) + " amostras, esperado " + std::to_string(amostras));
+    verificar(perto(r.minimo, minimo), nome + ": mínimo " + std::to_string(r.minimo));
+    verificar(perto(r.maximo, maximo), nome + ": máximo " + std::to_string(r.maximo));
+    verificar(perto(r.media, media), nome + ": média " + std::to_string(r.media));
+    verificar(perto(r.percentil, percentil), nome + ": percentil " + std::to_string(r.percentil));
+    verificar(r.percentilAproximado == (nivel != NivelHistorico::Bruto), nome + ": percentil aproximado só nos níveis agregados");
+}
+
+int main() {
+    ConsultaHistorico r{};
+
+    {
+        // Série vazia não responde
+        SerieHistorico serie(10);
+        verificar(!serie.consultar(MetricaHistorico::CPU, 1000, 50, r), "série vazia");
+    }
+
+    {
+        // 100 amostras a 1 Hz (valor = segundo) com anel bruto de 10: só os últimos 10 s ficam no bruto
+        SerieHistorico serie(10);
+        for (int s = 0; s < 100; ++s) adicionar(serie, s * 1000LL, s);
+
+        // Janela dentro do anel: exata, amostras 94..99 (o início da janela é inclusivo); p50 nearest-rank = 3ª
+        verificar(serie.consultar(MetricaHistorico::CPU, 5000, 50, r), "consulta de 5 s");
+        conferir("bruto 5 s", r, NivelHistorico::Bruto, 6, 94, 99, 96.5, 96);
+        verificar(r.inicioMs == 94000 && r.fimMs == 99000, "bruto 5 s: início e fim da janela");
+
+        // 30 s não cabem no anel: janelas de 10 s [60,70) .. [90,100), arredondadas para fora
+        verificar(serie.consultar(MetricaHistorico::CPU, 30000, 50, r), "consulta de 30 s");
+        conferir("10 s", r, NivelHistorico::Agregado10s, 40, 60, 99, 79.5, 74.5);
+        verificar(r.inicioMs == 60000, "10 s: janela começa no passo");
+        verificar(serie.consultar(MetricaHistorico::CPU, 30000, 100, r), "consulta de 30 s, p100");
+        verificar(perto(r.percentil, 94.5), "10 s: p100 é a média da última janela");
+
+        // A mesma janela vista por outra métrica (RSS) agrega os mesmos valores
+        verificar(serie.consultar(MetricaHistorico::RSS, 30000, 50, r), "consulta de RSS");
+        conferir("10 s (RSS)", r, NivelHistorico::Agregado10s, 40, 60, 99, 79.5, 74.5);
+
+        // Janela maior que a retenção de 10 s: nível de 1 min, [0,60) com média 29,5 e [60,120) com 79,5
+        verificar(serie.consultar(MetricaHistorico::CPU, SerieHistorico::RETENCAO_10S_MS + 1, 50, r), "consulta de 6 h + 1 ms");
+        conferir("1 min", r, NivelHistorico::Agregado1min, 100, 0, 99, 49.5, 29.5);
+        verificar(r.inicioMs == 0, "1 min: janela começa no passo");
+    }
+
+    {
+        // Instantes negativos caem na janela que os contém (arredondamento para baixo), e um relógio que volta
+        // soma na janela atual em vez de abrir uma janela no passado
+        SerieHistorico serie(2);
+        adicionar(serie, -15000, 1); // janela 10 s [-20000, -10000)
+        adicionar(serie, -1, 2);     // [-10000, 0)
+        adicionar(serie, 5000, 3);   // [0, 10000)
+        adicionar(serie, 2000, 4);   // relógio voltou: ainda [0, 10000)
+        adicionar(serie, 9999, 5);   // [0, 10000)
+        verificar(serie.consultar(MetricaHistorico::CPU, 20000, 50, r), "consulta com instantes negativos");
+        // fim = 9999, início da janela = -10001: entram [-20000,-10000) (termina depois de -10001) e as seguintes
+        conferir("instantes negativos", r, NivelHistorico::Agregado10s, 5, 1, 5, 3, 4); // p50 ponderado: médias 1, 2 e 4 (x3)
+        verificar(r.inicioMs == -20000, "instantes negativos: primeira janela em -20000");
+    }
+
+    {
+        // O anel de 10 s retém 6 h: uma janela além disso é sobrescrita e some da consulta
+        SerieHistorico serie(1);
+        const int64_t janelas = SerieHistorico::RETENCAO_10S_MS / SerieHistorico::PASSO_10S_MS;
+        for (int64_t j = 0; j <= janelas; ++j) adicionar(serie, j * SerieHistorico::PASSO_10S_MS, j == 0 ? 1000 : 1);
+        verificar(serie.consultar(MetricaHistorico::CPU, SerieHistorico::RETENCAO_10S_MS, 50, r), "consulta de 6 h");
+        verificar(r.nivel == NivelHistorico::Agregado10s, "6 h: nível de 10 s");
+        verificar(r.amostras == static_cast<uint64_t>(janelas), "6 h: " + std::to_string(r.amostras) + " janelas retidas");
+        verificar(perto(r.maximo, 1), "6 h: a janela mais antiga (valor 1000) foi sobrescrita");
+    }
+
+    {
+        // Séries reaproveitadas: o mesmo processo continua a série; sem posição livre, a menos recente é limpa
+        HistoricoMetricas historico(2, 10);
+        SerieHistorico *a = historico.reservar(100, 1);
+        SerieHistorico *b = historico.reservar(200, 1);
+        verificar(a && b && a != b, "duas séries reservadas");
+        verificar(historico.reservar(300, 1) == nullptr, "todas as séries em uso");
+        adicionar(*a, 1000, 10);
+        adicionar(*b, 2000, 20);
+        historico.liberar(a);
+        historico.liberar(b);
+
+        verificar(historico.reservar(100, 1) == a, "mesmo PID e starttime continuam a série");
+        verificar(historico.consultar(100, MetricaHistorico::CPU, 1000, 50, r) && perto(r.maximo, 10), "dados mantidos ao continuar");
+        SerieHistorico *c = historico.reservar(300, 1);
+        verificar(c == b, "sem posição livre, a série menos recente fora de uso é reaproveitada");
+        verificar(!historico.consultar(200, MetricaHistorico::CPU, 1000, 50, r), "PID anterior perde o histórico");
+        verificar(!historico.consultar(300, MetricaHistorico::CPU, 1000, 50, r), "série reaproveitada começa vazia");
+    }
+
+    if (falhas) {
+        std::cerr << "test_historico: " << falhas << " falha(s)\n";
+        return 1;
+    }
+    std::cout << "test_historico: ok\n";
+    return 0;
+}
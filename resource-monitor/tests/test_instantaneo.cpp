@@ -0,0 +1,138 @@
+// Teste da tabela compartilhada (POSIX shm): o LeitorInstantaneo recusa um slot com sequência ímpar, com o
+// escritor vivo (publicação que não termina) e com o escritor morto no meio da publicação, e nunca aceita
+// uma cópia rasgada enquanto outra thread publica sem parar.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "instantaneo.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string &descricao) {
+    if (!condicao) {
+        std::cerr << "FALHA: " << descricao << "\n";
+        ++falhas;
+    }
+}
+
+// Amostra em que todos os campos conferidos valem 'k': uma cópia rasgada mistura valores
+static void publicar(InstantaneoCompartilhado &tabela, int slot, unsigned long k) {
+    StatusProcesso medicao{};
+    calculoMedicao calculado{};
+    medicao.PID = 1234;
+    medicao.vmSize = medicao.vmRss = medicao.minfault = medicao.bytesLidos = medicao.wchar = k;
+    calculado.usoCPU = static_cast<double>(k);
+    tabela.publicar(slot, medicao, calculado);
+}
+
+static bool consistente(const AmostraInstantaneo &a) {
+    const RegistroAnel &r = a.registro;
+    return r.vmSize == r.vmRss && r.vmRss == r.minfault && r.minfault == r.bytesLidos && r.bytesLidos == r.wchar &&
+           r.usoCPU == static_cast<double>(r.vmSize) && a.amostras == r.numero + 1;
+}
+
+// Mapeia o segmento para escrita, como um escritor que parou no meio de publicar(), e soma 'delta' à sequência
+static bool mexerNaSequencia(const std::string &nome, uint32_t slot, uint32_t delta) {
+    int fd = shm_open(nome.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) return false;
+    size_t tamanho = sizeof(CabecalhoInstantaneo) + sizeof(SlotInstantaneo) * (slot + 1);
+    void *p = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    SlotInstantaneo *slots = reinterpret_cast<SlotInstantaneo*>(static_cast<char*>(p) + sizeof(CabecalhoInstantaneo));
+    slots[slot].sequencia.fetch_add(delta, std::memory_order_release);
+    munmap(p, tamanho);
+    return true;
+}
+
+int main() {
+    const std::string nome = "/rm-teste-" + std::to_string(getpid());
+    const std::string nomeMorto = nome + "-morto";
+
+    {
+        InstantaneoCompartilhado tabela(nome, 4);
+        verificar(tabela.valido(), "criar o segmento");
+        int slot = tabela.reservar(1234, 99);
+        verificar(slot == 0, "reservar o primeiro slot");
+
+        LeitorInstantaneo leitor;
+        verificar(leitor.abrir(nome), "abrir o segmento para leitura");
+        verificar(leitor.escritorAtivo(), "escritor ativo enquanto a tabela existe");
+        AmostraInstantaneo amostra{};
+        verificar(!leitor.ler(0, amostra), "slot reservado sem amostra é recusado");
+        verificar(!leitor.ler(1, amostra), "slot livre é recusado");
+        verificar(!leitor.ler(4, amostra), "slot fora da tabela é recusado");
+
+        publicar(tabela, slot, 7);
+        verificar(leitor.ler(0, amostra), "ler o slot publicado");
+        verificar(amostra.pid == 1234 && amostra.starttime == 99 && amostra.amostras == 1 && consistente(amostra) &&
+                  amostra.registro.vmSize == 7, "conteúdo do slot publicado");
+
+        // Sequência ímpar com o escritor vivo: a leitura desiste depois das tentativas, sem devolver a cópia
+        verificar(mexerNaSequencia(nome, 0, 1), "deixar a sequência ímpar");
+        amostra = AmostraInstantaneo{};
+        verificar(!leitor.ler(0, amostra), "sequência ímpar (escritor vivo) é recusada");
+        verificar(amostra.pid == 0, "saída intocada quando a leitura é recusada");
+        verificar(!leitor.lerPID(1234, amostra), "lerPID também recusa o slot ímpar");
+
+        // A publicação "termina": a sequência volta a ser par e o slot é lido de novo
+        verificar(mexerNaSequencia(nome, 0, 1), "voltar a sequência a par");
+        verificar(leitor.ler(0, amostra) && amostra.registro.vmSize == 7, "slot lido depois que a sequência volta a par");
+
+        // Cópias rasgadas: uma thread publica sem parar e a leitura só pode devolver amostras inteiras
+        std::atomic<bool> rodando{true};
+        std::thread escritor([&] {
+            for (unsigned long k = 8; rodando.load(std::memory_order_relaxed); ++k) publicar(tabela, slot, k);
+        });
+        uint64_t lidas = 0, inconsistentes = 0;
+        auto fim = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        while (std::chrono::steady_clock::now() < fim) {
+            if (!leitor.ler(0, amostra)) continue;
+            ++lidas;
+            if (!consistente(amostra)) ++inconsistentes;
+        }
+        rodando = false;
+        escritor.join();
+        verificar(lidas > 0, "leituras concorrentes com o escritor");
+        verificar(inconsistentes == 0, std::to_string(inconsistentes) + " de " + std::to_string(lidas) + " leituras rasgadas");
+    }
+
+    // Escritor morto no meio da publicação: um filho publica, deixa a sequência ímpar e sai sem remover o
+    // segmento. O flock some com ele, então a leitura desiste logo em vez de esperar todas as tentativas
+    pid_t filho = fork();
+    if (filho == 0) {
+        InstantaneoCompartilhado *tabela = new InstantaneoCompartilhado(nomeMorto, 2); // sem destrutor: o segmento fica
+        int slot = tabela->reservar(4321, 1);
+        publicar(*tabela, slot, 3);
+        _exit(slot == 0 && mexerNaSequencia(nomeMorto, 0, 1) ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(filho, &status, 0);
+    verificar(WIFEXITED(status) && WEXITSTATUS(status) == 0, "filho publicou e deixou a sequência ímpar");
+    {
+        LeitorInstantaneo leitor;
+        verificar(leitor.abrir(nomeMorto), "abrir o segmento do escritor morto");
+        verificar(!leitor.escritorAtivo(), "escritor morto não segura o flock");
+        AmostraInstantaneo amostra{};
+        verificar(!leitor.ler(0, amostra), "sequência ímpar (escritor morto) é recusada");
+        std::vector<AmostraInstantaneo> todas;
+        verificar(leitor.lerTodos(todas) == 0, "lerTodos ignora o slot ímpar");
+    }
+    shm_unlink(nomeMorto.c_str());
+
+    if (falhas) {
+        std::cerr << "test_instantaneo: " << falhas << " falha(s)\n";
+        return 1;
+    }
+    std::cout << "test_instantaneo: ok\n";
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Teste da série binária (.rmts): grava amostras com valores de borda e confere que a leitura devolve
+// exatamente o que foi gravado (instantes iguais, para trás e extremos, contadores que voltam a zero,
+// taxas negativas, NaN e infinitos).
+
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "serie.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string &descricao) {
+    if (!condicao) {
+        std::cerr << "FALHA: " << descricao << "\n";
+        ++falhas;
+    }
+}
+
+// Doubles comparados bit a bit: NaN com payload e -0.0 também precisam voltar iguais
+static bool mesmosBits(double a, double b) {
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+}
+
+static AmostraSerie amostra(int64_t instanteMs, unsigned long contador, unsigned int pequeno, double tempo, double taxa) {
+    AmostraSerie a{};
+    a.instanteMs = instanteMs;
+    a.medicao.PID = 4242;
+    a.medicao.threads = pequeno;
+    a.medicao.contextSwitchfree = pequeno;
+    a.medicao.contextSwitchforced = UINT_MAX - pequeno;
+    a.medicao.vmSize = contador;
+    a.medicao.vmRss = ULONG_MAX - contador;
+    a.medicao.vmSwap = 0;
+    a.medicao.minfault = contador;
+    a.medicao.mjrfault = contador / 3;
+    a.medicao.bytesLidos = contador;
+    a.medicao.bytesEscritos = ULONG_MAX;
+    a.medicao.syscallLeitura = contador ^ 0x5555;
+    a.medicao.syscallEscrita = 1;
+    a.medicao.rchar = contador;
+    a.medicao.wchar = ULONG_MAX - contador;
+    a.medicao.bytesRxfila = contador;
+    a.medicao.bytesTxfila = 0;
+    a.medicao.conexoesAtivas = pequeno;
+    a.medicao.utime = tempo;
+    a.medicao.stime = tempo * 2;
+    a.medicao.tempoCPU = tempo;
+    a.medicao.esperaCPU = 0;
+    a.calculado.usoCPU = taxa;
+    a.calculado.usoCPUGlobal = -taxa;
+    a.calculado.taxaLeituraDisco = 0;
+    a.calculado.taxaLeituraTotal = taxa;
+    a.calculado.taxaEscritaDisco = -0.0;
+    a.calculado.taxaEscritaTotal = taxa * 2;
+    return a;
+}
+
+static bool iguais(const AmostraSerie &a, const AmostraSerie &b) {
+    const StatusProcesso &x = a.medicao, &y = b.medicao;
+    return a.instanteMs == b.instanteMs && x.PID == y.PID &&
+        x.threads == y.threads && x.contextSwitchfree == y.contextSwitchfree && x.contextSwitchforced == y.contextSwitchforced &&
+        x.vmSize == y.vmSize && x.vmRss == y.vmRss && x.vmSwap == y.vmSwap && x.minfault == y.minfault && x.mjrfault == y.mjrfault &&
+        x.bytesLidos == y.bytesLidos && x.bytesEscritos == y.bytesEscritos &&
+        x.syscallLeitura == y.syscallLeitura && x.syscallEscrita == y.syscallEscrita && x.rchar == y.rchar && x.wchar == y.wchar &&
+        x.bytesRxfila == y.bytesRxfila && x.bytesTxfila == y.bytesTxfila && x.conexoesAtivas == y.conexoesAtivas &&
+        mesmosBits(x.utime, y.utime) && mesmosBits(x.stime, y.stime) &&
+        mesmosBits(x.tempoCPU, y.tempoCPU) && mesmosBits(x.esperaCPU, y.esperaCPU) &&
+        mesmosBits(a.calculado.usoCPU, b.calculado.usoCPU) && mesmosBits(a.calculado.usoCPUGlobal, b.calculado.usoCPUGlobal) &&
+        mesmosBits(a.calculado.taxaLeituraDisco, b.calculado.taxaLeituraDisco) &&
+        mesmosBits(a.calculado.taxaLeituraTotal, b.calculado.taxaLeituraTotal) &&
+        mesmosBits(a.calculado.taxaEscritaDisco, b.calculado.taxaEscritaDisco) &&
+        mesmosBits(a.calculado.taxaEscritaTotal, b.calculado.taxaEscritaTotal);
+}
+
+// Grava as amostras em blocos de 'porBloco', relê o arquivo inteiro e compara amostra por amostra
+static void idaEVolta(const std::string &nome, const std::vector<AmostraSerie> &amostras, uint32_t porBloco) {
+    const std::string caminho = (std::filesystem::temp_directory_path() / ("test_serie_" + std::to_string(getpid()) + ".rmts")).string();
+    std::filesystem::remove(caminho);
+    {
+        EscritorSerie escritor(caminho, porBloco);
+        verificar(escritor.valido(), nome + ": abrir o escritor");
+        for (const AmostraSerie &a : amostras)
+            verificar(escritor.adicionar(a.instanteMs, a.medicao, a.calculado), nome + ": adicionar amostra");
+        verificar(escritor.fechar(), nome + ": fechar o escritor");
+    }
+
+    LeitorSerie leitor;
+    verificar(leitor.abrir(caminho), nome + ": abrir o leitor");
+    verificar(!leitor.indiceReconstruido(), nome + ": índice gravado no fechamento");
+    verificar(leitor.totalAmostras() == amostras.size(), nome + ": total de amostras no índice");
+
+    std::vector<AmostraSerie> lidas, bloco;
+    for (size_t i = 0; i < leitor.blocos().size(); ++i) {
+        verificar(leitor.lerBloco(i, bloco), nome + ": decodificar o bloco " + std::to_string(i));
+        lidas.insert(lidas.end(), bloco.begin(), bloco.end());
+    }
+    verificar(lidas.size() == amostras.size(), nome + ": quantidade de amostras decodificadas");
+    for (size_t i = 0; i < lidas.size() && i < amostras.size(); ++i)
+        verificar(iguais(lidas[i], amostras[i]), nome + ": amostra " + std::to_string(i) + " diferente da gravada");
+
+    leitor.fechar();
+    std::filesystem::remove(caminho);
+}
+
+int main() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double nanComPayload = std::bit_cast<double>(uint64_t{0xfff8000000abcdefull}); // -NaN com payload
+    const double infinito = std::numeric_limits<double>::infinity();
+    const int64_t minimo = std::numeric_limits<int64_t>::min();
+    const int64_t maximo = std::numeric_limits<int64_t>::max();
+
+    // Zeros em todas as colunas, inclusive o instante
+    idaEVolta("zeros", { amostra(0, 0, 0, 0.0, 0.0), amostra(0, 0, 0, 0.0, 0.0), amostra(0, 0, 0, 0.0, 0.0) }, 256);
+
+    // Uma única amostra (bloco sem deltas)
+    idaEVolta("amostra única", { amostra(1700000000000, 12345, 7, 1.23, 42.5) }, 256);
+
+    // Instantes iguais, para trás, negativos (antes de 1970) e nos extremos do int64_t no mesmo bloco;
+    // contadores que sobem até o máximo e voltam a zero; tempos de ticks (1/100 s) e de ns; taxas de borda
+    std::vector<AmostraSerie> borda = {
+        amostra(1700000000000, 0, 0, 0.0, 0.0),
+        amostra(1700000000000, ULONG_MAX, UINT_MAX, 0.01, -0.0),
+        amostra(1700000000000, 0, 0, 12345.67, -123.5),
+        amostra(1699999999000, 1, 1, 0.000000001, nan),
+        amostra(-86400000, ULONG_MAX / 2, 3, 1000000.0, nanComPayload),
+        amostra(maximo, 2, UINT_MAX, 3.14, infinito),
+        amostra(minimo, ULONG_MAX, 0, 0.0, -infinito),
+        amostra(maximo, 0, 5, 98765.43, std::numeric_limits<double>::denorm_min()),
+        amostra(0, 7, 5, 98765.43, std::numeric_limits<double>::max()),
+        amostra(0, 7, 5, 98765.43, std::numeric_limits<double>::max()),
+    };
+    idaEVolta("valores de borda, um bloco", borda, 256);
+    idaEVolta("valores de borda, blocos de 3", borda, 3); // cada bloco recomeça os deltas do zero
+
+    // Série longa e regular (caso comum a 1 Hz) atravessando vários blocos
+    std::vector<AmostraSerie> regular;
+    for (int i = 0; i < 1000; ++i)
+        regular.push_back(amostra(1700000000000 + 1000LL * i + (i % 7 == 0 ? 3 : 0), 4096UL * static_cast<unsigned long>(i),
+                                  static_cast<unsigned int>(i % 13), i / 100.0, i % 5 ? 12.5 : 0.0));
+    idaEVolta("série regular", regular, 256);
+
+    if (falhas) {
+        std::cerr << "test_serie: " << falhas << " falha(s)\n";
+        return 1;
+    }
+    std::cout << "test_serie: ok\n";
+    return 0;
+}
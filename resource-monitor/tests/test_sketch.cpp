@@ -0,0 +1,127 @@
+// Teste do SketchQuantis (DDSketch): em distribuições conhecidas, cada quantil estimado fica a no máximo
+// ALFA (1%) do quantil exato, relativo; a mescla e a serialização não mudam as estimativas.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "sketch.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string &descricao) {
+    if (!condicao) {
+        std::cerr << "FALHA: " << descricao << "\n";
+        ++falhas;
+    }
+}
+
+static const double QUANTIS[] = { 0.0, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0 };
+
+// Quantil exato com a mesma definição de posição do sketch: floor(q * (n - 1)), 0-based
+static double quantilExato(const std::vector<double> &ordenados, double q) {
+    size_t posicao = static_cast<size_t>(q * static_cast<double>(ordenados.size() - 1));
+    return ordenados[posicao];
+}
+
+static void conferirErro(const std::string &nome, std::vector<double> valores) {
+    SketchQuantis sketch;
+    for (double v : valores) sketch.adicionar(v);
+    std::sort(valores.begin(), valores.end());
+
+    verificar(sketch.contagem() == valores.size(), nome + ": contagem");
+    verificar(sketch.minimo() == valores.front() && sketch.maximo() == valores.back(), nome + ": extremos exatos");
+    for (double q : QUANTIS) {
+        double exato = quantilExato(valores, q);
+        double estimado = sketch.quantil(q);
+        double erro = std::fabs(estimado - exato) / exato;
+        verificar(erro <= SketchQuantis::ALFA * (1 + 1e-9),
+                  nome + ": q" + std::to_string(q) + " estimado " + std::to_string(estimado) + ", exato " +
+                  std::to_string(exato) + " (erro relativo " + std::to_string(erro) + ")");
+    }
+}
+
+int main() {
+    std::mt19937_64 gerador(20240607); // semente fixa: o teste é determinístico
+
+    // Uniforme em inteiros 2..1e6 (todos os buckets de uma faixa larga)
+    {
+        std::vector<double> valores;
+        for (int i = 2; i <= 1000000; i += 7) valores.push_back(i);
+        conferirErro("uniforme", valores);
+    }
+
+    // Exponencial com média de 50 µs em ns (latências típicas do Experimento 5)
+    {
+        std::exponential_distribution<double> exponencial(1.0 / 50000.0);
+        std::vector<double> valores;
+        for (int i = 0; i < 200000; ++i) valores.push_back(2 + exponencial(gerador));
+        conferirErro("exponencial", valores);
+    }
+
+    // Log-normal com cauda longa: ~1 µs a vários segundos em ns
+    {
+        std::lognormal_distribution<double> lognormal(std::log(200000.0), 2.0);
+        std::vector<double> valores;
+        for (int i = 0; i < 200000; ++i) valores.push_back(std::max(2.0, lognormal(gerador)));
+        conferirErro("log-normal", valores);
+    }
+
+    // Bimodal (acertos de cache x acessos ao disco): o p50 e o p99 caem em modos distintos
+    {
+        std::normal_distribution<double> rapido(2000, 200), lento(8000000, 500000);
+        std::vector<double> valores;
+        for (int i = 0; i < 100000; ++i) valores.push_back(std::max(2.0, i % 50 == 0 ? lento(gerador) : rapido(gerador)));
+        conferirErro("bimodal", valores);
+    }
+
+    // Valor constante: todos os quantis são o próprio valor
+    conferirErro("constante", std::vector<double>(1000, 123456.0));
+
+    // Mescla: os sketches de duas metades somados estimam como o sketch do conjunto inteiro;
+    // a serialização (pipe do Experimento 5) devolve o mesmo sketch
+    {
+        std::lognormal_distribution<double> lognormal(std::log(50000.0), 1.5);
+        SketchQuantis inteiro, metadeA, metadeB;
+        for (int i = 0; i < 50000; ++i) {
+            double v = std::max(2.0, lognormal(gerador));
+            inteiro.adicionar(v);
+            (i % 2 ? metadeA : metadeB).adicionar(v);
+        }
+        metadeA.mesclar(metadeB);
+        verificar(metadeA.contagem() == inteiro.contagem(), "mescla: contagem");
+        for (double q : QUANTIS)
+            verificar(metadeA.quantil(q) == inteiro.quantil(q), "mescla: q" + std::to_string(q) + " diferente");
+
+        std::vector<uint8_t> bytes(SketchQuantis::TAMANHO_MAXIMO_SERIALIZADO);
+        size_t usados = inteiro.serializar(bytes.data(), bytes.size());
+        verificar(usados > 0, "serialização cabe em TAMANHO_MAXIMO_SERIALIZADO");
+        SketchQuantis lido;
+        verificar(lido.desserializar(bytes.data(), usados), "desserialização");
+        verificar(lido.contagem() == inteiro.contagem() && lido.minimo() == inteiro.minimo() &&
+                  lido.maximo() == inteiro.maximo(), "desserialização: contagem e extremos");
+        for (double q : QUANTIS)
+            verificar(lido.quantil(q) == inteiro.quantil(q), "desserialização: q" + std::to_string(q) + " diferente");
+
+        verificar(!lido.desserializar(bytes.data(), usados - 1), "mensagem truncada é recusada");
+        bytes[0] ^= 1; // contagem do cabeçalho não bate com a soma dos buckets
+        verificar(!lido.desserializar(bytes.data(), usados), "contagem corrompida é recusada");
+        verificar(lido.contagem() == 0, "sketch fica vazio depois de recusar");
+    }
+
+    // Sketch vazio
+    {
+        SketchQuantis vazio;
+        verificar(vazio.quantil(0.5) == 0 && vazio.minimo() == 0 && vazio.maximo() == 0, "sketch vazio");
+    }
+
+    if (falhas) {
+        std::cerr << "test_sketch: " << falhas << " falha(s)\n";
+        return 1;
+    }
+    std::cout << "test_sketch: ok\n";
+    return 0;
+}
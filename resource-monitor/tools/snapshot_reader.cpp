@@ -0,0 +1,84 @@
+// Leitor de linha de comando da tabela compartilhada do monitor (POSIX shm, ver include/instantaneo.h).
+// Mostra a amostra mais recente de cada PID monitorado sem tocar em /proc: cada leitura é uma cópia do
+// mapeamento validada pelo seqlock do slot.
+//
+// Uso: snapshot_reader [-s segmento] [-p pid] [-i intervalo_s] [-n repeticoes]
+//   -s  nome do segmento (padrão /resource-monitor)
+//   -p  mostra só este PID
+//   -i  relê a cada intervalo (segundos); sem -i, lê uma vez
+//   -n  número de leituras com -i (padrão: até o monitor encerrar)
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <unistd.h>
+#include "instantaneo.h"
+
+static int64_t agoraMs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void imprimir(const LeitorInstantaneo &leitor, int pid) {
+    std::vector<AmostraInstantaneo> amostras;
+    if (pid > 0) {
+        AmostraInstantaneo a;
+        if (leitor.lerPID(pid, a)) amostras.push_back(a);
+    }
+    else {
+        leitor.lerTodos(amostras);
+    }
+
+    int64_t agora = agoraMs();
+    printf("\nMonitor PID %d (%s) | %zu PIDs de %u slots\n", leitor.pidEscritor(),
+        leitor.escritorAtivo() ? "publicando" : "encerrado", amostras.size(), leitor.maxProcessos());
+    printf("| %-8s | %-9s | %-9s | %-8s | %-12s | %-13s | %-13s | %-7s | %-8s |\n",
+        "PID", "Amostras", "Idade ms", "CPU %", "RSS (kB)", "Leitura KiB/s", "Escrita KiB/s", "Threads", "Conexões");
+    printf("-------------------------------------------------------------------------------------------------------------\n");
+    for (const AmostraInstantaneo &a : amostras) {
+        const RegistroAnel &r = a.registro;
+        printf("| %-8d | %-9lu | %-9lld | %-8.2f | %-12lu | %-13.1f | %-13.1f | %-7u | %-8u |\n", a.pid,
+            static_cast<unsigned long>(a.amostras), static_cast<long long>(agora - r.instanteMs), r.usoCPU,
+            static_cast<unsigned long>(r.vmRss), r.taxaLeituraTotal, r.taxaEscritaTotal, r.threads, r.conexoesAtivas);
+    }
+    if (pid > 0 && amostras.empty()) printf("PID %d não está na tabela.\n", pid);
+}
+
+int main(int argc, char **argv) {
+    std::string segmento = NOME_INSTANTANEO;
+    int pid = 0;
+    double intervalo = 0;
+    long repeticoes = 0;
+    for (int opcao; (opcao = getopt(argc, argv, "s:p:i:n:h")) != -1;) {
+        switch (opcao) {
+        case 's': segmento = optarg; break;
+        case 'p': pid = std::atoi(optarg); break;
+        case 'i': intervalo = std::atof(optarg); break;
+        case 'n': repeticoes = std::atol(optarg); break;
+        default:
+            fprintf(stderr, "Uso: %s [-s segmento] [-p pid] [-i intervalo_s] [-n repeticoes]\n", argv[0]);
+            return opcao == 'h' ? 0 : 2;
+        }
+    }
+
+    LeitorInstantaneo leitor;
+    if (!leitor.abrir(segmento)) return 1;
+    imprimir(leitor, pid);
+    if (intervalo <= 0) return 0;
+
+    auto proxima = std::chrono::steady_clock::now();
+    for (long n = 1; repeticoes <= 0 || n < repeticoes; ++n) {
+        if (!leitor.escritorAtivo()) {
+            // O monitor encerrou (ou reiniciou, com um segmento novo): tenta o segmento atual
+            if (!leitor.abrir(segmento)) return 1;
+        }
+        proxima += std::chrono::microseconds(static_cast<int64_t>(intervalo * 1e6));
+        std::this_thread::sleep_until(proxima);
+        imprimir(leitor, pid);
+    }
+    return 0;
+}